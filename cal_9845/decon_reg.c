@@ -1869,6 +1869,25 @@ int decon_reg_init(u32 id, struct decon_config *config)
 	return 0;
 }
 
+/*
+ * Register snapshot is not characterized for this version, always reinit.
+ * The DSC block layout and the per-decon SRAM setup differ from 9865, and
+ * there are no register stream goldens to check a snapshot list against
+ * what decon_reg_init() writes.
+ */
+int decon_reg_save(u32 id, struct decon_config *config, struct decon_reg_snapshot *snap)
+{
+	snap->cnt = 0;
+
+	return -EOPNOTSUPP;
+}
+
+int decon_reg_restore(u32 id, struct decon_config *config,
+		const struct decon_reg_snapshot *snap)
+{
+	return -EOPNOTSUPP;
+}
+
 int decon_reg_start(u32 id, struct decon_config *config)
 {
 	int ret = 0;
@@ -1943,6 +1962,30 @@ int decon_reg_stop(u32 id, struct decon_config *config, bool rst, u32 fps)
 	return ret;
 }
 
+void dsc_reg_set_clock_gating(u32 id, struct decon_config *config, bool en)
+{
+	u32 dsc_id, dsc_first, dsc_cnt, val, mask;
+
+	if (!config->dsc.enabled)
+		return;
+
+	val = en ? (DSC_DCG_EN_REF(1) | DSC_DCG_EN_SSM(1) | DSC_DCG_EN_ICH(1) |
+			DSC_DCG_EN(1)) : 0;
+	mask = DSC_DCG_EN_ALL_MASK | DSC_DCG_EN_MASK;
+
+	/* same encoder selection as dsc_reg_set_encoder() */
+	if (id == 1 || id == 2) {
+		dsc_first = (id == 1) ? DECON_DSC_ENC1 : DECON_DSC_ENC2;
+		dsc_cnt = 1;
+	} else {
+		dsc_first = DECON_DSC_ENC0;
+		dsc_cnt = config->dsc.dsc_count;
+	}
+
+	for (dsc_id = dsc_first; dsc_id < dsc_first + dsc_cnt; dsc_id++)
+		dsc_write_mask(id, DSC_CONTROL_0(dsc_id), val, mask);
+}
+
 void decon_reg_set_bpc_and_dither_path(u32 id, struct decon_config *config)
 {
 	/*
@@ -2052,6 +2095,17 @@ void decon_reg_set_trigger(u32 id, struct decon_mode *mode,
 	decon_write_mask(id, TRIG_CON, val, mask);
 }
 
+bool decon_reg_is_trigger_unmasked(u32 id, struct decon_mode *mode)
+{
+	if (mode->op_mode == DECON_VIDEO_MODE)
+		return true;
+
+	if (mode->trig_mode == DECON_SW_TRIG)
+		return decon_read_mask(id, TRIG_CON, SW_TRIG_EN) != 0;
+
+	return decon_read_mask(id, TRIG_CON, HW_TRIG_MASK_DECON) == 0;
+}
+
 void decon_reg_update_req_and_unmask(u32 id, struct decon_mode *mode)
 {
 	decon_reg_update_req_global(id);
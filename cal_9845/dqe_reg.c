@@ -80,7 +80,6 @@ void dqe_reg_init(u32 dqe_id, u32 width, u32 height)
 void dqe_reg_set_degamma_lut(u32 dqe_id, const struct drm_color_lut *lut)
 {
 	int i, ret = 0;
-	u16 tmp_lut[DEGAMMA_LUT_SIZE] = {0};
 	u32 regs[DQE_DEGAMMALUT_REG_CNT] = {0};
 
 	cal_log_debug(0, "%s +\n", __func__);
@@ -90,10 +89,7 @@ void dqe_reg_set_degamma_lut(u32 dqe_id, const struct drm_color_lut *lut)
 		return;
 	}
 
-	for (i = 0; i < DEGAMMA_LUT_SIZE; i++)
-		tmp_lut[i] = lut[i].red;
-
-	ret = cal_pack_lut_into_reg_pairs(tmp_lut, DEGAMMA_LUT_SIZE,
+	ret = cal_pack_color_lut_into_reg_pairs(lut, red, DEGAMMA_LUT_SIZE,
 		DEGAMMA_LUT_L_MASK, DEGAMMA_LUT_H_MASK, regs,
 		DQE_DEGAMMALUT_REG_CNT);
 	if(ret) {
@@ -140,7 +136,6 @@ void dqe_reg_set_regamma_lut(u32 dqe_id, u32 regamma_id, const struct drm_color_
 		REGAMMA_MAX = 3
 	};
 	int i, ret = 0;
-	u16 tmp_lut[REGAMMA_MAX][REGAMMA_LUT_SIZE] = {0};
 	u32 regs[REGAMMA_MAX][DQE_REGAMMALUT_REG_CNT] = {0};
 
 	cal_log_debug(0, "%s +\n", __func__);
@@ -150,20 +145,18 @@ void dqe_reg_set_regamma_lut(u32 dqe_id, u32 regamma_id, const struct drm_color_
 		return;
 	}
 
-	for (i = 0; i < REGAMMA_LUT_SIZE; i++) {
-		tmp_lut[REGAMMA_RED][i] = lut[i].red;
-		tmp_lut[REGAMMA_GREEN][i] = lut[i].green;
-		tmp_lut[REGAMMA_BLUE][i] = lut[i].blue;
-	}
-
-	for (i = 0; i < REGAMMA_MAX; i++) {
-		ret = cal_pack_lut_into_reg_pairs(tmp_lut[i], REGAMMA_LUT_SIZE,
-			REGAMMA_LUT_L_MASK, REGAMMA_LUT_H_MASK, regs[i],
-			DQE_REGAMMALUT_REG_CNT);
-		if(ret) {
-			cal_log_err(0, "Failed to pack regamma %d element\n", i);
-			return;
-		}
+	ret = cal_pack_color_lut_into_reg_pairs(lut, red, REGAMMA_LUT_SIZE,
+		REGAMMA_LUT_L_MASK, REGAMMA_LUT_H_MASK, regs[REGAMMA_RED],
+		DQE_REGAMMALUT_REG_CNT);
+	ret = ret ? : cal_pack_color_lut_into_reg_pairs(lut, green, REGAMMA_LUT_SIZE,
+		REGAMMA_LUT_L_MASK, REGAMMA_LUT_H_MASK, regs[REGAMMA_GREEN],
+		DQE_REGAMMALUT_REG_CNT);
+	ret = ret ? : cal_pack_color_lut_into_reg_pairs(lut, blue, REGAMMA_LUT_SIZE,
+		REGAMMA_LUT_L_MASK, REGAMMA_LUT_H_MASK, regs[REGAMMA_BLUE],
+		DQE_REGAMMALUT_REG_CNT);
+	if (ret) {
+		cal_log_err(0, "Failed to pack regamma lut\n");
+		return;
 	}
 
 	for (i = 0; i < DQE_REGAMMALUT_REG_CNT; i++) {
@@ -584,7 +577,7 @@ void dqe_reg_set_histogram(u32 dqe_id, enum exynos_histogram_id hist_id, enum hi
 	if (hist_id >= HISTOGRAM_MAX)
 		return;
 
-	if (regs_dqe[dqe_id].desc.write_protected) {
+	if (dqe_regs_desc(dqe_id)->write_protected) {
 		cal_log_debug(0, "%s: ignored in protected status\n", __func__);
 		return;
 	}
@@ -250,6 +250,22 @@ static void hdr_reg_print(u32 id, u32 start, u32 count, enum elem_size size,
 		cal_drm_printf(pr, id, "%s\n", buf);
 }
 
+void hdr_reg_enable_lut(u32 id, enum hdr_lut_type type)
+{
+	static const u32 en_mask[HDR_LUT_MAX] = {
+		[HDR_LUT_EOTF] = MOD_CTRL_EEN_MASK,
+		[HDR_LUT_OETF] = MOD_CTRL_OEN_MASK,
+		[HDR_LUT_GM] = MOD_CTRL_GEN_MASK,
+		[HDR_LUT_TM] = MOD_CTRL_TEN_MASK,
+	};
+
+	if (type >= HDR_LUT_MAX)
+		return;
+
+	hdr_write_mask(id, HDR_LSI_L_MOD_CTRL, ~0, en_mask[type]);
+	cal_log_debug(id, "%s: type(%d)\n", __func__, type);
+}
+
 void hdr_reg_print_eotf_lut(u32 id, struct drm_printer *p)
 {
 	u32 val;
@@ -790,16 +790,44 @@ static void dsc_reg_set_pps_06_07_picture_height(u32 id, u32 dsc_id, u32 height)
 	dsc_write_mask(id, DSC_PPS04_07(dsc_id), val, mask);
 }
 
-static void dsc_reg_set_pps_58_59_rc_range_param0(u32 id, u32 dsc_id, u32 rc_range)
+/*
+ * PPS register image of one encoder, DSC_PPS00_03 ~ DSC_PPS84_87. Fields the
+ * calculation leaves at zero are not written, so @mask holds the bits which
+ * are set and the others keep their reset values.
+ */
+#define DSC_PPS_REG_CNT		22
+#define DSC_PPS_IDX(reg)	(((reg) - DSC_PPS00_03(0)) / 4)
+
+struct dsc_pps_image {
+	u32 val[DSC_PPS_REG_CNT];
+	u32 mask[DSC_PPS_REG_CNT];
+};
+
+static void dsc_pps_set_mask(struct dsc_pps_image *pps, u32 reg, u32 val,
+		u32 mask)
+{
+	u32 i = DSC_PPS_IDX(reg);
+
+	pps->val[i] = (pps->val[i] & ~mask) | (val & mask);
+	pps->mask[i] |= mask;
+}
+
+static void dsc_pps_set(struct dsc_pps_image *pps, u32 reg, u32 val)
+{
+	dsc_pps_set_mask(pps, reg, val, ~0);
+}
+
+static void dsc_pps_set_58_59_rc_range_param0(struct dsc_pps_image *pps,
+		u32 rc_range)
 {
 	u32 val, mask;
 
 	val = PPS58_59_RC_RANGE_PARAM(rc_range);
 	mask = PPS58_59_RC_RANGE_PARAM_MASK;
-	dsc_write_mask(id, DSC_PPS56_59(dsc_id), val, mask);
+	dsc_pps_set_mask(pps, DSC_PPS56_59(0), val, mask);
 }
 
-static void dsc_reg_set_pps_44_57_rc_buf_thresh(u32 id, u32 dsc_id,
+static void dsc_pps_set_44_57_rc_buf_thresh(struct dsc_pps_image *pps,
 		const struct drm_dsc_config *cfg)
 {
 	u32 i, val, mask, offset = 0;
@@ -813,14 +841,14 @@ static void dsc_reg_set_pps_44_57_rc_buf_thresh(u32 id, u32 dsc_id,
 		if (!val)
 			continue;
 		offset += i;
-		dsc_write(id, DSC_PPS44_47(dsc_id) + offset, val);
+		dsc_pps_set(pps, DSC_PPS44_47(0) + offset, val);
 	}
 
 	if (cfg->rc_buf_thresh[12] || cfg->rc_buf_thresh[13]) {
 		val = PPS56_RC_BUF_THRESH_C(cfg->rc_buf_thresh[12]);
 		val |= PPS57_RC_BUF_THRESH_D(cfg->rc_buf_thresh[13]);
 		mask = PPS56_RC_BUF_THRESH_C_MASK | PPS57_RC_BUF_THRESH_D_MASK;
-		dsc_write_mask(id, DSC_PPS56_59(dsc_id), val, mask);
+		dsc_pps_set_mask(pps, DSC_PPS56_59(0), val, mask);
 	}
 }
 
@@ -831,7 +859,7 @@ static u16 dsc_reg_get_rc_range_parameter(const struct drm_dsc_rc_range_paramete
 		rc->range_bpg_offset;
 }
 
-static void dsc_reg_set_pps_58_87_rc_range_params(u32 id, u32 dsc_id,
+static void dsc_pps_set_58_87_rc_range_params(struct dsc_pps_image *pps,
 		const struct drm_dsc_config *cfg)
 {
 	u32 i, offset, val,  mask;
@@ -840,7 +868,7 @@ static void dsc_reg_set_pps_58_87_rc_range_params(u32 id, u32 dsc_id,
 	if (val) {
 		val = PPS58_59_RC_RANGE_PARAM(val);
 		mask = PPS58_59_RC_RANGE_PARAM_MASK;
-		dsc_write_mask(id, DSC_PPS56_59(dsc_id), val, mask);
+		dsc_pps_set_mask(pps, DSC_PPS56_59(0), val, mask);
 	}
 
 	for (i = 1; i < ARRAY_SIZE(cfg->rc_range_params); i++) {
@@ -853,7 +881,7 @@ static void dsc_reg_set_pps_58_87_rc_range_params(u32 id, u32 dsc_id,
 		mask = i % 2 ? 0xFFFF0000 : 0x0000FFFF;
 		offset = (i - 1) / 2;
 		offset *= 4;
-		dsc_write_mask(id, DSC_PPS60_63(dsc_id) + offset, val, mask);
+		dsc_pps_set_mask(pps, DSC_PPS60_63(0) + offset, val, mask);
 	}
 }
 
@@ -1140,12 +1168,16 @@ static void dsc_reg_dump_pps(u32 id, u32 dsc_id)
 #endif
 }
 
-static void dsc_reg_set_pps(u32 id, u32 dsc_id, struct decon_dsc *dsc_enc)
+/* PPS image of the values computed by dsc_calc_pps_info() */
+static void dsc_calc_pps_image(const struct decon_dsc *dsc_enc,
+		struct dsc_pps_image *pps)
 {
 	u32 val;
 	u8 b;
 	const struct drm_dsc_config *cfg = dsc_enc->cfg;
 
+	memset(pps, 0, sizeof(*pps));
+
 	if (cfg)
 		b = (cfg->dsc_version_major << DSC_PPS_VERSION_MAJOR_SHIFT)
 			| cfg->dsc_version_minor;
@@ -1157,7 +1189,7 @@ static void dsc_reg_set_pps(u32 id, u32 dsc_id, struct decon_dsc *dsc_enc)
 	/* default linebuf_depth = 9 bits */
 	val |= PPS03_LBD((cfg && cfg->line_buf_depth) ?
 		cfg->line_buf_depth : 9);
-	dsc_write(id, DSC_PPS00_03(dsc_id), val);
+	dsc_pps_set(pps, DSC_PPS00_03(0), val);
 
 	if (cfg)
 		b = (cfg->block_pred_enable << DSC_PPS_BLOCK_PRED_EN_SHIFT) |
@@ -1169,56 +1201,56 @@ static void dsc_reg_set_pps(u32 id, u32 dsc_id, struct decon_dsc *dsc_enc)
 		cfg->bits_per_pixel : dsc_enc->bit_per_pixel);
 	val |= PPS06_07_PIC_HEIGHT(cfg && cfg->pic_height ?
 		cfg->pic_height : dsc_enc->pic_height);
-	dsc_write(id, DSC_PPS04_07(dsc_id), val);
+	dsc_pps_set(pps, DSC_PPS04_07(0), val);
 
 	val = PPS08_09_PIC_WIDTH(cfg && cfg->pic_width ?
 		cfg->pic_width : dsc_enc->pic_width);
 	val |= PPS10_11_SLICE_HEIGHT(cfg && cfg->slice_height ?
 		cfg->slice_height : dsc_enc->slice_height);
-	dsc_write(id, DSC_PPS08_11(dsc_id), val);
+	dsc_pps_set(pps, DSC_PPS08_11(0), val);
 
 	val = PPS12_13_SLICE_WIDTH(cfg && cfg->slice_width ?
 		cfg->slice_width : dsc_enc->slice_width);
 	val |= PPS14_15_CHUNK_SIZE(cfg && cfg->slice_chunk_size ?
 		cfg->slice_chunk_size : dsc_enc->chunk_size);
-	dsc_write(id, DSC_PPS12_15(dsc_id), val);
+	dsc_pps_set(pps, DSC_PPS12_15(0), val);
 
 	val = PPS16_17_INIT_XMIT_DELAY(cfg && cfg->initial_xmit_delay ?
 		cfg->initial_xmit_delay : dsc_enc->initial_xmit_delay);
 	val |= PPS18_19_INIT_DEC_DELAY(cfg && cfg->initial_dec_delay ?
 		cfg->initial_dec_delay : dsc_enc->initial_dec_delay);
-	dsc_write(id, DSC_PPS16_19(dsc_id), val);
+	dsc_pps_set(pps, DSC_PPS16_19(0), val);
 
 	val = PPS21_INIT_SCALE_VALUE( cfg && cfg->initial_scale_value ?
 		cfg->initial_scale_value : dsc_enc->initial_scale_value);
 	val |= PPS22_23_SCALE_INC_INTERVAL(cfg && cfg->scale_increment_interval ?
 		cfg->scale_increment_interval : dsc_enc->scale_increment_interval);
-	dsc_write(id, DSC_PPS20_23(dsc_id), val);
+	dsc_pps_set(pps, DSC_PPS20_23(0), val);
 
 	val = PPS24_25_SCALE_DEC_INTERVAL(cfg && cfg->scale_decrement_interval ?
 		cfg->scale_decrement_interval : dsc_enc->scale_decrement_interval);
 	val |= PPS27_FL_BPG_OFFSET(cfg && cfg->first_line_bpg_offset ?
 		cfg->first_line_bpg_offset : dsc_enc->first_line_bpg_offset);
-	dsc_write(id, DSC_PPS24_27(dsc_id), val);
+	dsc_pps_set(pps, DSC_PPS24_27(0), val);
 
 	val = PPS28_29_NFL_BPG_OFFSET(cfg && cfg->nfl_bpg_offset ?
 		cfg->nfl_bpg_offset : dsc_enc->nfl_bpg_offset);
 	val |= PPS30_31_SLICE_BPG_OFFSET(cfg && cfg->slice_bpg_offset ?
 		cfg->slice_bpg_offset : dsc_enc->slice_bpg_offset);
-	dsc_write(id, DSC_PPS28_31(dsc_id), val);
+	dsc_pps_set(pps, DSC_PPS28_31(0), val);
 
 	val = PPS32_33_INIT_OFFSET(cfg && cfg->initial_offset ?
 		cfg->initial_offset : dsc_enc->initial_offset);
 	val |= PPS34_35_FINAL_OFFSET(cfg && cfg->final_offset ?
 		cfg->final_offset : dsc_enc->final_offset);
-	dsc_write(id, DSC_PPS32_35(dsc_id), val);
+	dsc_pps_set(pps, DSC_PPS32_35(0), val);
 
 	if (cfg) {
 		val = PPS36_FLATNESS_MIN_QP(cfg->flatness_min_qp);
 		val |= PPS37_FLATNESS_MAX_QP(cfg->flatness_max_qp);
 		val |= PPS38_39_RC_MODEL_SIZE(cfg->rc_model_size);
 		if (val)
-			dsc_write(id, DSC_PPS36_39(dsc_id), val);
+			dsc_pps_set(pps, DSC_PPS36_39(0), val);
 
 		val = PPS40_RC_EDGE_FACTOR(cfg->rc_edge_factor);
 		val |= PPS41_RC_QUANT_INCR_LIMIT0(cfg->rc_quant_incr_limit0);
@@ -1226,24 +1258,22 @@ static void dsc_reg_set_pps(u32 id, u32 dsc_id, struct decon_dsc *dsc_enc)
 		val |= PPS43_RC_TGT_OFFSET_HI(cfg->rc_tgt_offset_high);
 		val |= PPS43_RC_TGT_OFFSET_LO(cfg->rc_tgt_offset_low);
 		if (val)
-			dsc_write(id, DSC_PPS40_43(dsc_id), val);
+			dsc_pps_set(pps, DSC_PPS40_43(0), val);
 
-		dsc_reg_set_pps_44_57_rc_buf_thresh(id, dsc_id, cfg);
-		dsc_reg_set_pps_58_87_rc_range_params(id, dsc_id, cfg);
+		dsc_pps_set_44_57_rc_buf_thresh(pps, cfg);
+		dsc_pps_set_58_87_rc_range_params(pps, cfg);
 	} else {
 		/* min_qp0 = 0 , max_qp0 = 4 , bpg_off0 = 2 */
-		dsc_reg_set_pps_58_59_rc_range_param0(id, dsc_id,
+		dsc_pps_set_58_59_rc_range_param0(pps,
 			dsc_enc->rc_range_parameters);
 
 #ifndef VESA_SCR_V4
 		/* PPS79 ~ PPS87 : 3HF4 is different with VESA SCR v4 */
-		dsc_write(id, DSC_PPS76_79(dsc_id), 0x1AB62AF6);
-		dsc_write(id, DSC_PPS80_83(dsc_id), 0x2B342B74);
-		dsc_write(id, DSC_PPS84_87(dsc_id), 0x3B746BF4);
+		dsc_pps_set(pps, DSC_PPS76_79(0), 0x1AB62AF6);
+		dsc_pps_set(pps, DSC_PPS80_83(0), 0x2B342B74);
+		dsc_pps_set(pps, DSC_PPS84_87(0), 0x3B746BF4);
 #endif
 	}
-
-	dsc_reg_dump_pps(id, dsc_id);
 }
 
 /*
@@ -1429,13 +1459,154 @@ static const unsigned char DDI_PPS_INFO[] = {
 	0x74, 0x6B, 0xF4, 0x00, 0x00
 };
 
+/* DSC encoders driven by the decon, decon2 is only for DP */
+static void dsc_reg_get_encoders(u32 id, struct decon_config *config,
+		u32 *dsc_first, u32 *dsc_cnt)
+{
+	if (id == 1 || id == 2) {
+		*dsc_first = (id == 1) ? DECON_DSC_ENC1 : DECON_DSC_ENC2;
+		*dsc_cnt = 1;
+	} else {
+		*dsc_first = DECON_DSC_ENC0;
+		*dsc_cnt = config->dsc.dsc_count;
+	}
+}
+
+/*
+ * PPS register images per display mode. dsc_calc_pps_info() and the PPS
+ * image only depend on the mode and slice configuration, so the first init
+ * of a mode computes them and keeps a copy. Later inits of the same mode
+ * (enable, mode switch back, mres) burst the copy into every encoder.
+ */
+#define DSC_PPS_CACHE_CNT	4
+
+struct dsc_pps_key {
+	u32 image_width;
+	u32 image_height;
+	u32 overlap_w;
+	u32 dscc_en;
+	struct exynos_dsc dsc;
+};
+
+struct dsc_pps_entry {
+	bool valid;
+	u64 last_use;
+	struct dsc_pps_key key;
+	/* content of key.dsc.cfg, the pointer alone may be reused */
+	struct drm_dsc_config cfg;
+	struct decon_dsc enc;
+	struct dsc_pps_image pps;
+};
+
+struct dsc_pps_cache {
+	/* registers the entries were written to, tests use private ones */
+	const struct cal_regs_desc *desc;
+	u64 use_seq;
+	struct dsc_pps_entry entries[DSC_PPS_CACHE_CNT];
+};
+
+static struct dsc_pps_cache dsc_pps_cache[MAX_DECON_CNT];
+
+static void dsc_pps_key_init(struct dsc_pps_key *key, const struct decon_config *config,
+		u32 overlap_w, u32 dscc_en)
+{
+	/* compared with memcmp, padding must be zero */
+	memset(key, 0, sizeof(*key));
+	key->image_width = config->image_width;
+	key->image_height = config->image_height;
+	key->overlap_w = overlap_w;
+	key->dscc_en = dscc_en;
+	key->dsc = config->dsc;
+}
+
+static struct dsc_pps_entry *dsc_pps_cache_lookup(u32 id, const struct dsc_pps_key *key)
+{
+	struct dsc_pps_cache *cache = &dsc_pps_cache[id];
+	struct dsc_pps_entry *entry;
+	int i;
+
+	if (cache->desc != sub_regs_desc(id))
+		return NULL;
+
+	for (i = 0; i < DSC_PPS_CACHE_CNT; i++) {
+		entry = &cache->entries[i];
+		if (!entry->valid || memcmp(&entry->key, key, sizeof(*key)))
+			continue;
+		if (key->dsc.cfg && memcmp(&entry->cfg, key->dsc.cfg, sizeof(entry->cfg)))
+			continue;
+
+		entry->last_use = ++cache->use_seq;
+		return entry;
+	}
+
+	return NULL;
+}
+
+/* drop the images of @id, its registers may come back at reset values */
+static void dsc_pps_cache_invalidate(u32 id)
+{
+	memset(&dsc_pps_cache[id], 0, sizeof(dsc_pps_cache[id]));
+}
+
+static void dsc_pps_cache_store(u32 id, const struct dsc_pps_key *key,
+		const struct decon_dsc *dsc_enc, const struct dsc_pps_image *pps)
+{
+	struct dsc_pps_cache *cache = &dsc_pps_cache[id];
+	struct dsc_pps_entry *entry = &cache->entries[0];
+	int i;
+
+	if (cache->desc != sub_regs_desc(id)) {
+		dsc_pps_cache_invalidate(id);
+		cache->desc = sub_regs_desc(id);
+	}
+
+	for (i = 1; i < DSC_PPS_CACHE_CNT && entry->valid; i++) {
+		if (!cache->entries[i].valid ||
+		    cache->entries[i].last_use < entry->last_use)
+			entry = &cache->entries[i];
+	}
+
+	entry->key = *key;
+	if (key->dsc.cfg)
+		entry->cfg = *key->dsc.cfg;
+	entry->enc = *dsc_enc;
+	entry->pps = *pps;
+	entry->last_use = ++cache->use_seq;
+	entry->valid = true;
+}
+
+static void dsc_reg_set_pps(u32 id, u32 dsc_id, const struct dsc_pps_image *pps)
+{
+	struct cal_regs_desc *desc = sub_regs_desc(id);
+	u32 i, offset, val;
+
+	for (i = 0; i < DSC_PPS_REG_CNT; i++) {
+		if (!pps->mask[i])
+			continue;
+
+		offset = DSC_PPS00_03(dsc_id) + i * 4;
+		val = pps->val[i];
+		if (pps->mask[i] != ~0)
+			val |= cal_read_relaxed(desc, offset) & ~pps->mask[i];
+		cal_write_relaxed(desc, offset, val);
+	}
+	/* make the relaxed burst visible before the encoder is started */
+	wmb();
+
+	dsc_reg_dump_pps(id, dsc_id);
+}
+
 static void dsc_reg_set_encoder(u32 id, struct decon_config *config,
 		struct decon_dsc *dsc_enc, u32 chk_en)
 {
-	u32 dsc_id;
+	u32 dsc_id, dsc_first, dsc_cnt;
 	u32 dscc_en = 1;
 	u32 ds_en = 0;
 	u32 sm_ch = 0;
+	struct dsc_pps_key key;
+	const struct dsc_pps_entry *entry;
+	struct dsc_pps_image calc;
+	const struct dsc_pps_image *pps;
 	/* DDI PPS table : for compare with ENC PPS value */
 	struct decon_dsc dsc_dec;
 	/* set corresponding table like 'SEQ_PPS_SLICE4' */
@@ -1448,22 +1619,25 @@ static void dsc_reg_set_encoder(u32 id, struct decon_config *config,
 	cal_log_debug(id, "slice mode change(%d)\n", sm_ch);
 
 	dscc_en = decon_reg_get_data_path_cfg(id, PATH_CON_ID_DSCC_EN);
-	dsc_calc_pps_info(config, dscc_en, dsc_enc);
+	dsc_pps_key_init(&key, config, dsc_enc->overlap_w, dscc_en);
+	entry = dsc_pps_cache_lookup(id, &key);
+	if (entry) {
+		*dsc_enc = entry->enc;
+		pps = &entry->pps;
+	} else {
+		cal_log_debug(id, "dsc pps cache miss (%ux%u)\n", config->image_width,
+				config->image_height);
+		dsc_calc_pps_info(config, dscc_en, dsc_enc);
+		dsc_calc_pps_image(dsc_enc, &calc);
+		dsc_pps_cache_store(id, &key, dsc_enc, &calc);
+		pps = &calc;
+	}
 
-	if (id == 1) {
-		dsc_reg_config_control(id, DECON_DSC_ENC1, ds_en, sm_ch,
+	dsc_reg_get_encoders(id, config, &dsc_first, &dsc_cnt);
+	for (dsc_id = dsc_first; dsc_id < dsc_first + dsc_cnt; dsc_id++) {
+		dsc_reg_config_control(id, dsc_id, ds_en, sm_ch,
 				dsc_enc->slice_width);
-		dsc_reg_set_pps(id, DECON_DSC_ENC1, dsc_enc);
-	} else if (id == 2) {	/* only for DP */
-		dsc_reg_config_control(id, DECON_DSC_ENC2, ds_en, sm_ch,
-				dsc_enc->slice_width);
-		dsc_reg_set_pps(id, DECON_DSC_ENC2, dsc_enc);
-	} else {
-		for (dsc_id = 0; dsc_id < config->dsc.dsc_count; dsc_id++) {
-			dsc_reg_config_control(id, dsc_id, ds_en, sm_ch,
-					dsc_enc->slice_width);
-			dsc_reg_set_pps(id, dsc_id, dsc_enc);
-		}
+		dsc_reg_set_pps(id, dsc_id, pps);
 	}
 
 	if (chk_en) {
@@ -1956,6 +2130,153 @@ int decon_reg_init(u32 id, struct decon_config *config)
 	return 0;
 }
 
+struct decon_reg_range {
+	enum decon_regs_type type;
+	u32 offset;
+	u32 cnt;
+};
+
+/* DECON configuration registers written by decon_reg_init() */
+static const struct decon_reg_range decon_snapshot_ranges[] = {
+	{ REGS_DECON, BLD_BG_IMG_SIZE_PRI, 1 },
+	{ REGS_DECON, OF_SIZE_0, 1 },
+	{ REGS_DECON, OF_SIZE_2, 2 },		/* OF_SIZE_2 ~ OF_TH_TYPE */
+	{ REGS_DECON, OF_PIXEL_ORDER, 1 },	/* RGB order */
+	{ REGS_DECON, OF_LAT_MON, 1 },		/* latency monitor enable */
+	{ REGS_DECON, OF_URGENT_EN, 6 },	/* OF_URGENT_EN ~ OF_DTA_THRESHOLD */
+	{ REGS_DECON, EWR_CON, 2 },
+	{ REGS_DECON, PLL_SLEEP_CON, 1 },
+};
+
+static const struct decon_reg_range decon0_snapshot_ranges[] = {
+	{ REGS_DECON, OF_SPLIT_SIZE, 2 },	/* OF_SPLIT_SIZE ~ OF_SPLIT_IDX */
+	{ REGS_DECON, OF_SIZE_1, 1 },
+};
+
+/*
+ * offsets relative to DSC_OFFSET() of each encoder used by the decon.
+ * DSC_CONTROL0 only holds the light idle clock gating, which is programmed
+ * by decon_reg_restore() instead.
+ */
+static const struct decon_reg_range dsc_snapshot_ranges[] = {
+	{ REGS_DECON_SUB, DSC_CONTROL1(0), 1 },
+	{ REGS_DECON_SUB, DSC_CONTROL3(0), 1 },
+	{ REGS_DECON_SUB, DSC_PPS00_03(0), 22 },	/* DSC_PPS00_03 ~ DSC_PPS84_87 */
+	{ REGS_DECON_SUB, DSC_PPS92_95(0), 2 },		/* DSC_PPS92_95 ~ DSC_PPS96_99 */
+};
+
+static int decon_reg_snapshot_ranges(u32 id, const struct decon_reg_range *ranges,
+		size_t nr_ranges, u32 base, u32 *regs, u32 pos, bool save)
+{
+	struct cal_regs_desc *desc;
+	u32 offset;
+	int i, j;
+
+	for (i = 0; i < nr_ranges; i++) {
+		if (pos + ranges[i].cnt > DECON_SNAPSHOT_REG_CNT)
+			return -E2BIG;
+
+		desc = cal_regs_desc_get(&regs_decon[ranges[i].type][id]);
+		offset = base + ranges[i].offset;
+		for (j = 0; j < ranges[i].cnt; j++, pos++, offset += 4) {
+			if (save)
+				regs[pos] = cal_read_relaxed(desc, offset);
+			else
+				cal_write_relaxed(desc, offset, regs[pos]);
+		}
+	}
+
+	return pos;
+}
+
+/* returns the number of registers transferred or a negative error */
+static int decon_reg_snapshot_xfer(u32 id, struct decon_config *config,
+		u32 *regs, bool save)
+{
+	u32 dsc_id, dsc_first, dsc_cnt;
+	int pos;
+
+	pos = decon_reg_snapshot_ranges(id, decon_snapshot_ranges,
+			ARRAY_SIZE(decon_snapshot_ranges), 0, regs, 0, save);
+	if (pos >= 0 && id == 0)
+		pos = decon_reg_snapshot_ranges(id, decon0_snapshot_ranges,
+				ARRAY_SIZE(decon0_snapshot_ranges), 0, regs, pos, save);
+
+	if (pos < 0 || !config->dsc.enabled)
+		return pos;
+
+	dsc_reg_get_encoders(id, config, &dsc_first, &dsc_cnt);
+	for (dsc_id = dsc_first; dsc_id < dsc_first + dsc_cnt && pos >= 0; dsc_id++)
+		pos = decon_reg_snapshot_ranges(id, dsc_snapshot_ranges,
+				ARRAY_SIZE(dsc_snapshot_ranges), DSC_OFFSET(dsc_id),
+				regs, pos, save);
+
+	return pos;
+}
+
+int decon_reg_save(u32 id, struct decon_config *config, struct decon_reg_snapshot *snap)
+{
+	int cnt;
+
+	cnt = decon_reg_snapshot_xfer(id, config, snap->regs, true);
+	if (cnt < 0) {
+		snap->cnt = 0;
+		return cnt;
+	}
+
+	snap->version = decon_read(id, DECON_VERSION);
+	snap->cnt = cnt;
+
+	return 0;
+}
+
+/*
+ * Counterpart of decon_reg_init() which replays the registers saved by
+ * decon_reg_save() instead of recalculating them (DSC PPS, outfifo sizes,
+ * urgent thresholds). Registers tracking state shared with other decons (SRAM
+ * allocation, data path) and the ones carrying enable/trigger bits are still
+ * programmed from @config. DSC starts ungated: the snapshot may be taken in
+ * light idle, which the driver exits before powering the decon down.
+ */
+int decon_reg_restore(u32 id, struct decon_config *config,
+		const struct decon_reg_snapshot *snap)
+{
+	int cnt;
+
+	if (!snap->cnt || snap->version != decon_read(id, DECON_VERSION))
+		return -ENODEV;
+
+	decon_reg_set_clkgate_mode(id, 0);
+
+	if (config->out_type & DECON_OUT_DP)
+		decon_reg_set_qactive_pll_mode(id, 1);
+
+	decon_reg_alloc_shared_sram_instance(id, true, true);
+
+	decon_reg_set_sram_enable(id);
+
+	decon_reg_set_operation_mode(id, config->mode.op_mode);
+
+	decon_reg_init_trigger(id, config);
+
+	decon_reg_set_data_path(id, config);
+
+	cnt = decon_reg_snapshot_xfer(id, config, (u32 *)snap->regs, false);
+	/* make the relaxed burst visible before anything depends on it */
+	wmb();
+	if (WARN_ON(cnt != snap->cnt))
+		return -EINVAL;
+
+	dsc_reg_set_clock_gating(id, config, false);
+
+	decon_reg_per_frame_off(id);
+
+	/* asserted interrupt should be cleared before initializing decon hw */
+	decon_reg_clear_int_all(id);
+
+	return 0;
+}
+
 int decon_reg_start(u32 id, struct decon_config *config)
 {
 	int ret = 0;
@@ -2030,9 +2351,28 @@ int decon_reg_stop(u32 id, struct decon_config *config, bool rst, u32 fps)
 
 	decon_reg_clear_int_all(id);
 
+	/* DSC loses its registers with the decon, start the next enable afresh */
+	dsc_pps_cache_invalidate(id);
+
 	return ret;
 }
 
+void dsc_reg_set_clock_gating(u32 id, struct decon_config *config, bool en)
+{
+	u32 dsc_id, dsc_first, dsc_cnt, val, mask;
+
+	if (!config->dsc.enabled)
+		return;
+
+	val = en ? (DSC_DCG_EN_REF(1) | DSC_DCG_EN_SSM(1) | DSC_DCG_EN_ICH(1) |
+			DSC_DCG_EN(1)) : 0;
+	mask = DSC_DCG_EN_ALL_MASK | DSC_DCG_EN_MASK;
+
+	dsc_reg_get_encoders(id, config, &dsc_first, &dsc_cnt);
+	for (dsc_id = dsc_first; dsc_id < dsc_first + dsc_cnt; dsc_id++)
+		dsc_write_mask(id, DSC_CONTROL0(dsc_id), val, mask);
+}
+
 void decon_reg_set_bpc_and_dither_path(u32 id, struct decon_config *config)
 {
 	/*
@@ -2142,6 +2482,17 @@ void decon_reg_set_trigger(u32 id, struct decon_mode *mode,
 	decon_write_mask(id, TRIG_CON, val, mask);
 }
 
+bool decon_reg_is_trigger_unmasked(u32 id, struct decon_mode *mode)
+{
+	if (mode->op_mode == DECON_VIDEO_MODE)
+		return true;
+
+	if (mode->trig_mode == DECON_SW_TRIG)
+		return decon_read_mask(id, TRIG_CON, SW_TRIG_EN) != 0;
+
+	return decon_read_mask(id, TRIG_CON, HW_TRIG_MASK_DECON) == 0;
+}
+
 void decon_reg_update_req_and_unmask(u32 id, struct decon_mode *mode)
 {
 	decon_reg_update_req_global(id);
@@ -2566,3 +2917,7 @@ void decon_reg_set_rcd_enable_internal(u32 dqe_id, bool en)
 	val = en ? ENHANCE_RCD_ON : 0;
 	decon_write_mask(dqe_id, DATA_PATH_CON_0, val, ENHANCE_RCD_ON);
 }
+
+#if IS_ENABLED(CONFIG_DRM_SAMSUNG_CAL_KUNIT_TEST)
+#include "decon_reg_test.c"
+#endif
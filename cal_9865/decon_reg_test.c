@@ -0,0 +1,476 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * cal_9865/decon_reg_test.c
+ *
+ * Copyright (c) 2023 Samsung Electronics Co., Ltd.
+ *		http://www.samsung.com
+ *
+ * KUnit tests pinning the register streams written by decon_reg_init() and
+ * dsc_reg_init(), and checking the DSC PPS cache against dsc_calc_pps_info().
+ * Included from decon_reg.c to reach its static functions.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <kunit/test.h>
+#include <linux/sizes.h>
+
+#include <cal_fake_mmio.h>
+
+#define DECON_TEST_ID		0
+#define DECON_TEST_LOG_CAP	128
+
+struct decon_reg_test_ctx {
+	struct cal_fake_mmio fake[REGS_DECON_TYPE_MAX];
+	struct decon_config config;
+};
+
+/* FHD+ command mode panel, one DSC encoder with two slices */
+static const struct decon_config decon_test_cmd_dsc_config = {
+	.out_type = DECON_OUT_DSI0,
+	.image_width = 1080,
+	.image_height = 2400,
+	.mode = {
+		.op_mode = DECON_COMMAND_MODE,
+		.dsi_mode = DSI_MODE_SINGLE,
+		.trig_mode = DECON_HW_TRIG,
+	},
+	.dsc = {
+		.enabled = true,
+		.dsc_count = 1,
+		.slice_count = 2,
+		.slice_width = 540,
+		.slice_height = 24,
+	},
+	.out_bpc = 8,
+	.in_bpc = 8,
+};
+
+/* FHD+ video mode panel without compression */
+static const struct decon_config decon_test_video_config = {
+	.out_type = DECON_OUT_DSI0,
+	.image_width = 1080,
+	.image_height = 2400,
+	.mode = {
+		.op_mode = DECON_VIDEO_MODE,
+		.dsi_mode = DSI_MODE_SINGLE,
+		.trig_mode = DECON_HW_TRIG,
+	},
+	.out_bpc = 8,
+	.in_bpc = 8,
+};
+
+/* VESA DSC 1.1 parameters of a WQHD+ panel, 8 bpc at 8 bpp */
+static const struct drm_dsc_config decon_test_wqhd_dsc_cfg = {
+	.dsc_version_major = 1,
+	.dsc_version_minor = 1,
+	.bits_per_component = 8,
+	.line_buf_depth = 9,
+	.block_pred_enable = true,
+	.bits_per_pixel = 8 << 4,
+	.pic_width = 1440,
+	.pic_height = 3120,
+	.slice_width = 720,
+	.slice_height = 52,
+	.slice_chunk_size = 720,
+	.initial_xmit_delay = 512,
+	.initial_dec_delay = 656,
+	.initial_scale_value = 32,
+	.scale_increment_interval = 561,
+	.scale_decrement_interval = 9,
+	.first_line_bpg_offset = 12,
+	.nfl_bpg_offset = 236,
+	.slice_bpg_offset = 185,
+	.initial_offset = 6144,
+	.final_offset = 4336,
+	.flatness_min_qp = 3,
+	.flatness_max_qp = 12,
+	.rc_model_size = 8192,
+	.rc_edge_factor = 6,
+	.rc_quant_incr_limit0 = 11,
+	.rc_quant_incr_limit1 = 11,
+	.rc_tgt_offset_high = 3,
+	.rc_tgt_offset_low = 3,
+	.rc_buf_thresh = {
+		14, 28, 42, 56, 70, 84, 98, 105, 112, 119, 121, 123, 125, 126,
+	},
+	.rc_range_params = {
+		{ 0, 4, 2 }, { 0, 4, 0 }, { 1, 5, 0 }, { 1, 6, 62 },
+		{ 3, 7, 60 }, { 3, 7, 58 }, { 3, 7, 56 }, { 3, 8, 56 },
+		{ 3, 9, 56 }, { 3, 10, 54 }, { 5, 11, 54 }, { 5, 12, 52 },
+		{ 5, 13, 52 }, { 7, 13, 52 }, { 13, 15, 52 },
+	},
+};
+
+/* panel modes of the PPS cache check, with and without panel DSC params */
+static const struct decon_config decon_test_dsc_modes[] = {
+	decon_test_cmd_dsc_config,
+	{
+		.out_type = DECON_OUT_DSI0,
+		.image_width = 1440,
+		.image_height = 3120,
+		.mode = {
+			.op_mode = DECON_COMMAND_MODE,
+			.dsi_mode = DSI_MODE_SINGLE,
+			.trig_mode = DECON_HW_TRIG,
+		},
+		.dsc = {
+			.enabled = true,
+			.dsc_count = 2,
+			.slice_count = 2,
+			.slice_width = 720,
+			.slice_height = 52,
+		},
+		.out_bpc = 8,
+		.in_bpc = 8,
+	},
+	{
+		.out_type = DECON_OUT_DSI0,
+		.image_width = 1440,
+		.image_height = 3120,
+		.mode = {
+			.op_mode = DECON_COMMAND_MODE,
+			.dsi_mode = DSI_MODE_SINGLE,
+			.trig_mode = DECON_HW_TRIG,
+		},
+		.dsc = {
+			.enabled = true,
+			.dsc_count = 2,
+			.slice_count = 2,
+			.slice_width = 720,
+			.slice_height = 52,
+			.cfg = &decon_test_wqhd_dsc_cfg,
+		},
+		.out_bpc = 8,
+		.in_bpc = 8,
+	},
+};
+
+/* writes shared by the command and video mode init up to the trigger setup */
+#define DECON_INIT_COMMON_HEAD						\
+	{ CLOCK_CON(0),		0x00000000 },				\
+	{ SRAM_EN_OF_PRI_0,	0x11111111 },				\
+	{ SRAM_EN_OF_SEC_0,	0x00000000 },				\
+	{ SRAM_EN_OF_PRI_1,	0x00000111 },				\
+	{ SRAM_EN_OF_SEC_1,	0x00000000 },				\
+	{ SRAM_EN_OF_PRI_2,	0x00000000 },				\
+	{ SRAM_EN_OF_SEC_2,	0x00000000 },				\
+	{ SRAM_EN_OF_PRI_3,	0x00000000 },				\
+	{ SRAM_EN_OF_SEC_3,	0x00000000 }
+
+#define DECON_INIT_COMMON_URGENT					\
+	{ OF_URGENT_EN,		0x00000000 },				\
+	{ OF_RD_URGENT_0,	0x00000000 },				\
+	{ OF_RD_URGENT_1,	0x00000000 },				\
+	{ OF_URGENT_EN,		0x00000000 },				\
+	{ OF_WR_URGENT_0,	0x00000000 },				\
+	{ OF_DTA_CONTROL,	0x00000000 },				\
+	{ OF_DTA_THRESHOLD,	0x00000000 },				\
+	{ TRIG_CON,		0x00000011 }
+
+#define DECON_INIT_COMMON_INT_CLEAR					\
+	{ DECON_INT_PEND,	0x00303000 },				\
+	{ DECON_INT_PEND_EXTRA,	0x00000011 }
+
+static const struct cal_fake_mmio_write decon_init_cmd_dsc_golden[] = {
+	DECON_INIT_COMMON_HEAD,
+	{ GLOBAL_CON,		0x00000100 },
+	{ BLD_BG_IMG_SIZE_PRI,	0x09600438 },
+	DECON_INIT_COMMON_URGENT,
+	{ OF_PIXEL_ORDER,	0x00000000 },
+	{ DATA_PATH_CON_0,	0x00000011 },
+	{ OF_SIZE_0,		0x09600168 },
+	{ OF_TH_TYPE,		0x00000005 },
+	{ OF_SIZE_2,		0x001800b4 },
+	{ GLOBAL_CON,		0x00000100 },
+	DECON_INIT_COMMON_INT_CLEAR,
+};
+
+/* DSC encoder programming on a PPS cache miss */
+#define DSC_INIT_ENC0_PPS						\
+	{ DSC_CONTROL1(0),	0x00000221 },				\
+	{ DSC_CONTROL3(0),	0x000030b4 },				\
+	{ DSC_PPS00_03(0),	0x11000089 },				\
+	{ DSC_PPS04_07(0),	0x30800960 },				\
+	{ DSC_PPS08_11(0),	0x04380018 },				\
+	{ DSC_PPS12_15(0),	0x021c021c },				\
+	{ DSC_PPS16_19(0),	0x0200020e },				\
+	{ DSC_PPS20_23(0),	0x0020024c },				\
+	{ DSC_PPS24_27(0),	0x0007000c },				\
+	{ DSC_PPS28_31(0),	0x042d043d },				\
+	{ DSC_PPS32_35(0),	0x180010f0 },				\
+	{ DSC_PPS56_59(0),	0x00000102 },				\
+	{ DSC_PPS76_79(0),	0x1ab62af6 },				\
+	{ DSC_PPS80_83(0),	0x2b342b74 },				\
+	{ DSC_PPS84_87(0),	0x3b746bf4 }
+
+static const struct cal_fake_mmio_write decon_init_cmd_dsc_sub_golden[] = {
+	{ DSIMIF_SEL(1),	0x0000000f },
+	{ DSIMIF_SEL(0),	0x00000000 },
+	DSC_INIT_ENC0_PPS,
+};
+
+static const struct cal_fake_mmio_write decon_init_video_golden[] = {
+	DECON_INIT_COMMON_HEAD,
+	{ GLOBAL_CON,		0x00000000 },
+	{ BLD_BG_IMG_SIZE_PRI,	0x09600438 },
+	DECON_INIT_COMMON_URGENT,
+	{ OF_PIXEL_ORDER,	0x00000040 },
+	{ DATA_PATH_CON_0,	0x00000001 },
+	{ OF_SIZE_0,		0x09600438 },
+	{ OF_TH_TYPE,		0x00000005 },
+	{ GLOBAL_CON,		0x00000000 },
+	DECON_INIT_COMMON_INT_CLEAR,
+};
+
+static const struct cal_fake_mmio_write decon_init_video_sub_golden[] = {
+	{ DSIMIF_SEL(1),	0x0000000f },
+	{ DSIMIF_SEL(0),	0x00000000 },
+};
+
+static const struct cal_fake_mmio_write dsc_init_golden[] = {
+	{ OF_SIZE_0,		0x09600168 },
+	{ OF_TH_TYPE,		0x00000005 },
+	{ OF_SIZE_2,		0x001800b4 },
+};
+
+static const struct cal_fake_mmio_write dsc_init_sub_golden[] = {
+	DSC_INIT_ENC0_PPS,
+};
+
+static void decon_reg_test_clear_logs(struct decon_reg_test_ctx *ctx)
+{
+	int type;
+
+	for (type = 0; type < REGS_DECON_TYPE_MAX; type++)
+		cal_fake_mmio_clear_log(&ctx->fake[type]);
+}
+
+static void decon_reg_test_init_cmd_dsc(struct kunit *test)
+{
+	struct decon_reg_test_ctx *ctx = test->priv;
+
+	ctx->config = decon_test_cmd_dsc_config;
+	KUNIT_ASSERT_EQ(test, decon_reg_init(DECON_TEST_ID, &ctx->config), 0);
+
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_DECON],
+			decon_init_cmd_dsc_golden,
+			ARRAY_SIZE(decon_init_cmd_dsc_golden));
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_DECON_SUB],
+			decon_init_cmd_dsc_sub_golden,
+			ARRAY_SIZE(decon_init_cmd_dsc_sub_golden));
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_DECON_WIN].write_cnt, 0);
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_DECON_WINCON].write_cnt, 0);
+}
+
+static void decon_reg_test_init_video(struct kunit *test)
+{
+	struct decon_reg_test_ctx *ctx = test->priv;
+
+	ctx->config = decon_test_video_config;
+	KUNIT_ASSERT_EQ(test, decon_reg_init(DECON_TEST_ID, &ctx->config), 0);
+
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_DECON],
+			decon_init_video_golden,
+			ARRAY_SIZE(decon_init_video_golden));
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_DECON_SUB],
+			decon_init_video_sub_golden,
+			ARRAY_SIZE(decon_init_video_sub_golden));
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_DECON_WIN].write_cnt, 0);
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_DECON_WINCON].write_cnt, 0);
+}
+
+static void decon_reg_test_dsc_init(struct kunit *test)
+{
+	struct decon_reg_test_ctx *ctx = test->priv;
+
+	ctx->config = decon_test_cmd_dsc_config;
+	KUNIT_ASSERT_EQ(test, dsc_reg_init(DECON_TEST_ID, &ctx->config, 0, 0), 0);
+
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_DECON],
+			dsc_init_golden, ARRAY_SIZE(dsc_init_golden));
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_DECON_SUB],
+			dsc_init_sub_golden, ARRAY_SIZE(dsc_init_sub_golden));
+}
+
+/* a PPS cache hit writes the same stream as the miss which filled it */
+static void decon_reg_test_dsc_init_cached(struct kunit *test)
+{
+	struct decon_reg_test_ctx *ctx = test->priv;
+	struct dsc_pps_key key;
+
+	ctx->config = decon_test_cmd_dsc_config;
+	KUNIT_ASSERT_EQ(test, dsc_reg_init(DECON_TEST_ID, &ctx->config, 0, 0), 0);
+	dsc_pps_key_init(&key, &ctx->config, 0, 0);
+	KUNIT_ASSERT_NOT_NULL(test, dsc_pps_cache_lookup(DECON_TEST_ID, &key));
+
+	/* start over from reset values, keeping the cached PPS image */
+	memset(ctx->fake[REGS_DECON_SUB].mem, 0, ctx->fake[REGS_DECON_SUB].size);
+	decon_reg_test_clear_logs(ctx);
+
+	KUNIT_ASSERT_EQ(test, dsc_reg_init(DECON_TEST_ID, &ctx->config, 0, 0), 0);
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_DECON],
+			dsc_init_golden, ARRAY_SIZE(dsc_init_golden));
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_DECON_SUB],
+			dsc_init_sub_golden, ARRAY_SIZE(dsc_init_sub_golden));
+
+	/* stopping the decon drops the images */
+	KUNIT_ASSERT_EQ(test, decon_reg_stop(DECON_TEST_ID, &ctx->config, false, 60), 0);
+	KUNIT_EXPECT_NULL(test, dsc_pps_cache_lookup(DECON_TEST_ID, &key));
+}
+
+/*
+ * For each panel mode the cached image must match the one computed from
+ * dsc_calc_pps_info(), and so must the PPS registers of every encoder used.
+ */
+static void decon_reg_test_dsc_pps_cache(struct kunit *test)
+{
+	struct decon_reg_test_ctx *ctx = test->priv;
+	struct cal_fake_mmio *sub = &ctx->fake[REGS_DECON_SUB];
+	const struct dsc_pps_entry *entry;
+	struct dsc_pps_image pps;
+	struct decon_dsc dsc_enc;
+	struct dsc_pps_key key;
+	u32 dsc_id, dsc_first, dsc_cnt, dscc_en, offset;
+	int mode, i;
+
+	for (mode = 0; mode < ARRAY_SIZE(decon_test_dsc_modes); mode++) {
+		ctx->config = decon_test_dsc_modes[mode];
+		dsc_pps_cache_invalidate(DECON_TEST_ID);
+		KUNIT_ASSERT_EQ(test, decon_reg_init(DECON_TEST_ID, &ctx->config), 0);
+
+		dscc_en = decon_reg_get_data_path_cfg(DECON_TEST_ID,
+				PATH_CON_ID_DSCC_EN);
+		dsc_pps_key_init(&key, &ctx->config, 0, dscc_en);
+		entry = dsc_pps_cache_lookup(DECON_TEST_ID, &key);
+		KUNIT_ASSERT_NOT_NULL_MSG(test, entry, "mode %d", mode);
+
+		memset(&dsc_enc, 0, sizeof(dsc_enc));
+		dsc_calc_pps_info(&ctx->config, dscc_en, &dsc_enc);
+		dsc_calc_pps_image(&dsc_enc, &pps);
+		KUNIT_EXPECT_EQ_MSG(test, entry->enc.width_per_enc,
+				dsc_enc.width_per_enc, "mode %d", mode);
+		KUNIT_EXPECT_EQ_MSG(test, memcmp(&entry->pps, &pps, sizeof(pps)),
+				0, "mode %d", mode);
+
+		dsc_reg_get_encoders(DECON_TEST_ID, &ctx->config, &dsc_first,
+				&dsc_cnt);
+		for (dsc_id = dsc_first; dsc_id < dsc_first + dsc_cnt; dsc_id++) {
+			for (i = 0; i < DSC_PPS_REG_CNT; i++) {
+				offset = DSC_PPS00_03(dsc_id) + i * 4;
+				KUNIT_EXPECT_EQ_MSG(test,
+						cal_fake_mmio_peek(sub, offset) &
+						pps.mask[i], pps.val[i],
+						"mode %d dsc %u reg 0x%04x",
+						mode, dsc_id, offset);
+			}
+		}
+	}
+}
+
+/*
+ * Hibernation exit replays the snapshot, including the RGB order, latency
+ * monitor enable and PPS, on registers back at reset values. DSC comes back
+ * ungated even if the snapshot was taken in light idle.
+ */
+static void decon_reg_test_save_restore(struct kunit *test)
+{
+	struct decon_reg_test_ctx *ctx = test->priv;
+	struct cal_fake_mmio *decon = &ctx->fake[REGS_DECON];
+	struct cal_fake_mmio *sub = &ctx->fake[REGS_DECON_SUB];
+	struct decon_reg_snapshot *snap;
+	u32 *decon_image, *sub_image;
+	u32 offset;
+
+	snap = kunit_kzalloc(test, sizeof(*snap), GFP_KERNEL);
+	decon_image = kunit_kzalloc(test, decon->size, GFP_KERNEL);
+	sub_image = kunit_kzalloc(test, sub->size, GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, snap);
+	KUNIT_ASSERT_NOT_NULL(test, decon_image);
+	KUNIT_ASSERT_NOT_NULL(test, sub_image);
+
+	ctx->config = decon_test_cmd_dsc_config;
+	KUNIT_ASSERT_EQ(test, decon_reg_init(DECON_TEST_ID, &ctx->config), 0);
+	/* not set by init of this panel or without CONFIG_EXYNOS_LATENCY_MONITOR */
+	decon_reg_set_rgb_order(DECON_TEST_ID, DECON_BGR);
+	decon_write_mask(DECON_TEST_ID, OF_LAT_MON, ~0, LATENCY_COUNTER_ENABLE);
+	memcpy(decon_image, decon->mem, decon->size);
+	memcpy(sub_image, sub->mem, sub->size);
+
+	dsc_reg_set_clock_gating(DECON_TEST_ID, &ctx->config, true);
+	KUNIT_ASSERT_EQ(test, decon_reg_save(DECON_TEST_ID, &ctx->config, snap), 0);
+
+	memset(decon->mem, 0, decon->size);
+	memset(sub->mem, 0, sub->size);
+	/* don't rely on the reset value of the clock gating */
+	cal_fake_mmio_poke(sub, DSC_CONTROL0(0), DSC_DCG_EN_ALL_MASK | DSC_DCG_EN_MASK);
+	KUNIT_ASSERT_EQ(test, decon_reg_restore(DECON_TEST_ID, &ctx->config, snap), 0);
+
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(decon, OF_PIXEL_ORDER),
+			decon_image[OF_PIXEL_ORDER / 4]);
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(decon, OF_LAT_MON),
+			decon_image[OF_LAT_MON / 4]);
+	for (offset = DSC_PPS00_03(0); offset <= DSC_PPS84_87(0); offset += 4)
+		KUNIT_EXPECT_EQ_MSG(test, cal_fake_mmio_peek(sub, offset),
+				sub_image[offset / 4], "reg 0x%04x", offset);
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(sub, DSC_CONTROL0(0)),
+			sub_image[DSC_CONTROL0(0) / 4]);
+}
+
+static int decon_reg_test_init(struct kunit *test)
+{
+	struct decon_reg_test_ctx *ctx;
+	int type, ret;
+
+	ctx = kunit_kzalloc(test, sizeof(*ctx), GFP_KERNEL);
+	if (!ctx)
+		return -ENOMEM;
+
+	for (type = 0; type < REGS_DECON_TYPE_MAX; type++) {
+		ret = cal_fake_mmio_attach(&regs_decon[type][DECON_TEST_ID],
+				&ctx->fake[type], SZ_64K, DECON_TEST_LOG_CAP);
+		if (ret) {
+			while (--type >= 0)
+				cal_fake_mmio_detach(&regs_decon[type][DECON_TEST_ID]);
+			return ret;
+		}
+	}
+
+	test->priv = ctx;
+
+	return 0;
+}
+
+static void decon_reg_test_exit(struct kunit *test)
+{
+	struct dsc_pps_cache *cache = &dsc_pps_cache[DECON_TEST_ID];
+	int type;
+
+	/* a later test may get its private registers at the same address */
+	if (cache->desc == sub_regs_desc(DECON_TEST_ID))
+		dsc_pps_cache_invalidate(DECON_TEST_ID);
+
+	for (type = 0; type < REGS_DECON_TYPE_MAX; type++)
+		cal_fake_mmio_detach(&regs_decon[type][DECON_TEST_ID]);
+}
+
+static struct kunit_case decon_reg_test_cases[] = {
+	KUNIT_CASE(decon_reg_test_init_cmd_dsc),
+	KUNIT_CASE(decon_reg_test_init_video),
+	KUNIT_CASE(decon_reg_test_dsc_init),
+	KUNIT_CASE(decon_reg_test_dsc_init_cached),
+	KUNIT_CASE(decon_reg_test_dsc_pps_cache),
+	KUNIT_CASE(decon_reg_test_save_restore),
+	{}
+};
+
+static struct kunit_suite decon_reg_test_suite = {
+	.name = "exynos-drm-decon-reg",
+	.init = decon_reg_test_init,
+	.exit = decon_reg_test_exit,
+	.test_cases = decon_reg_test_cases,
+};
+
+kunit_test_suite(decon_reg_test_suite);
@@ -41,7 +41,8 @@
 
 struct cal_regs_desc regs_dpp[REGS_DPP_TYPE_MAX][REGS_DPP_ID_MAX];
 
-#define srcl_regs_desc(id)                      (&regs_dpp[REGS_SRAMC][id])
+#define srcl_regs_desc(id)			\
+	cal_regs_desc_get(&regs_dpp[REGS_SRAMC][id])
 #define srcl_read(id, offset)                   \
         cal_read(srcl_regs_desc(id), offset)
 #define srcl_write(id, offset, val)             \
@@ -52,14 +53,16 @@ struct cal_regs_desc regs_dpp[REGS_DPP_TYPE_MAX][REGS_DPP_ID_MAX];
         cal_write_mask(srcl_regs_desc(id), offset, val, mask)
 
 /* SCL_COEF */
-#define coef_regs_desc(id)                      (&regs_dpp[REGS_SCL_COEF][id])
+#define coef_regs_desc(id)			\
+	cal_regs_desc_get(&regs_dpp[REGS_SCL_COEF][id])
 #define coef_read(id, offset)                   \
         cal_read(coef_regs_desc(id), offset)
 #define coef_write(id, offset, val)             \
         cal_write(coef_regs_desc(id), offset, val)
 
 /* HDR_COMM_COEF */
-#define hdr_comm_regs_desc(id)                      (&regs_dpp[REGS_HDR_COMM][id])
+#define hdr_comm_regs_desc(id)			\
+	cal_regs_desc_get(&regs_dpp[REGS_HDR_COMM][id])
 #define hdr_comm_read(id, offset)                   \
 	cal_read(hdr_comm_regs_desc(id), offset)
 #define hdr_comm_write(id, offset, val)             \
@@ -69,11 +72,51 @@ struct cal_regs_desc regs_dpp[REGS_DPP_TYPE_MAX][REGS_DPP_ID_MAX];
 #define hdr_comm_write_mask(id, offset, val, mask)  \
 	cal_write_mask(hdr_comm_regs_desc(id), offset, val, mask)
 
+/* packed DPP_COM_CSC_COEF0..4 contents of one 3x3 matrix */
+#define DPP_CSC_COEF_REG_CNT	5
+
+struct dpp_csc_image {
+	u32 coef[DPP_CSC_COEF_REG_CNT];
+};
+
+/*
+ * register images of every coefficient matrix, built when the DPP registers
+ * are mapped at probe and only read once a channel is in use
+ */
+static struct dpp_csc_image csc_y2r_images[ARRAY_SIZE(csc_y2r_3x3_t)];
+static struct dpp_csc_image csc_r2y_images[ARRAY_SIZE(csc_r2y_3x3_t)];
+
+static void dpp_reg_pack_csc_image(const u16 (*m)[3], struct dpp_csc_image *img)
+{
+	img->coef[0] = DPP_CSC_COEF_H(m[0][1]) | DPP_CSC_COEF_L(m[0][0]);
+	img->coef[1] = DPP_CSC_COEF_H(m[1][0]) | DPP_CSC_COEF_L(m[0][2]);
+	img->coef[2] = DPP_CSC_COEF_H(m[1][2]) | DPP_CSC_COEF_L(m[1][1]);
+	img->coef[3] = DPP_CSC_COEF_H(m[2][1]) | DPP_CSC_COEF_L(m[2][0]);
+	img->coef[4] = DPP_CSC_COEF_L(m[2][2]);
+}
+
+static void dpp_reg_init_csc_images(void)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(csc_y2r_3x3_t); i++)
+		dpp_reg_pack_csc_image(csc_y2r_3x3_t[i], &csc_y2r_images[i]);
+	for (i = 0; i < ARRAY_SIZE(csc_r2y_3x3_t); i++)
+		dpp_reg_pack_csc_image(csc_r2y_3x3_t[i], &csc_r2y_images[i]);
+}
+
 void dpp_regs_desc_init(void __iomem *regs, phys_addr_t start, const char *name,
 		enum dpp_regs_type type, unsigned int id)
 {
 	cal_regs_desc_check(type, id, REGS_DPP_TYPE_MAX, REGS_DPP_ID_MAX);
 	cal_regs_desc_set(regs_dpp, regs, start, name, type, id);
+
+	/*
+	 * every DPP and writeback probe packs the same values, all of them run
+	 * before the display pipeline is bound and a channel can load an image
+	 */
+	if (type == REGS_DPP)
+		dpp_reg_init_csc_images();
 }
 
 
@@ -476,15 +519,20 @@ static void dpp_reg_set_uv_offset(u32 id, u32 off_x, u32 off_y)
 	dpp_write_mask(id, DPP_COM_SUB_CON, val, mask);
 }
 
-static void
-dpp_reg_set_csc_coef(u32 id, u32 std, u32 range, const unsigned long attr)
+/* CSC setting currently held by each channel */
+static struct {
+	/* registers the setting went to, tests load into private ones */
+	const struct cal_regs_desc *desc;
+	u32 con;
+	const struct dpp_csc_image *img;
+} csc_loaded[REGS_DPP_ID_MAX];
+
+static const struct dpp_csc_image *
+dpp_reg_get_csc_image(u32 id, u32 std, u32 range, const unsigned long attr)
 {
-	u32 val, mask;
 	u32 csc_id = DPP_CSC_IDX_BT601_625;
-	u32 c00, c01, c02;
-	u32 c10, c11, c12;
-	u32 c20, c21, c22;
-	const u16 (*csc_arr)[3][3];
+	const struct dpp_csc_image *images;
+	size_t cnt;
 
 	switch (std) {
 	case EXYNOS_STANDARD_BT601_625:
@@ -526,10 +574,13 @@ dpp_reg_set_csc_coef(u32 id, u32 std, u32 range, const unsigned long attr)
 		cal_log_err(id, "BT601 with limited range is set as default\n");
 	}
 
-	if (test_bit(DPP_ATTR_ODMA, &attr))
-		csc_arr = csc_r2y_3x3_t;
-	else
-		csc_arr = csc_y2r_3x3_t;
+	if (test_bit(DPP_ATTR_ODMA, &attr)) {
+		images = csc_r2y_images;
+		cnt = ARRAY_SIZE(csc_r2y_images);
+	} else {
+		images = csc_y2r_images;
+		cnt = ARRAY_SIZE(csc_y2r_images);
+	}
 
 	/*
 	 * The matrices are provided only for full or limited range
@@ -538,46 +589,24 @@ dpp_reg_set_csc_coef(u32 id, u32 std, u32 range, const unsigned long attr)
 	if (range == EXYNOS_RANGE_FULL)
 		csc_id += 1;
 
-	c00 = csc_arr[csc_id][0][0];
-	c01 = csc_arr[csc_id][0][1];
-	c02 = csc_arr[csc_id][0][2];
-
-	c10 = csc_arr[csc_id][1][0];
-	c11 = csc_arr[csc_id][1][1];
-	c12 = csc_arr[csc_id][1][2];
-
-	c20 = csc_arr[csc_id][2][0];
-	c21 = csc_arr[csc_id][2][1];
-	c22 = csc_arr[csc_id][2][2];
-
-	mask = (DPP_CSC_COEF_H_MASK | DPP_CSC_COEF_L_MASK);
-	val = (DPP_CSC_COEF_H(c01) | DPP_CSC_COEF_L(c00));
-	dpp_write_mask(id, DPP_COM_CSC_COEF0, val, mask);
-
-	val = (DPP_CSC_COEF_H(c10) | DPP_CSC_COEF_L(c02));
-	dpp_write_mask(id, DPP_COM_CSC_COEF1, val, mask);
-
-	val = (DPP_CSC_COEF_H(c12) | DPP_CSC_COEF_L(c11));
-	dpp_write_mask(id, DPP_COM_CSC_COEF2, val, mask);
-
-	val = (DPP_CSC_COEF_H(c21) | DPP_CSC_COEF_L(c20));
-	dpp_write_mask(id, DPP_COM_CSC_COEF3, val, mask);
-
-	mask = DPP_CSC_COEF_L_MASK;
-	val = DPP_CSC_COEF_L(c22);
-	dpp_write_mask(id, DPP_COM_CSC_COEF4, val, mask);
+	if (csc_id >= cnt) {
+		cal_log_err(id, "no CSC matrix for std=%d, BT601 limited is used\n",
+				std);
+		csc_id = DPP_CSC_IDX_BT601_625;
+	}
 
 	cal_log_debug(id, "---[%s CSC Type: std=%d, rng=%d]---\n",
 		test_bit(DPP_ATTR_ODMA, &attr) ? "R2Y" : "Y2R", std, range);
-	cal_log_debug(id, "0x%4x  0x%4x  0x%4x\n", c00, c01, c02);
-	cal_log_debug(id, "0x%4x  0x%4x  0x%4x\n", c10, c11, c12);
-	cal_log_debug(id, "0x%4x  0x%4x  0x%4x\n", c20, c21, c22);
+
+	return &images[csc_id];
 }
 
 static void
 dpp_reg_set_csc_params(u32 id, u32 std, u32 range, const unsigned long attr)
 {
+	const struct dpp_csc_image *img = NULL;
 	u32 type, hw_range, mode, val, mask;
+	int i;
 
 	mode = DPP_CSC_MODE_HARDWIRED;
 
@@ -622,61 +651,92 @@ dpp_reg_set_csc_params(u32 id, u32 std, u32 range, const unsigned long attr)
 		hw_range = DPP_CSC_RANGE_LIMITED;
 
 	val = type | hw_range | mode;
+	if (mode == DPP_CSC_MODE_CUSTOMIZED)
+		img = dpp_reg_get_csc_image(id, std, range, attr);
+
+	if (csc_loaded[id].desc == dpp_regs_desc(id) &&
+			csc_loaded[id].con == val && csc_loaded[id].img == img) {
+		cal_log_debug(id, "CSC unchanged(0x%x)\n", val);
+		return;
+	}
+
 	mask = (DPP_CSC_TYPE_MASK | DPP_CSC_RANGE_MASK | DPP_CSC_MODE_MASK);
 	dpp_write_mask(id, DPP_COM_CSC_CON, val, mask);
 
-	if (mode == DPP_CSC_MODE_CUSTOMIZED)
-		dpp_reg_set_csc_coef(id, std, range, attr);
+	if (img) {
+		/* COEF0..3 are fully covered by the H/L fields */
+		for (i = 0; i < DPP_CSC_COEF_REG_CNT - 1; i++)
+			dpp_write(id, DPP_COM_CSC_COEF0 + i * 4, img->coef[i]);
+		dpp_write_mask(id, DPP_COM_CSC_COEF4, img->coef[4],
+				DPP_CSC_COEF_L_MASK);
+
+		for (i = 0; i < DPP_CSC_COEF_REG_CNT; i++)
+			cal_log_debug(id, "COEF%d: 0x%08x\n", i, img->coef[i]);
+	}
+
+	csc_loaded[id].desc = dpp_regs_desc(id);
+	csc_loaded[id].con = val;
+	csc_loaded[id].img = img;
 }
 
 static void dpp_reg_set_h_coef(u32 id, u32 cid, u32 h_ratio)
 {
 	int i, j, sc_ratio;
-
-	if (h_ratio <= DPP_SC_RATIO_MAX)
-		sc_ratio = 0;
-	else if (h_ratio <= DPP_SC_RATIO_7_8)
-		sc_ratio = 1;
-	else if (h_ratio <= DPP_SC_RATIO_6_8)
-		sc_ratio = 2;
-	else if (h_ratio <= DPP_SC_RATIO_5_8)
-		sc_ratio = 3;
-	else if (h_ratio <= DPP_SC_RATIO_4_8)
-		sc_ratio = 4;
-	else if (h_ratio <= DPP_SC_RATIO_3_8)
-		sc_ratio = 5;
-	else
-		sc_ratio = 6;
+	s16 gen[DPP_SCL_COEF_PHASE_CNT][8];
+	const s16 (*coef)[8] = gen;
+
+	if (!dpp_scl_coef_get(h_ratio, 8, &gen[0][0])) {
+		if (h_ratio <= DPP_SC_RATIO_MAX)
+			sc_ratio = 0;
+		else if (h_ratio <= DPP_SC_RATIO_7_8)
+			sc_ratio = 1;
+		else if (h_ratio <= DPP_SC_RATIO_6_8)
+			sc_ratio = 2;
+		else if (h_ratio <= DPP_SC_RATIO_5_8)
+			sc_ratio = 3;
+		else if (h_ratio <= DPP_SC_RATIO_4_8)
+			sc_ratio = 4;
+		else if (h_ratio <= DPP_SC_RATIO_3_8)
+			sc_ratio = 5;
+		else
+			sc_ratio = 6;
+		coef = h_coef_8t[sc_ratio];
+	}
 
 	for (i = 0; i < 9; i++)
 		for (j = 0; j < 8; j++)
 		        coef_write(id, DPP_H_COEF(cid, i, j),
-		                        h_coef_8t[sc_ratio][i][j]);
+		                        coef[i][j]);
 }
 
 static void dpp_reg_set_v_coef(u32 id ,u32 cid, u32 v_ratio)
 {
 	int i, j, sc_ratio;
-
-	if (v_ratio <= DPP_SC_RATIO_MAX)
-		sc_ratio = 0;
-	else if (v_ratio <= DPP_SC_RATIO_7_8)
-		sc_ratio = 1;
-	else if (v_ratio <= DPP_SC_RATIO_6_8)
-		sc_ratio = 2;
-	else if (v_ratio <= DPP_SC_RATIO_5_8)
-		sc_ratio = 3;
-	else if (v_ratio <= DPP_SC_RATIO_4_8)
-		sc_ratio = 4;
-	else if (v_ratio <= DPP_SC_RATIO_3_8)
-		sc_ratio = 5;
-	else
-		sc_ratio = 6;
+	s16 gen[DPP_SCL_COEF_PHASE_CNT][4];
+	const s16 (*coef)[4] = gen;
+
+	if (!dpp_scl_coef_get(v_ratio, 4, &gen[0][0])) {
+		if (v_ratio <= DPP_SC_RATIO_MAX)
+			sc_ratio = 0;
+		else if (v_ratio <= DPP_SC_RATIO_7_8)
+			sc_ratio = 1;
+		else if (v_ratio <= DPP_SC_RATIO_6_8)
+			sc_ratio = 2;
+		else if (v_ratio <= DPP_SC_RATIO_5_8)
+			sc_ratio = 3;
+		else if (v_ratio <= DPP_SC_RATIO_4_8)
+			sc_ratio = 4;
+		else if (v_ratio <= DPP_SC_RATIO_3_8)
+			sc_ratio = 5;
+		else
+			sc_ratio = 6;
+		coef = v_coef_4t[sc_ratio];
+	}
 
 	for (i = 0; i < 9; i++)
 		for (j = 0; j < 4; j++)
 		        coef_write(id, DPP_V_COEF(cid, i, j),
-		                        v_coef_4t[sc_ratio][i][j]);
+		                        coef[i][j]);
 }
 
 static void dpp_reg_set_scale_ratio(u32 id, struct dpp_params_info *p)
@@ -1079,6 +1139,9 @@ int rcd_reg_deinit(u32 id, bool reset, const unsigned long attr)
  */
 void dpp_reg_init(u32 id, const unsigned long attr)
 {
+	/* channel may have lost its registers while it was off */
+	csc_loaded[id].desc = NULL;
+
 	if (test_bit(DPP_ATTR_RCD, &attr))
 		rcd_reg_init(id);
 
@@ -1142,6 +1205,7 @@ int dpp_reg_deinit(u32 id, bool reset, const unsigned long attr)
 	}
 
 	if (reset) {
+		csc_loaded[id].desc = NULL;
 		if (test_bit(DPP_ATTR_IDMA, &attr) &&
 				!test_bit(DPP_ATTR_DPP, &attr)) { /* IDMA */
 			idma_reg_set_sw_reset(id);
@@ -1168,6 +1232,26 @@ int dpp_reg_deinit(u32 id, bool reset, const unsigned long attr)
 	return 0;
 }
 
+/*
+ * Dynamic/SRAM clock gating of an unused channel, dpp_reg_init() turns it
+ * off again before the channel is used.
+ */
+void dpp_reg_set_clock_gating(u32 id, const unsigned long attr, bool en)
+{
+	if (test_bit(DPP_ATTR_RCD, &attr)) {
+		rcd_reg_set_sram_clk_gate_en(id, en);
+		rcd_reg_set_dynamic_gating_en_all(id, en);
+	}
+
+	if (test_bit(DPP_ATTR_IDMA, &attr)) {
+		idma_reg_set_sram_clk_gate_en(id, en);
+		idma_reg_set_dynamic_gating_en_all(id, en);
+	}
+
+	if (test_bit(DPP_ATTR_ODMA, &attr))
+		odma_reg_set_dynamic_gating_en_all(id, en);
+}
+
 #if defined(DMA_BIST)
 static const u32 pattern_data[] = {
 	0xffffffff,
@@ -1245,6 +1329,12 @@ void dpp_reg_configure_params(u32 id, struct dpp_params_info *p,
 #endif
 }
 
+void dpp_reg_set_base_addr(u32 id, struct dpp_params_info *p,
+		const unsigned long attr)
+{
+	dma_reg_set_base_addr(id, p, attr);
+}
+
 u32 dpp_reg_get_irq_and_clear(u32 id)
 {
 	u32 val;
@@ -1592,3 +1682,8 @@ void cgc_reg_set_cgc_start_internal(u32 id)
 	dma_write_mask(id, CGC_IN_CTRL_1, START_EN_SET0(1), START_EN_SET0_MASK);
 	dma_write_mask(id, CGC_ENABLE, CGC_START_SET_0, CGC_START_SET_0_MASK);
 }
+
+#if IS_ENABLED(CONFIG_DRM_SAMSUNG_CAL_KUNIT_TEST)
+#include "dpp_csc_test.c"
+#include "dpp_reg_test.c"
+#endif
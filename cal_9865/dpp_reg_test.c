@@ -0,0 +1,279 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * cal_9865/dpp_reg_test.c
+ *
+ * Copyright (c) 2023 Samsung Electronics Co., Ltd.
+ *		http://www.samsung.com
+ *
+ * KUnit tests pinning the register streams written by
+ * dpp_reg_configure_params() and the write counts of the per-frame DPP
+ * paths. Included from dpp_reg.c to reach its static functions.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <kunit/test.h>
+#include <linux/sizes.h>
+
+#include <cal_fake_mmio.h>
+
+#define DPP_REG_TEST_ID		REGS_DPP1_ID
+#define DPP_REG_TEST_LOG_CAP	512
+
+struct dpp_reg_test_ctx {
+	struct cal_fake_mmio fake[REGS_DPP_TYPE_MAX];
+	struct dpp_params_info p;
+};
+
+/* graphics channel, no scaler */
+#define DPP_REG_TEST_ATTR_GF						\
+	(BIT(DPP_ATTR_IDMA) | BIT(DPP_ATTR_DPP) | BIT(DPP_ATTR_SRAMC) |	\
+	 BIT(DPP_ATTR_AFBC) | BIT(DPP_ATTR_BLOCK) | BIT(DPP_ATTR_FLIP) |	\
+	 BIT(DPP_ATTR_CSC))
+
+/* video channel with scaler */
+#define DPP_REG_TEST_ATTR_VGS						\
+	(DPP_REG_TEST_ATTR_GF | BIT(DPP_ATTR_SBWC) | BIT(DPP_ATTR_ROT) |	\
+	 BIT(DPP_ATTR_SCALE) | BIT(DPP_ATTR_SCL_COEF))
+
+/* FHD+ full screen ARGB layer */
+static const struct dpp_params_info dpp_test_rgb_params = {
+	.src = { .x = 0, .y = 0, .w = 1080, .h = 2400, .f_w = 1080, .f_h = 2400 },
+	.dst = { .x = 0, .y = 0, .w = 1080, .h = 2400, .f_w = 1080, .f_h = 2400 },
+	.format = DRM_FORMAT_ARGB8888,
+	.addr = { 0x80000000 },
+	.h_ratio = 1 << 20,
+	.v_ratio = 1 << 20,
+	.in_bpc = DPP_BPC_8,
+	.rcv_num = 400000,
+	.comp_type = COMP_TYPE_NONE,
+};
+
+/* FHD NV12 video downscaled to the panel width */
+static const struct dpp_params_info dpp_test_nv12_params = {
+	.src = { .x = 0, .y = 0, .w = 1920, .h = 1080, .f_w = 1920, .f_h = 1088 },
+	.dst = { .x = 0, .y = 896, .w = 1080, .h = 608, .f_w = 1080, .f_h = 2400 },
+	.format = DRM_FORMAT_NV12,
+	.addr = { 0x80000000, 0x801fe000 },
+	.is_scale = true,
+	.h_ratio = (1 << 20) * 1920 / 1080,
+	.v_ratio = (1 << 20) * 1080 / 608,
+	.standard = EXYNOS_STANDARD_BT709,
+	.range = EXYNOS_RANGE_LIMITED,
+	.in_bpc = DPP_BPC_8,
+	.rcv_num = 400000,
+	.comp_type = COMP_TYPE_NONE,
+};
+
+/* deadlock timeout of rcv_num * 51 cycles */
+#define DPP_TEST_DMA_TAIL						\
+	{ RDMA_DEADLOCK_CTRL,	0x00000001 },				\
+	{ RDMA_DEADLOCK_CTRL,	0x026e8f01 }
+
+static const struct cal_fake_mmio_write dpp_test_rgb_dma_golden[] = {
+	{ RDMA_SRC_OFFSET,	0x00000000 },
+	{ RDMA_SRC_WIDTH,	0x00000438 },
+	{ RDMA_SRC_HEIGHT,	0x00000960 },
+	{ RDMA_IMG_SIZE,	0x09600438 },
+	{ RDMA_IN_CTRL_0,	0x00000000 },
+	{ RDMA_BASEADDR_P0,	0x80000000 },
+	{ RDMA_BASEADDR_P1,	0x00000000 },
+	{ RDMA_IN_CTRL_0,	0x00000000 },
+	{ RDMA_IN_CTRL_0,	0x00000300 },
+	{ RDMA_IN_CTRL_0,	0x00000300 },
+	{ RDMA_RECOVERY_CTRL,	0x00000000 },
+	{ RDMA_RECOVERY_CTRL,	0x000c3500 },
+	{ RDMA_AFBC_PARAM,	0x00000000 },
+	DPP_TEST_DMA_TAIL,
+};
+
+static const struct cal_fake_mmio_write dpp_test_rgb_dpp_golden[] = {
+	{ DPP_COM_IMG_SIZE,	0x09600438 },
+	{ DPP_COM_IO_CON,	0x00000000 },
+	{ DPP_COM_IO_CON,	0x00000080 },
+	{ DPP_COM_IO_CON,	0x00000080 },
+};
+
+static const struct cal_fake_mmio_write dpp_test_rgb_sramc_golden[] = {
+	{ SRAMC_L_COM_DST_POSITION_REG,	0x095f0000 },
+	{ SRAMC_L_COM_MODE_REG,		0x00000000 },
+};
+
+static const struct cal_fake_mmio_write dpp_test_nv12_dma_golden[] = {
+	{ RDMA_SRC_OFFSET,	0x00000000 },
+	{ RDMA_SRC_WIDTH,	0x00000780 },
+	{ RDMA_SRC_HEIGHT,	0x00000440 },
+	{ RDMA_IMG_SIZE,	0x04380780 },
+	{ RDMA_IN_CTRL_0,	0x00000000 },
+	{ RDMA_BASEADDR_P0,	0x80000000 },
+	{ RDMA_BASEADDR_P1,	0x801fe000 },
+	{ RDMA_IN_CTRL_0,	0x00000000 },
+	{ RDMA_IN_CTRL_0,	0x00001900 },
+	{ RDMA_IN_CTRL_0,	0x00001900 },
+	{ RDMA_RECOVERY_CTRL,	0x00000000 },
+	{ RDMA_RECOVERY_CTRL,	0x000c3500 },
+	{ RDMA_AFBC_PARAM,	0x00000000 },
+	{ RDMA_SBWC_PARAM,	0x00000000 },
+	DPP_TEST_DMA_TAIL,
+};
+
+/* BT.709 limited is hardwired, no coefficients are loaded */
+static const struct cal_fake_mmio_write dpp_test_nv12_dpp_golden[] = {
+	{ DPP_COM_CSC_CON,		0x00000004 },
+	{ DPP_COM_SCL_CTRL,		0x00000001 },
+	{ DPP_COM_SCL_CTRL,		0x00000001 },
+	{ DPP_COM_SCL_H_RATIO,		0x001c71c7 },
+	{ DPP_COM_SCL_V_RATIO,		0x001c6bca },
+	{ DPP_COM_IMG_SIZE,		0x04380780 },
+	{ DPP_COM_SCL_HPOSITION,	0x00000000 },
+	{ DPP_COM_SCL_VPOSITION,	0x00000000 },
+	{ DPP_COM_SCL_SCALED_IMG_SIZE,	0x02600438 },
+	{ DPP_COM_IO_CON,		0x00000000 },
+	{ DPP_COM_IO_CON,		0x00000000 },
+	{ DPP_COM_IO_CON,		0x00000002 },
+};
+
+static const struct cal_fake_mmio_write dpp_test_nv12_sramc_golden[] = {
+	{ SRAMC_L_COM_DST_POSITION_REG,	0x05df0380 },
+	{ SRAMC_L_COM_MODE_REG,		0x00001002 },
+};
+
+/* 9 phases of the 8 tap horizontal and 4 tap vertical filters */
+#define DPP_TEST_SCL_COEF_WRITES	(9 * 8 + 9 * 4)
+
+static void dpp_reg_test_clear_logs(struct dpp_reg_test_ctx *ctx)
+{
+	int type;
+
+	for (type = 0; type < REGS_DPP_TYPE_MAX; type++)
+		cal_fake_mmio_clear_log(&ctx->fake[type]);
+}
+
+static void dpp_reg_test_rgb(struct kunit *test)
+{
+	struct dpp_reg_test_ctx *ctx = test->priv;
+
+	ctx->p = dpp_test_rgb_params;
+	dpp_reg_configure_params(DPP_REG_TEST_ID, &ctx->p, DPP_REG_TEST_ATTR_GF);
+
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_DMA],
+			dpp_test_rgb_dma_golden,
+			ARRAY_SIZE(dpp_test_rgb_dma_golden));
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_DPP],
+			dpp_test_rgb_dpp_golden,
+			ARRAY_SIZE(dpp_test_rgb_dpp_golden));
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_SRAMC],
+			dpp_test_rgb_sramc_golden,
+			ARRAY_SIZE(dpp_test_rgb_sramc_golden));
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_SCL_COEF].write_cnt, 0);
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_HDR_COMM].write_cnt, 0);
+}
+
+static void dpp_reg_test_nv12_scaled(struct kunit *test)
+{
+	struct dpp_reg_test_ctx *ctx = test->priv;
+
+	ctx->p = dpp_test_nv12_params;
+	dpp_reg_configure_params(DPP_REG_TEST_ID, &ctx->p, DPP_REG_TEST_ATTR_VGS);
+
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_DMA],
+			dpp_test_nv12_dma_golden,
+			ARRAY_SIZE(dpp_test_nv12_dma_golden));
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_DPP],
+			dpp_test_nv12_dpp_golden,
+			ARRAY_SIZE(dpp_test_nv12_dpp_golden));
+	cal_fake_mmio_expect_log(test, &ctx->fake[REGS_SRAMC],
+			dpp_test_nv12_sramc_golden,
+			ARRAY_SIZE(dpp_test_nv12_sramc_golden));
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_SCL_COEF].write_cnt,
+			DPP_TEST_SCL_COEF_WRITES);
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_HDR_COMM].write_cnt, 0);
+}
+
+/*
+ * Write counts of the per-frame paths: a commit keeping the layer setup
+ * rewrites the DMA and DPP geometry but no CSC or scaler coefficients, and
+ * a buffer-only flip writes nothing but the plane base addresses.
+ */
+static void dpp_reg_test_write_cnt(struct kunit *test)
+{
+	struct dpp_reg_test_ctx *ctx = test->priv;
+
+	ctx->p = dpp_test_nv12_params;
+	dpp_reg_configure_params(DPP_REG_TEST_ID, &ctx->p, DPP_REG_TEST_ATTR_VGS);
+	dpp_reg_test_clear_logs(ctx);
+
+	dpp_reg_configure_params(DPP_REG_TEST_ID, &ctx->p, DPP_REG_TEST_ATTR_VGS);
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_DMA].write_cnt,
+			ARRAY_SIZE(dpp_test_nv12_dma_golden));
+	/* all but CSC_CON and the two scale ratios */
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_DPP].write_cnt,
+			ARRAY_SIZE(dpp_test_nv12_dpp_golden) - 3);
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_SRAMC].write_cnt,
+			ARRAY_SIZE(dpp_test_nv12_sramc_golden));
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_SCL_COEF].write_cnt, 0);
+
+	dpp_reg_test_clear_logs(ctx);
+	ctx->p.addr[0] += SZ_4M;
+	ctx->p.addr[1] += SZ_4M;
+	dpp_reg_set_base_addr(DPP_REG_TEST_ID, &ctx->p, DPP_REG_TEST_ATTR_VGS);
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_DMA].write_cnt, 2);
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(&ctx->fake[REGS_DMA],
+			RDMA_BASEADDR_P0), 0x80000000 + SZ_4M);
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(&ctx->fake[REGS_DMA],
+			RDMA_BASEADDR_P1), 0x801fe000 + SZ_4M);
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_DPP].write_cnt, 0);
+	KUNIT_EXPECT_EQ(test, ctx->fake[REGS_SRAMC].write_cnt, 0);
+}
+
+static int dpp_reg_test_init(struct kunit *test)
+{
+	struct dpp_reg_test_ctx *ctx;
+	int type, ret;
+
+	ctx = kunit_kzalloc(test, sizeof(*ctx), GFP_KERNEL);
+	if (!ctx)
+		return -ENOMEM;
+
+	for (type = 0; type < REGS_DPP_TYPE_MAX; type++) {
+		ret = cal_fake_mmio_attach(&regs_dpp[type][DPP_REG_TEST_ID],
+				&ctx->fake[type], SZ_64K, DPP_REG_TEST_LOG_CAP);
+		if (ret) {
+			while (--type >= 0)
+				cal_fake_mmio_detach(&regs_dpp[type][DPP_REG_TEST_ID]);
+			return ret;
+		}
+	}
+
+	/* loaded CSC setting may be left over from an earlier test */
+	csc_loaded[DPP_REG_TEST_ID].desc = NULL;
+	test->priv = ctx;
+
+	return 0;
+}
+
+static void dpp_reg_test_exit(struct kunit *test)
+{
+	int type;
+
+	for (type = 0; type < REGS_DPP_TYPE_MAX; type++)
+		cal_fake_mmio_detach(&regs_dpp[type][DPP_REG_TEST_ID]);
+}
+
+static struct kunit_case dpp_reg_test_cases[] = {
+	KUNIT_CASE(dpp_reg_test_rgb),
+	KUNIT_CASE(dpp_reg_test_nv12_scaled),
+	KUNIT_CASE(dpp_reg_test_write_cnt),
+	{}
+};
+
+static struct kunit_suite dpp_reg_test_suite = {
+	.name = "exynos-drm-dpp-reg",
+	.init = dpp_reg_test_init,
+	.exit = dpp_reg_test_exit,
+	.test_cases = dpp_reg_test_cases,
+};
+
+kunit_test_suite(dpp_reg_test_suite);
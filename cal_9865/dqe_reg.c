@@ -109,7 +109,6 @@ void dqe_reg_init(u32 dqe_id, u32 width, u32 height)
 void dqe_reg_set_degamma_lut(u32 dqe_id, const struct drm_color_lut *lut)
 {
 	int i, ret = 0;
-	u16 tmp_lut[DEGAMMA_LUT_SIZE] = {0};
 	u32 regs[DQE_DEGAMMALUT_REG_CNT] = {0};
 
 	cal_log_debug(0, "%s +\n", __func__);
@@ -119,10 +118,7 @@ void dqe_reg_set_degamma_lut(u32 dqe_id, const struct drm_color_lut *lut)
 		return;
 	}
 
-	for (i = 0; i < DEGAMMA_LUT_SIZE; i++)
-		tmp_lut[i] = lut[i].red;
-
-	ret = cal_pack_lut_into_reg_pairs(tmp_lut, DQE_DEGAMMALUT_POS_SIZE,
+	ret = cal_pack_color_lut_into_reg_pairs(lut, red, DQE_DEGAMMALUT_POS_SIZE,
 		DEGAMMA_LUT_L_MASK, DEGAMMA_LUT_H_MASK, regs,
 		DQE_DEGAMMALUT_REG_CNT);
 	if(ret) {
@@ -134,7 +130,7 @@ void dqe_reg_set_degamma_lut(u32 dqe_id, const struct drm_color_lut *lut)
 		degamma_write_relaxed(dqe_id, DQE_DEGAMMA_POSX(i), regs[i]);
 		cal_log_debug(0, "[%d]: 0x%x\n", i, regs[i]);
 	}
-	ret = cal_pack_lut_into_reg_pairs(tmp_lut + 33, DQE_DEGAMMALUT_POS_SIZE,
+	ret = cal_pack_color_lut_into_reg_pairs(lut + 33, red, DQE_DEGAMMALUT_POS_SIZE,
 		DEGAMMA_LUT_L_MASK, DEGAMMA_LUT_H_MASK, regs,
 		DQE_DEGAMMALUT_REG_CNT);
 	if (ret) {
@@ -182,7 +178,6 @@ void dqe_reg_set_regamma_lut(u32 dqe_id, u32 regamma_id, const struct drm_color_
 		REGAMMA_MAX = 3
 	};
 	int i, ret = 0;
-	u16 tmp_lut[REGAMMA_MAX][REGAMMA_LUT_SIZE] = {0};
 	u32 regs[DQE_REGAMMALUT_REG_CNT] = {0};
 
 	cal_log_debug(0, "%s +\n", __func__);
@@ -192,13 +187,7 @@ void dqe_reg_set_regamma_lut(u32 dqe_id, u32 regamma_id, const struct drm_color_
 		return;
 	}
 
-	for (i = 0; i < REGAMMA_LUT_SIZE; i++) {
-		tmp_lut[REGAMMA_RED][i] = lut[i].red;
-		tmp_lut[REGAMMA_GREEN][i] = lut[i].green;
-		tmp_lut[REGAMMA_BLUE][i] = lut[i].blue;
-	}
-
-	ret = cal_pack_lut_into_reg_pairs(tmp_lut[REGAMMA_RED], DQE_REGAMMA_POS_LUT_SIZE,
+	ret = cal_pack_color_lut_into_reg_pairs(lut, red, DQE_REGAMMA_POS_LUT_SIZE,
 			REGAMMA_LUT_L_MASK, REGAMMA_LUT_H_MASK, regs,
 			DQE_REGAMMALUT_REG_CNT);
 	if (ret) {
@@ -208,7 +197,7 @@ void dqe_reg_set_regamma_lut(u32 dqe_id, u32 regamma_id, const struct drm_color_
 	for (i = 0; i < DQE_REGAMMALUT_REG_CNT; i++)
 		regamma_write_relaxed(dqe_id, DQE_REGAMMA_R_POSX(regamma_id, i), regs[i]);
 
-	ret = cal_pack_lut_into_reg_pairs(tmp_lut[REGAMMA_RED] + 33, DQE_REGAMMA_POS_LUT_SIZE,
+	ret = cal_pack_color_lut_into_reg_pairs(lut + 33, red, DQE_REGAMMA_POS_LUT_SIZE,
 			REGAMMA_LUT_L_MASK, REGAMMA_LUT_H_MASK, regs,
 			DQE_REGAMMALUT_REG_CNT);
 	if (ret) {
@@ -218,7 +207,7 @@ void dqe_reg_set_regamma_lut(u32 dqe_id, u32 regamma_id, const struct drm_color_
 	for (i = 0; i < DQE_REGAMMALUT_REG_CNT; i++)
 		regamma_write_relaxed(dqe_id, DQE_REGAMMA_R_POSY(regamma_id, i), regs[i]);
 
-	ret = cal_pack_lut_into_reg_pairs(tmp_lut[REGAMMA_GREEN], DQE_REGAMMA_POS_LUT_SIZE,
+	ret = cal_pack_color_lut_into_reg_pairs(lut, green, DQE_REGAMMA_POS_LUT_SIZE,
 			REGAMMA_LUT_L_MASK, REGAMMA_LUT_H_MASK, regs,
 			DQE_REGAMMALUT_REG_CNT);
 	if (ret) {
@@ -228,7 +217,7 @@ void dqe_reg_set_regamma_lut(u32 dqe_id, u32 regamma_id, const struct drm_color_
 	for (i = 0; i < DQE_REGAMMALUT_REG_CNT; i++)
 		regamma_write_relaxed(dqe_id, DQE_REGAMMA_G_POSX(regamma_id, i), regs[i]);
 
-	ret = cal_pack_lut_into_reg_pairs(tmp_lut[REGAMMA_GREEN] + 33, DQE_REGAMMA_POS_LUT_SIZE,
+	ret = cal_pack_color_lut_into_reg_pairs(lut + 33, green, DQE_REGAMMA_POS_LUT_SIZE,
 			REGAMMA_LUT_L_MASK, REGAMMA_LUT_H_MASK, regs,
 			DQE_REGAMMALUT_REG_CNT);
 	if (ret) {
@@ -238,7 +227,7 @@ void dqe_reg_set_regamma_lut(u32 dqe_id, u32 regamma_id, const struct drm_color_
 	for (i = 0; i < DQE_REGAMMALUT_REG_CNT; i++)
 		regamma_write_relaxed(dqe_id, DQE_REGAMMA_G_POSY(regamma_id, i), regs[i]);
 
-	ret = cal_pack_lut_into_reg_pairs(tmp_lut[REGAMMA_BLUE], DQE_REGAMMA_POS_LUT_SIZE,
+	ret = cal_pack_color_lut_into_reg_pairs(lut, blue, DQE_REGAMMA_POS_LUT_SIZE,
 			REGAMMA_LUT_L_MASK, REGAMMA_LUT_H_MASK, regs,
 			DQE_REGAMMALUT_REG_CNT);
 	if (ret) {
@@ -248,7 +237,7 @@ void dqe_reg_set_regamma_lut(u32 dqe_id, u32 regamma_id, const struct drm_color_
 	for (i = 0; i < DQE_REGAMMALUT_REG_CNT; i++)
 		regamma_write_relaxed(dqe_id, DQE_REGAMMA_B_POSX(regamma_id, i), regs[i]);
 
-	ret = cal_pack_lut_into_reg_pairs(tmp_lut[REGAMMA_BLUE] + 33, DQE_REGAMMA_POS_LUT_SIZE,
+	ret = cal_pack_color_lut_into_reg_pairs(lut + 33, blue, DQE_REGAMMA_POS_LUT_SIZE,
 			REGAMMA_LUT_L_MASK, REGAMMA_LUT_H_MASK, regs,
 			DQE_REGAMMALUT_REG_CNT);
 	if (ret) {
@@ -772,7 +761,7 @@ void dqe_reg_set_histogram(u32 dqe_id, enum exynos_histogram_id hist_id, enum hi
 	if (hist_id >= HISTOGRAM_MAX)
 		return;
 
-	if (regs_dqe[dqe_id].desc.write_protected) {
+	if (dqe_regs_desc(dqe_id)->write_protected) {
 		cal_log_debug(0, "%s: ignored in protected status\n", __func__);
 		return;
 	}
@@ -922,3 +911,7 @@ void dqe_reg_set_rcd_en_internal(u32 dqe_id, bool en)
 {
 	dqe_write(dqe_id, DQE_RCD, DQE_RCD_EN(en ? 1 : 0));
 }
+
+#if IS_ENABLED(CONFIG_DRM_SAMSUNG_CAL_KUNIT_TEST)
+#include "dqe_reg_test.c"
+#endif
@@ -0,0 +1,280 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * cal_9865/dqe_reg_test.c
+ *
+ * Copyright (c) 2023 Samsung Electronics Co., Ltd.
+ *		http://www.samsung.com
+ *
+ * KUnit tests pinning the register streams written by the dqe_reg_set_*
+ * functions and the write counts of the LUT updates. Included from
+ * dqe_reg.c.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <kunit/test.h>
+#include <linux/sizes.h>
+
+#include <cal_fake_mmio.h>
+
+#define DQE_REG_TEST_ID		REGS_DQE0_ID
+#define DQE_REG_TEST_LOG_CAP	256
+
+/* block offsets follow the version set at probe, 0 while not probed */
+#define dqe_test_version		regs_dqe[DQE_REG_TEST_ID].version
+#define DQE_TEST_DEGAMMA(reg)	((reg) + degamma_offset(dqe_test_version))
+#define DQE_TEST_REGAMMA(reg)	((reg) + regamma_offset(dqe_test_version))
+
+/* 33 POSX entries followed by 33 POSY entries */
+#define DQE_TEST_LUT_LEN	(DQE_DEGAMMALUT_POS_SIZE * 2)
+
+struct dqe_reg_test_ctx {
+	struct cal_fake_mmio fake;
+	struct cal_fake_mmio cgc_fake;
+	struct drm_color_lut lut[DQE_TEST_LUT_LEN];
+};
+
+/* off-diagonal coefficients all differ to catch swapped halves */
+static const struct exynos_matrix dqe_test_matrix = {
+	.coeffs = {
+		0x400, 0x001, 0x002,
+		0x003, 0x400, 0x005,
+		0x006, 0x007, 0x400,
+	},
+	.offsets = { 0x010, 0x020, 0x030 },
+};
+
+/* goldens of the matrix and dither blocks, offsets relative to the block */
+static const struct cal_fake_mmio_write dqe_test_linear_matrix_golden[] = {
+	{ DQE_LINEAR_MATRIX_COEFF0,	0x00010400 },
+	{ DQE_LINEAR_MATRIX_COEFF1,	0x00030002 },
+	{ DQE_LINEAR_MATRIX_COEFF2,	0x00050400 },
+	{ DQE_LINEAR_MATRIX_COEFF3,	0x00070006 },
+	{ DQE_LINEAR_MATRIX_COEFF4,	0x00000400 },
+	{ DQE_LINEAR_MATRIX_OFFSET0,	0x00200010 },
+	{ DQE_LINEAR_MATRIX_OFFSET1,	0x00000030 },
+	{ DQE_LINEAR_MATRIX_CON,	0x00000001 },
+};
+
+static const struct cal_fake_mmio_write dqe_test_gamma_matrix_golden[] = {
+	{ DQE_GAMMA_MATRIX_COEFF0,	0x00010400 },
+	{ DQE_GAMMA_MATRIX_COEFF1,	0x00030002 },
+	{ DQE_GAMMA_MATRIX_COEFF2,	0x00050400 },
+	{ DQE_GAMMA_MATRIX_COEFF3,	0x00070006 },
+	{ DQE_GAMMA_MATRIX_COEFF4,	0x00000400 },
+	{ DQE_GAMMA_MATRIX_OFFSET0,	0x00200010 },
+	{ DQE_GAMMA_MATRIX_OFFSET1,	0x00000030 },
+	{ DQE_GAMMA_MATRIX_CON,	0x00000001 },
+};
+
+static const struct cal_fake_mmio_write dqe_test_matrix_off_golden[] = {
+	{ DQE_LINEAR_MATRIX_CON,	0x00000000 },
+	{ DQE_GAMMA_MATRIX_CON,	0x00000000 },
+};
+
+/* enabled, frame control with offset 2, table B on red */
+static const struct dither_config dqe_test_dither = {
+	.en = 1,
+	.frame_con = 1,
+	.frame_offset = 2,
+	.table_sel_r = 1,
+};
+
+static const struct cal_fake_mmio_write dqe_test_dither_golden[] = {
+	{ DQE_CGC_DITHER,	0x00000035 },
+	{ DQE_DISP_DITHER,	0x00000035 },
+	{ DQE_CGC_DITHER,	0x00000000 },
+	{ DQE_DISP_DITHER,	0x00000000 },
+};
+
+/* FHD+ panel, no partial update */
+static const struct cal_fake_mmio_write dqe_test_size_golden[] = {
+	{ DQE_TOP_IMG_SIZE,		0x09600438 },
+	{ DQE_TOP_FRM_SIZE,		0x09600438 },
+	{ DQE_TOP_FRM_PXL_NUM,		0x00278d00 },
+	{ DQE_TOP_PARTIAL_START,	0x00000000 },
+	{ DQE_TOP_PARTIAL_CON,		0x00000000 },
+};
+
+/* POSX and POSY of the degamma, per channel for the regamma, plus CON */
+#define DQE_TEST_DEGAMMA_WRITES	(DQE_DEGAMMALUT_REG_CNT * 2 + 1)
+#define DQE_TEST_REGAMMA_WRITES	(DQE_REGAMMALUT_REG_CNT * 2 * 3 + 1)
+
+/* three LUT registers per entry, then CGC_EN and the shadow update */
+#define DQE_TEST_CGC_WRITES	(DRM_SAMSUNG_CGC_LUT_REG_CNT * 3 + 2)
+
+static void dqe_reg_test_expect_block(struct kunit *test,
+		const struct cal_fake_mmio *fake, u32 block_offset,
+		const struct cal_fake_mmio_write *golden, size_t len)
+{
+	struct cal_fake_mmio_write *rebased;
+	size_t i;
+
+	rebased = kunit_kmalloc_array(test, len, sizeof(*rebased), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, rebased);
+	for (i = 0; i < len; i++) {
+		rebased[i].offset = golden[i].offset + block_offset;
+		rebased[i].val = golden[i].val;
+	}
+
+	cal_fake_mmio_expect_log(test, fake, rebased, len);
+}
+
+static void dqe_reg_test_matrix(struct kunit *test)
+{
+	struct dqe_reg_test_ctx *ctx = test->priv;
+
+	dqe_reg_set_linear_matrix(DQE_REG_TEST_ID, &dqe_test_matrix);
+	dqe_reg_test_expect_block(test, &ctx->fake,
+			matrix_offset(dqe_test_version),
+			dqe_test_linear_matrix_golden,
+			ARRAY_SIZE(dqe_test_linear_matrix_golden));
+
+	cal_fake_mmio_clear_log(&ctx->fake);
+	dqe_reg_set_gamma_matrix(DQE_REG_TEST_ID, &dqe_test_matrix);
+	dqe_reg_test_expect_block(test, &ctx->fake,
+			matrix_offset(dqe_test_version),
+			dqe_test_gamma_matrix_golden,
+			ARRAY_SIZE(dqe_test_gamma_matrix_golden));
+
+	cal_fake_mmio_clear_log(&ctx->fake);
+	dqe_reg_set_linear_matrix(DQE_REG_TEST_ID, NULL);
+	dqe_reg_set_gamma_matrix(DQE_REG_TEST_ID, NULL);
+	dqe_reg_test_expect_block(test, &ctx->fake,
+			matrix_offset(dqe_test_version),
+			dqe_test_matrix_off_golden,
+			ARRAY_SIZE(dqe_test_matrix_off_golden));
+}
+
+static void dqe_reg_test_dither(struct kunit *test)
+{
+	struct dqe_reg_test_ctx *ctx = test->priv;
+	struct dither_config config = dqe_test_dither;
+
+	dqe_reg_set_cgc_dither(DQE_REG_TEST_ID, &config);
+	dqe_reg_set_disp_dither(DQE_REG_TEST_ID, &config);
+	dqe_reg_set_cgc_dither(DQE_REG_TEST_ID, NULL);
+	dqe_reg_set_disp_dither(DQE_REG_TEST_ID, NULL);
+	dqe_reg_test_expect_block(test, &ctx->fake,
+			dither_offset(dqe_test_version), dqe_test_dither_golden,
+			ARRAY_SIZE(dqe_test_dither_golden));
+}
+
+static void dqe_reg_test_size(struct kunit *test)
+{
+	struct dqe_reg_test_ctx *ctx = test->priv;
+
+	dqe_reg_set_size(DQE_REG_TEST_ID, 1080, 2400);
+	cal_fake_mmio_expect_log(test, &ctx->fake, dqe_test_size_golden,
+			ARRAY_SIZE(dqe_test_size_golden));
+}
+
+static void dqe_reg_test_gamma_lut(struct kunit *test)
+{
+	struct dqe_reg_test_ctx *ctx = test->priv;
+
+	dqe_reg_set_degamma_lut(DQE_REG_TEST_ID, ctx->lut);
+	KUNIT_EXPECT_EQ(test, ctx->fake.write_cnt, DQE_TEST_DEGAMMA_WRITES);
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(&ctx->fake,
+			DQE_TEST_DEGAMMA(DQE_DEGAMMA_POSX(0))), 0x00010000);
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(&ctx->fake,
+			DQE_TEST_DEGAMMA(DQE_DEGAMMA_POSY(16))), 0x00000041);
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(&ctx->fake,
+			DQE_TEST_DEGAMMA(DQE_DEGAMMA_CON)), DEGAMMA_EN(1));
+
+	cal_fake_mmio_clear_log(&ctx->fake);
+	dqe_reg_set_regamma_lut(DQE_REG_TEST_ID, 0, ctx->lut);
+	KUNIT_EXPECT_EQ(test, ctx->fake.write_cnt, DQE_TEST_REGAMMA_WRITES);
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(&ctx->fake,
+			DQE_TEST_REGAMMA(DQE_REGAMMA_B_POSY(0, 0))), 0x00240023);
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(&ctx->fake,
+			DQE_TEST_REGAMMA(DQE_REGAMMA_BASE(0))), REGAMMA_EN);
+
+	cal_fake_mmio_clear_log(&ctx->fake);
+	dqe_reg_set_degamma_lut(DQE_REG_TEST_ID, NULL);
+	dqe_reg_set_regamma_lut(DQE_REG_TEST_ID, 0, NULL);
+	KUNIT_EXPECT_EQ(test, ctx->fake.write_cnt, 2);
+}
+
+static void dqe_reg_test_cgc_lut(struct kunit *test)
+{
+	struct dqe_reg_test_ctx *ctx = test->priv;
+	struct cgc_lut *lut;
+
+	lut = kunit_kzalloc(test, sizeof(*lut), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, lut);
+	lut->b_values[DRM_SAMSUNG_CGC_LUT_REG_CNT - 1] = 0xabc;
+
+	dqe_reg_set_cgc_lut(DQE_REG_TEST_ID, lut);
+	KUNIT_EXPECT_EQ(test, ctx->cgc_fake.write_cnt, DQE_TEST_CGC_WRITES);
+	KUNIT_EXPECT_EQ(test, ctx->fake.write_cnt, 0);
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(&ctx->cgc_fake,
+			DQE_CGC_LUT_B(DRM_SAMSUNG_CGC_LUT_REG_CNT - 1)), 0xabc);
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(&ctx->cgc_fake, DQE_CGC_CON),
+			CGC_EN_MASK | CGC0_COEF_SHD_UP_EN_MASK);
+
+	cal_fake_mmio_clear_log(&ctx->cgc_fake);
+	dqe_reg_set_cgc_lut(DQE_REG_TEST_ID, NULL);
+	KUNIT_EXPECT_EQ(test, ctx->cgc_fake.write_cnt, 1);
+	KUNIT_EXPECT_EQ(test, cal_fake_mmio_peek(&ctx->cgc_fake, DQE_CGC_CON),
+			CGC0_COEF_SHD_UP_EN_MASK);
+}
+
+static int dqe_reg_test_init(struct kunit *test)
+{
+	struct dqe_reg_test_ctx *ctx;
+	int i, ret;
+
+	ctx = kunit_kzalloc(test, sizeof(*ctx), GFP_KERNEL);
+	if (!ctx)
+		return -ENOMEM;
+
+	ret = cal_fake_mmio_attach(&regs_dqe[DQE_REG_TEST_ID].desc, &ctx->fake,
+			SZ_64K, DQE_REG_TEST_LOG_CAP);
+	if (ret)
+		return ret;
+
+	ret = cal_fake_mmio_attach(&regs_dqe_cgc[DQE_REG_TEST_ID].desc,
+			&ctx->cgc_fake, SZ_64K, DQE_REG_TEST_LOG_CAP);
+	if (ret) {
+		cal_fake_mmio_detach(&regs_dqe[DQE_REG_TEST_ID].desc);
+		return ret;
+	}
+
+	/* linear ramp, POSX in the red channel and POSY one step above it */
+	for (i = 0; i < DQE_TEST_LUT_LEN; i++) {
+		ctx->lut[i].red = i;
+		ctx->lut[i].green = i + 1;
+		ctx->lut[i].blue = i + 2;
+	}
+
+	test->priv = ctx;
+
+	return 0;
+}
+
+static void dqe_reg_test_exit(struct kunit *test)
+{
+	cal_fake_mmio_detach(&regs_dqe_cgc[DQE_REG_TEST_ID].desc);
+	cal_fake_mmio_detach(&regs_dqe[DQE_REG_TEST_ID].desc);
+}
+
+static struct kunit_case dqe_reg_test_cases[] = {
+	KUNIT_CASE(dqe_reg_test_matrix),
+	KUNIT_CASE(dqe_reg_test_dither),
+	KUNIT_CASE(dqe_reg_test_size),
+	KUNIT_CASE(dqe_reg_test_gamma_lut),
+	KUNIT_CASE(dqe_reg_test_cgc_lut),
+	{}
+};
+
+static struct kunit_suite dqe_reg_test_suite = {
+	.name = "exynos-drm-dqe-reg",
+	.init = dqe_reg_test_init,
+	.exit = dqe_reg_test_exit,
+	.test_cases = dqe_reg_test_cases,
+};
+
+kunit_test_suite(dqe_reg_test_suite);
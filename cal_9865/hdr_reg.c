@@ -238,6 +238,23 @@ static void hdr_reg_print(u32 id, u32 start, u32 count, enum elem_size size,
 		cal_drm_printf(pr, id, "%s\n", buf);
 }
 
+void hdr_reg_enable_lut(u32 id, enum hdr_lut_type type)
+{
+	static const u32 en_mask[HDR_LUT_MAX] = {
+		[HDR_LUT_EOTF] = EOTF_EN_MASK,
+		[HDR_LUT_OETF] = OETF_EN_MASK,
+		[HDR_LUT_GM] = GM_EN_MASK,
+		[HDR_LUT_TM] = TM_EN_MASK,
+	};
+
+	if (type >= HDR_LUT_MAX)
+		return;
+
+	/* EOTF_LUT_EN is left as programmed together with the curve */
+	hdr_write_mask(id, HDR_HDR_CON, ~0, en_mask[type]);
+	cal_log_debug(id, "%s: type(%d)\n", __func__, type);
+}
+
 void hdr_reg_print_eotf_lut(u32 id, struct drm_printer *p)
 {
 	u32 val;
@@ -61,13 +61,73 @@ enum elem_size {
 	ELEM_SIZE_32 = 32,
 };
 
+struct cal_regs_desc;
+
+/*
+ * Register access backend replacing MMIO, e.g. memory backed registers
+ * recording write sequences. See cal_fake_mmio.h.
+ */
+struct cal_regs_ops {
+	uint32_t (*read)(struct cal_regs_desc *regs_desc, uint32_t offset);
+	void (*write)(struct cal_regs_desc *regs_desc, uint32_t offset,
+			uint32_t val);
+};
+
 struct cal_regs_desc {
 	const char *name;
 	void __iomem *regs;
 	volatile bool write_protected;
 	phys_addr_t start;
+#ifdef CONFIG_DRM_SAMSUNG_CAL_FAKE_MMIO
+	const struct cal_regs_ops *ops;
+	void *priv;
+#endif
 };
 
+#ifdef CONFIG_DRM_SAMSUNG_CAL_FAKE_MMIO
+static inline bool cal_ops_read(struct cal_regs_desc *regs_desc,
+		uint32_t offset, uint32_t *val)
+{
+	if (likely(!regs_desc->ops))
+		return false;
+
+	*val = regs_desc->ops->read(regs_desc, offset);
+	return true;
+}
+
+static inline bool cal_ops_write(struct cal_regs_desc *regs_desc,
+		uint32_t offset, uint32_t val)
+{
+	if (likely(!regs_desc->ops))
+		return false;
+
+	regs_desc->ops->write(regs_desc, offset, val);
+	return true;
+}
+
+/*
+ * Fake backends are attached to private copies of a descriptor owned by the
+ * attaching test, so lookups of the calling context resolve to those while
+ * every other context keeps the live descriptor.
+ */
+struct cal_regs_desc *cal_fake_mmio_resolve(struct cal_regs_desc *regs_desc);
+#define cal_regs_desc_get(regs_desc)	cal_fake_mmio_resolve(regs_desc)
+#else
+#define cal_regs_desc_get(regs_desc)	(regs_desc)
+
+static inline bool cal_ops_read(struct cal_regs_desc *regs_desc,
+		uint32_t offset, uint32_t *val)
+{
+	return false;
+}
+
+static inline bool cal_ops_write(struct cal_regs_desc *regs_desc,
+		uint32_t offset, uint32_t val)
+{
+	return false;
+}
+#endif
+
 /* common function macro for register control file */
 /* to get cal_regs_desc */
 #define cal_regs_desc_check(type, id, type_max, id_max)		\
@@ -86,12 +146,20 @@ struct cal_regs_desc {
 static inline uint32_t cal_read(struct cal_regs_desc *regs_desc,
 		uint32_t offset)
 {
+	uint32_t val;
+
+	if (cal_ops_read(regs_desc, offset, &val))
+		return val;
+
 	return readl(regs_desc->regs + offset);
 }
 
 static inline void cal_write(struct cal_regs_desc *regs_desc,
 		uint32_t offset, uint32_t val)
 {
+	if (cal_ops_write(regs_desc, offset, val))
+		return;
+
 	if (unlikely(regs_desc->write_protected)) {
 		int ret = set_priv_reg(regs_desc->start + offset, val);
 		if (ret)
@@ -105,12 +173,20 @@ static inline void cal_write(struct cal_regs_desc *regs_desc,
 static inline uint32_t cal_read_relaxed(struct cal_regs_desc *regs_desc,
 		uint32_t offset)
 {
+	uint32_t val;
+
+	if (cal_ops_read(regs_desc, offset, &val))
+		return val;
+
 	return readl_relaxed(regs_desc->regs + offset);
 }
 
 static inline void cal_write_relaxed(struct cal_regs_desc *regs_desc,
 		uint32_t offset, uint32_t val)
 {
+	if (cal_ops_write(regs_desc, offset, val))
+		return;
+
 	if (unlikely(regs_desc->write_protected)) {
 		int ret = set_priv_reg(regs_desc->start + offset, val);
 		if (ret)
@@ -145,20 +221,16 @@ static inline void cal_write_mask(struct cal_regs_desc *regs_desc,
  * one data point. For example, packs a data array of 20 points into 10
  * registers, or 21 points into 11 registers.
  *
- * Note that the mask parameters are assumed to be pre-shifted within a u32
- * word by the caller. Low/high shift values for lut parameter are calculated
- * based on the first set bit in the corresponding masks.
+ * Consecutive points are @stride u16 elements apart, which lets a single
+ * channel be packed straight out of an interleaved array such as
+ * struct drm_color_lut without copying it out first.
  *
- * @lut: Array of points
- * @lut_len: The length of the array of points
- * @low_mask: Shifted register field mask for the first point in a register
- * @hi_mask: Shifted register field mask for the second point in a register
- * @regs: Output array of register values
- * @regs_len: Length of the output array fo register values
+ * Always inlined so that the masks, which are register field constants at
+ * every call site, fold into immediate shifts for each layout.
  */
-static inline int cal_pack_lut_into_reg_pairs(const uint16_t *lut,
-		const size_t lut_len, const uint32_t low_mask, const uint32_t hi_mask,
-		uint32_t *regs, const size_t regs_len)
+static __always_inline int __cal_pack_lut_strided(const uint16_t *lut,
+		const size_t stride, const size_t lut_len, const uint32_t low_mask,
+		const uint32_t hi_mask, uint32_t *regs, const size_t regs_len)
 {
 	int i;
 	uint8_t low_shift;
@@ -177,16 +249,51 @@ static inline int cal_pack_lut_into_reg_pairs(const uint16_t *lut,
 	low_shift = ffs(low_mask) - 1;
 	hi_shift = ffs(hi_mask) - 1;
 	for (i = 0; i < lut_len / 2; i++) {
-		regs[i] = (*(lp++) << low_shift) & low_mask;
-		regs[i] |= (*(lp++) << hi_shift) & hi_mask;
+		regs[i] = ((uint32_t)lp[0] << low_shift) & low_mask;
+		regs[i] |= ((uint32_t)lp[stride] << hi_shift) & hi_mask;
+		lp += 2 * stride;
 	}
 
 	if (i < regs_len)
-		regs[i] = ((*lp) << low_shift) & low_mask;
+		regs[i] = ((uint32_t)lp[0] << low_shift) & low_mask;
 
 	return 0;
 }
 
+/*
+ * Packs an array of data points into register pairs, see
+ * __cal_pack_lut_strided().
+ *
+ * Note that the mask parameters are assumed to be pre-shifted within a u32
+ * word by the caller. Low/high shift values for lut parameter are calculated
+ * based on the first set bit in the corresponding masks.
+ *
+ * @lut: Array of points
+ * @lut_len: The length of the array of points
+ * @low_mask: Shifted register field mask for the first point in a register
+ * @hi_mask: Shifted register field mask for the second point in a register
+ * @regs: Output array of register values
+ * @regs_len: Length of the output array fo register values
+ */
+static __always_inline int cal_pack_lut_into_reg_pairs(const uint16_t *lut,
+		const size_t lut_len, const uint32_t low_mask, const uint32_t hi_mask,
+		uint32_t *regs, const size_t regs_len)
+{
+	return __cal_pack_lut_strided(lut, 1, lut_len, low_mask, hi_mask,
+			regs, regs_len);
+}
+
+/*
+ * Same as cal_pack_lut_into_reg_pairs() but takes the points from member
+ * @chan of each element of the struct array @lut (e.g. the red channel of a
+ * struct drm_color_lut array).
+ */
+#define cal_pack_color_lut_into_reg_pairs(lut, chan, lut_len, low_mask,	\
+		hi_mask, regs, regs_len)				\
+	__cal_pack_lut_strided(&(lut)->chan,				\
+			sizeof(*(lut)) / sizeof(uint16_t), lut_len,	\
+			low_mask, hi_mask, regs, regs_len)
+
 static inline void cal_set_write_protected(struct cal_regs_desc *regs_desc,
 				     bool protected)
 {
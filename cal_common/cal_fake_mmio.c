@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Samsung Electronics Co., Ltd.
+ *		http://www.samsung.com
+ *
+ * Memory backed register backend for CAL.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <linux/atomic.h>
+#include <linux/export.h>
+#include <linux/preempt.h>
+#include <linux/sched.h>
+#include <linux/slab.h>
+#include <linux/spinlock.h>
+#include <drm/drm_print.h>
+
+#include "cal_fake_mmio.h"
+
+static LIST_HEAD(cal_fake_mmio_list);
+static DEFINE_SPINLOCK(cal_fake_mmio_lock);
+static atomic_t cal_fake_mmio_cnt = ATOMIC_INIT(0);
+
+/*
+ * init, case and exit of one KUnit test may run on different kthreads, all of
+ * them carry the test in current->kunit_test.
+ */
+static void *cal_fake_mmio_owner(void)
+{
+#if IS_ENABLED(CONFIG_KUNIT)
+	if (current->kunit_test)
+		return current->kunit_test;
+#endif
+	return current;
+}
+
+/*
+ * Matches the live descriptor as well as the private one, which the lookup
+ * macros return to the owner once attached. Called with cal_fake_mmio_lock
+ * held.
+ */
+static struct cal_fake_mmio *cal_fake_mmio_find(const struct cal_regs_desc *desc,
+		const void *owner)
+{
+	struct cal_fake_mmio *fake;
+
+	list_for_each_entry(fake, &cal_fake_mmio_list, node)
+		if ((fake->live == desc || &fake->desc == desc) &&
+				fake->owner == owner)
+			return fake;
+
+	return NULL;
+}
+
+/**
+ * cal_fake_mmio_resolve - descriptor to use for @regs_desc in this context
+ * @regs_desc: live register descriptor
+ *
+ * Return: private descriptor of a fake attached to @regs_desc by the caller,
+ * @regs_desc itself otherwise
+ */
+struct cal_regs_desc *cal_fake_mmio_resolve(struct cal_regs_desc *regs_desc)
+{
+	struct cal_fake_mmio *fake;
+	unsigned long flags;
+
+	/* irq handlers of probed devices may interrupt a test on its cpu */
+	if (likely(!atomic_read(&cal_fake_mmio_cnt)) || !in_task())
+		return regs_desc;
+
+	spin_lock_irqsave(&cal_fake_mmio_lock, flags);
+	fake = cal_fake_mmio_find(regs_desc, cal_fake_mmio_owner());
+	spin_unlock_irqrestore(&cal_fake_mmio_lock, flags);
+
+	/* only the owner detaches, so the fake outlives its use here */
+	return fake ? &fake->desc : regs_desc;
+}
+EXPORT_SYMBOL_GPL(cal_fake_mmio_resolve);
+
+static inline bool cal_fake_mmio_valid(const struct cal_fake_mmio *fake,
+		uint32_t offset)
+{
+	return !(offset & (sizeof(uint32_t) - 1)) &&
+		offset + sizeof(uint32_t) <= fake->size;
+}
+
+static uint32_t cal_fake_mmio_read(struct cal_regs_desc *regs_desc,
+		uint32_t offset)
+{
+	struct cal_fake_mmio *fake = regs_desc->priv;
+
+	if (WARN_ONCE(!cal_fake_mmio_valid(fake, offset),
+			"%s: invalid read offset 0x%x\n", regs_desc->name, offset))
+		return 0;
+
+	fake->read_cnt++;
+
+	return fake->mem[offset / sizeof(uint32_t)];
+}
+
+static void cal_fake_mmio_write(struct cal_regs_desc *regs_desc,
+		uint32_t offset, uint32_t val)
+{
+	struct cal_fake_mmio *fake = regs_desc->priv;
+
+	if (WARN_ONCE(!cal_fake_mmio_valid(fake, offset),
+			"%s: invalid write offset 0x%x\n", regs_desc->name, offset))
+		return;
+
+	fake->mem[offset / sizeof(uint32_t)] = val;
+	fake->write_cnt++;
+
+	if (fake->log_len < fake->log_cap) {
+		fake->log[fake->log_len].offset = offset;
+		fake->log[fake->log_len].val = val;
+		fake->log_len++;
+	} else {
+		fake->log_overflow = true;
+	}
+}
+
+static const struct cal_regs_ops cal_fake_mmio_ops = {
+	.read = cal_fake_mmio_read,
+	.write = cal_fake_mmio_write,
+};
+
+/**
+ * cal_fake_mmio_attach - redirect register access of @regs_desc to memory
+ * @regs_desc: live register descriptor
+ * @fake: fake backend state, owned by caller
+ * @size: size of register space in bytes
+ * @log_cap: number of writes to record, 0 to only count them
+ *
+ * @regs_desc is left untouched. Register lookups of the calling KUnit test
+ * resolve to a private copy backed by @fake instead, while probed devices
+ * keep using the live descriptor. Register image starts zeroed. regs of the
+ * copy points at the image, so that readl_poll_timeout based waits see
+ * values preset by cal_fake_mmio_poke().
+ *
+ * Return: 0 on success, negative error code otherwise
+ */
+int cal_fake_mmio_attach(struct cal_regs_desc *regs_desc,
+		struct cal_fake_mmio *fake, size_t size, size_t log_cap)
+{
+	unsigned long flags;
+	int ret = 0;
+
+	if (!regs_desc || !fake || !size)
+		return -EINVAL;
+
+	memset(fake, 0, sizeof(*fake));
+
+	fake->mem = kzalloc(ALIGN(size, sizeof(uint32_t)), GFP_KERNEL);
+	if (!fake->mem)
+		return -ENOMEM;
+
+	if (log_cap) {
+		fake->log = kcalloc(log_cap, sizeof(*fake->log), GFP_KERNEL);
+		if (!fake->log) {
+			kfree(fake->mem);
+			fake->mem = NULL;
+			return -ENOMEM;
+		}
+	}
+
+	fake->size = size;
+	fake->log_cap = log_cap;
+	fake->live = regs_desc;
+	fake->owner = cal_fake_mmio_owner();
+
+	fake->desc.name = regs_desc->name;
+	fake->desc.start = regs_desc->start;
+	fake->desc.regs = (void __iomem __force *)fake->mem;
+	fake->desc.priv = fake;
+	fake->desc.ops = &cal_fake_mmio_ops;
+
+	spin_lock_irqsave(&cal_fake_mmio_lock, flags);
+	if (cal_fake_mmio_find(regs_desc, fake->owner)) {
+		ret = -EBUSY;
+	} else {
+		list_add(&fake->node, &cal_fake_mmio_list);
+		atomic_inc(&cal_fake_mmio_cnt);
+	}
+	spin_unlock_irqrestore(&cal_fake_mmio_lock, flags);
+
+	if (ret) {
+		kfree(fake->log);
+		kfree(fake->mem);
+		fake->log = NULL;
+		fake->mem = NULL;
+	}
+
+	return ret;
+}
+EXPORT_SYMBOL_GPL(cal_fake_mmio_attach);
+
+void cal_fake_mmio_detach(struct cal_regs_desc *regs_desc)
+{
+	struct cal_fake_mmio *fake;
+	unsigned long flags;
+
+	spin_lock_irqsave(&cal_fake_mmio_lock, flags);
+	fake = cal_fake_mmio_find(regs_desc, cal_fake_mmio_owner());
+	if (fake) {
+		list_del(&fake->node);
+		atomic_dec(&cal_fake_mmio_cnt);
+	}
+	spin_unlock_irqrestore(&cal_fake_mmio_lock, flags);
+
+	if (!fake)
+		return;
+
+	kfree(fake->log);
+	kfree(fake->mem);
+	fake->log = NULL;
+	fake->mem = NULL;
+}
+EXPORT_SYMBOL_GPL(cal_fake_mmio_detach);
+
+/* start a new recording, register image is kept */
+void cal_fake_mmio_clear_log(struct cal_fake_mmio *fake)
+{
+	fake->log_len = 0;
+	fake->log_overflow = false;
+	fake->read_cnt = 0;
+	fake->write_cnt = 0;
+}
+EXPORT_SYMBOL_GPL(cal_fake_mmio_clear_log);
+
+bool cal_fake_mmio_log_equal(const struct cal_fake_mmio *fake,
+		const struct cal_fake_mmio_write *golden, size_t len)
+{
+	if (fake->log_overflow || fake->log_len != len)
+		return false;
+
+	return !memcmp(fake->log, golden, len * sizeof(*golden));
+}
+EXPORT_SYMBOL_GPL(cal_fake_mmio_log_equal);
+
+void cal_fake_mmio_dump_log(const struct cal_fake_mmio *fake,
+		struct drm_printer *p)
+{
+	size_t i;
+
+	drm_printf(p, "writes: %u (recorded %zu%s), reads: %u\n",
+			fake->write_cnt, fake->log_len,
+			fake->log_overflow ? ", overflow" : "", fake->read_cnt);
+
+	for (i = 0; i < fake->log_len; i++)
+		drm_printf(p, "[%4zu] 0x%04x <- 0x%08x\n", i,
+				fake->log[i].offset, fake->log[i].val);
+}
+EXPORT_SYMBOL_GPL(cal_fake_mmio_dump_log);
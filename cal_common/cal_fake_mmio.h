@@ -0,0 +1,111 @@
+/* SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Copyright (c) 2023 Samsung Electronics Co., Ltd.
+ *		http://www.samsung.com
+ *
+ * Memory backed register backend for CAL, used to run register programming
+ * without hardware (KUnit/UML) and to record the resulting write streams.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#ifndef __CAL_FAKE_MMIO_H__
+#define __CAL_FAKE_MMIO_H__
+
+#include <linux/list.h>
+#include <cal_config.h>
+
+struct drm_printer;
+
+struct cal_fake_mmio_write {
+	uint32_t offset;
+	uint32_t val;
+};
+
+/**
+ * struct cal_fake_mmio - memory backed registers of one cal_regs_desc
+ * @mem: register image, also used as regs for readl_poll_timeout users
+ * @size: size of register image in bytes
+ * @log: recorded writes in issue order
+ * @log_cap: max number of recorded writes
+ * @log_len: number of recorded writes
+ * @log_overflow: writes were dropped from log because it was full
+ * @read_cnt: number of reads since last clear
+ * @write_cnt: number of writes since last clear, including dropped ones
+ * @desc: private descriptor standing in for @live, seen by @owner only
+ * @live: descriptor the fake was attached to, never modified
+ * @owner: KUnit test (or task outside KUnit) which attached the fake
+ * @node: entry in the list of attached fakes
+ */
+struct cal_fake_mmio {
+	uint32_t *mem;
+	size_t size;
+	struct cal_fake_mmio_write *log;
+	size_t log_cap;
+	size_t log_len;
+	bool log_overflow;
+	uint32_t read_cnt;
+	uint32_t write_cnt;
+
+	struct cal_regs_desc desc;
+	struct cal_regs_desc *live;
+	void *owner;
+	struct list_head node;
+};
+
+#ifdef CONFIG_DRM_SAMSUNG_CAL_FAKE_MMIO
+int cal_fake_mmio_attach(struct cal_regs_desc *regs_desc,
+		struct cal_fake_mmio *fake, size_t size, size_t log_cap);
+void cal_fake_mmio_detach(struct cal_regs_desc *regs_desc);
+void cal_fake_mmio_clear_log(struct cal_fake_mmio *fake);
+bool cal_fake_mmio_log_equal(const struct cal_fake_mmio *fake,
+		const struct cal_fake_mmio_write *golden, size_t len);
+void cal_fake_mmio_dump_log(const struct cal_fake_mmio *fake,
+		struct drm_printer *p);
+
+/* preset register value without recording it, e.g. status bits being polled */
+static inline void cal_fake_mmio_poke(struct cal_fake_mmio *fake,
+		uint32_t offset, uint32_t val)
+{
+	if (!WARN_ON(offset + sizeof(uint32_t) > fake->size))
+		fake->mem[offset / sizeof(uint32_t)] = val;
+}
+
+static inline uint32_t cal_fake_mmio_peek(const struct cal_fake_mmio *fake,
+		uint32_t offset)
+{
+	if (WARN_ON(offset + sizeof(uint32_t) > fake->size))
+		return 0;
+
+	return fake->mem[offset / sizeof(uint32_t)];
+}
+#endif
+
+#if IS_ENABLED(CONFIG_DRM_SAMSUNG_CAL_KUNIT_TEST)
+#include <kunit/test.h>
+
+/* expect the recorded writes to match @golden, reporting the first misses */
+static inline void cal_fake_mmio_expect_log(struct kunit *test,
+		const struct cal_fake_mmio *fake,
+		const struct cal_fake_mmio_write *golden, size_t len)
+{
+	size_t i;
+
+	if (cal_fake_mmio_log_equal(fake, golden, len))
+		return;
+
+	KUNIT_ASSERT_FALSE(test, fake->log_overflow);
+	KUNIT_EXPECT_EQ(test, fake->log_len, len);
+	for (i = 0; i < min(fake->log_len, len); i++) {
+		KUNIT_EXPECT_EQ_MSG(test, fake->log[i].offset, golden[i].offset,
+				"%s write %zu", fake->desc.name, i);
+		KUNIT_EXPECT_EQ_MSG(test, fake->log[i].val, golden[i].val,
+				"%s write %zu to 0x%04x", fake->desc.name, i,
+				golden[i].offset);
+	}
+}
+#endif
+
+#endif /* __CAL_FAKE_MMIO_H__ */
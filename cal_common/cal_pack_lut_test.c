@@ -0,0 +1,257 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Samsung Electronics Co., Ltd.
+ *		http://www.samsung.com
+ *
+ * KUnit tests for the CAL LUT packing helpers.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <kunit/test.h>
+#include <drm/drm_mode.h>
+#include <linux/ktime.h>
+
+#include <cal_config.h>
+
+#define CAL_PACK_TEST_MAX_LEN	66
+#define CAL_PACK_TEST_LOOPS	10000
+
+struct cal_pack_test_layout {
+	uint32_t low_mask;
+	uint32_t hi_mask;
+};
+
+static const struct cal_pack_test_layout cal_pack_test_layouts[] = {
+	/* DQE degamma/regamma */
+	{ 0x1FFF << 0, 0x1FFF << 16 },
+	{ 0x3FF << 0, 0x3FF << 16 },
+	/* fields not starting at bit 0, points wider than their fields */
+	{ 0xFFF << 2, 0xFFF << 18 },
+	{ 0x7F << 4, 0x1FF << 20 },
+};
+
+static const size_t cal_pack_test_lens[] = { 1, 2, 33, 65, 66 };
+
+/* fill all channels with distinct values using all 16 bits */
+static void cal_pack_test_fill(struct drm_color_lut *lut, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		lut[i].red = (i * 0x9E37 + 0x1234) & 0xFFFF;
+		lut[i].green = (i * 0x7F4B + 0x8001) & 0xFFFF;
+		lut[i].blue = (i * 0x3C6F + 0xFFFF) & 0xFFFF;
+		lut[i].reserved = 0xA5A5;
+	}
+}
+
+/* pack a copy of the channel with the contiguous helper and compare */
+static void cal_pack_test_expect_channel(struct kunit *test,
+		const uint16_t *chan, size_t len,
+		const struct cal_pack_test_layout *layout,
+		const uint32_t *strided_regs)
+{
+	uint32_t regs[DIV_ROUND_UP(CAL_PACK_TEST_MAX_LEN, 2)];
+	const size_t regs_len = DIV_ROUND_UP(len, 2);
+
+	memset(regs, 0, sizeof(regs));
+	KUNIT_ASSERT_EQ(test, cal_pack_lut_into_reg_pairs(chan, len,
+			layout->low_mask, layout->hi_mask, regs, regs_len), 0);
+	KUNIT_EXPECT_EQ(test, memcmp(regs, strided_regs,
+			regs_len * sizeof(*regs)), 0);
+}
+
+static void cal_pack_test_color_lut(struct kunit *test)
+{
+	struct drm_color_lut lut[CAL_PACK_TEST_MAX_LEN];
+	uint16_t chan[CAL_PACK_TEST_MAX_LEN];
+	uint32_t regs[DIV_ROUND_UP(CAL_PACK_TEST_MAX_LEN, 2)];
+	const struct cal_pack_test_layout *layout;
+	size_t regs_len, len, k;
+	int i, j;
+
+	cal_pack_test_fill(lut, ARRAY_SIZE(lut));
+
+	for (i = 0; i < ARRAY_SIZE(cal_pack_test_layouts); i++) {
+		layout = &cal_pack_test_layouts[i];
+
+		for (j = 0; j < ARRAY_SIZE(cal_pack_test_lens); j++) {
+			len = cal_pack_test_lens[j];
+			regs_len = DIV_ROUND_UP(len, 2);
+
+			memset(regs, 0, sizeof(regs));
+			KUNIT_ASSERT_EQ(test, cal_pack_color_lut_into_reg_pairs(lut,
+					red, len, layout->low_mask, layout->hi_mask,
+					regs, regs_len), 0);
+			for (k = 0; k < len; k++)
+				chan[k] = lut[k].red;
+			cal_pack_test_expect_channel(test, chan, len, layout, regs);
+
+			memset(regs, 0, sizeof(regs));
+			KUNIT_ASSERT_EQ(test, cal_pack_color_lut_into_reg_pairs(lut,
+					green, len, layout->low_mask, layout->hi_mask,
+					regs, regs_len), 0);
+			for (k = 0; k < len; k++)
+				chan[k] = lut[k].green;
+			cal_pack_test_expect_channel(test, chan, len, layout, regs);
+
+			memset(regs, 0, sizeof(regs));
+			KUNIT_ASSERT_EQ(test, cal_pack_color_lut_into_reg_pairs(lut,
+					blue, len, layout->low_mask, layout->hi_mask,
+					regs, regs_len), 0);
+			for (k = 0; k < len; k++)
+				chan[k] = lut[k].blue;
+			cal_pack_test_expect_channel(test, chan, len, layout, regs);
+		}
+	}
+}
+
+/* the DQE callers pack the second half of a LUT from an offset pointer */
+static void cal_pack_test_color_lut_offset(struct kunit *test)
+{
+	struct drm_color_lut lut[CAL_PACK_TEST_MAX_LEN];
+	uint16_t chan[CAL_PACK_TEST_MAX_LEN];
+	uint32_t regs[DIV_ROUND_UP(33, 2)];
+	const struct cal_pack_test_layout *layout = &cal_pack_test_layouts[0];
+	size_t k;
+
+	cal_pack_test_fill(lut, ARRAY_SIZE(lut));
+
+	KUNIT_ASSERT_EQ(test, cal_pack_color_lut_into_reg_pairs(lut + 33, blue,
+			33, layout->low_mask, layout->hi_mask, regs,
+			ARRAY_SIZE(regs)), 0);
+	for (k = 0; k < 33; k++)
+		chan[k] = lut[33 + k].blue;
+	cal_pack_test_expect_channel(test, chan, 33, layout, regs);
+}
+
+static void cal_pack_test_errors(struct kunit *test)
+{
+	struct drm_color_lut lut[CAL_PACK_TEST_MAX_LEN];
+	uint16_t chan[CAL_PACK_TEST_MAX_LEN];
+	uint32_t regs[DIV_ROUND_UP(CAL_PACK_TEST_MAX_LEN, 2)];
+	const struct cal_pack_test_layout *layout = &cal_pack_test_layouts[0];
+
+	cal_pack_test_fill(lut, ARRAY_SIZE(lut));
+	memset(chan, 0, sizeof(chan));
+
+	/* register count not matching the number of points */
+	KUNIT_EXPECT_EQ(test, cal_pack_color_lut_into_reg_pairs(lut, red, 65,
+			layout->low_mask, layout->hi_mask, regs, 32), -EINVAL);
+	KUNIT_EXPECT_EQ(test, cal_pack_lut_into_reg_pairs(chan, 65,
+			layout->low_mask, layout->hi_mask, regs, 32), -EINVAL);
+
+	KUNIT_EXPECT_EQ(test, cal_pack_color_lut_into_reg_pairs(lut, red, 66,
+			0, layout->hi_mask, regs, 33), -EINVAL);
+	KUNIT_EXPECT_EQ(test, cal_pack_lut_into_reg_pairs(chan, 66,
+			0, layout->hi_mask, regs, 33), -EINVAL);
+
+	KUNIT_EXPECT_EQ(test, cal_pack_color_lut_into_reg_pairs(lut, red, 66,
+			layout->low_mask, layout->hi_mask, NULL, 33), -ENOMEM);
+	KUNIT_EXPECT_EQ(test, cal_pack_lut_into_reg_pairs(chan, 66,
+			layout->low_mask, layout->hi_mask, NULL, 33), -ENOMEM);
+}
+
+/* a 66 point regamma LUT as the DQE setters pack it, POSX then POSY halves */
+static uint32_t cal_pack_test_lut_strided(const struct drm_color_lut *lut,
+		uint32_t *regs, size_t regs_len)
+{
+	const struct cal_pack_test_layout *layout = &cal_pack_test_layouts[0];
+	uint32_t sum = 0;
+	int h;
+
+	for (h = 0; h < 2; h++) {
+		cal_pack_color_lut_into_reg_pairs(lut + 33 * h, red, 33,
+				layout->low_mask, layout->hi_mask, regs, regs_len);
+		sum += regs[regs_len - 1];
+		cal_pack_color_lut_into_reg_pairs(lut + 33 * h, green, 33,
+				layout->low_mask, layout->hi_mask, regs, regs_len);
+		sum += regs[regs_len - 1];
+		cal_pack_color_lut_into_reg_pairs(lut + 33 * h, blue, 33,
+				layout->low_mask, layout->hi_mask, regs, regs_len);
+		sum += regs[regs_len - 1];
+	}
+
+	return sum;
+}
+
+/* the same with the staging copy the setters used to make per channel */
+static uint32_t cal_pack_test_lut_staged(const struct drm_color_lut *lut,
+		uint16_t *chan, uint32_t *regs, size_t regs_len)
+{
+	const struct cal_pack_test_layout *layout = &cal_pack_test_layouts[0];
+	uint32_t sum = 0;
+	size_t k;
+	int h;
+
+	for (h = 0; h < 2; h++) {
+		for (k = 0; k < 33; k++)
+			chan[k] = lut[33 * h + k].red;
+		cal_pack_lut_into_reg_pairs(chan, 33, layout->low_mask,
+				layout->hi_mask, regs, regs_len);
+		sum += regs[regs_len - 1];
+		for (k = 0; k < 33; k++)
+			chan[k] = lut[33 * h + k].green;
+		cal_pack_lut_into_reg_pairs(chan, 33, layout->low_mask,
+				layout->hi_mask, regs, regs_len);
+		sum += regs[regs_len - 1];
+		for (k = 0; k < 33; k++)
+			chan[k] = lut[33 * h + k].blue;
+		cal_pack_lut_into_reg_pairs(chan, 33, layout->low_mask,
+				layout->hi_mask, regs, regs_len);
+		sum += regs[regs_len - 1];
+	}
+
+	return sum;
+}
+
+/*
+ * Not a pass/fail check on time, it reports what packing a full LUT costs
+ * next to the 102 relaxed writes that program it.
+ */
+static void cal_pack_test_timing(struct kunit *test)
+{
+	struct drm_color_lut lut[CAL_PACK_TEST_MAX_LEN];
+	uint16_t chan[CAL_PACK_TEST_MAX_LEN];
+	uint32_t regs[DIV_ROUND_UP(33, 2)];
+	uint32_t strided_sum = 0, staged_sum = 0;
+	u64 start, strided_ns, staged_ns;
+	int n;
+
+	cal_pack_test_fill(lut, ARRAY_SIZE(lut));
+
+	start = ktime_get_ns();
+	for (n = 0; n < CAL_PACK_TEST_LOOPS; n++)
+		strided_sum += cal_pack_test_lut_strided(lut, regs,
+				ARRAY_SIZE(regs));
+	strided_ns = ktime_get_ns() - start;
+
+	start = ktime_get_ns();
+	for (n = 0; n < CAL_PACK_TEST_LOOPS; n++)
+		staged_sum += cal_pack_test_lut_staged(lut, chan, regs,
+				ARRAY_SIZE(regs));
+	staged_ns = ktime_get_ns() - start;
+
+	KUNIT_EXPECT_EQ(test, strided_sum, staged_sum);
+	kunit_info(test, "66 point LUT: strided %llu ns, staged %llu ns\n",
+			div_u64(strided_ns, CAL_PACK_TEST_LOOPS),
+			div_u64(staged_ns, CAL_PACK_TEST_LOOPS));
+}
+
+static struct kunit_case cal_pack_test_cases[] = {
+	KUNIT_CASE(cal_pack_test_color_lut),
+	KUNIT_CASE(cal_pack_test_color_lut_offset),
+	KUNIT_CASE(cal_pack_test_errors),
+	KUNIT_CASE(cal_pack_test_timing),
+	{}
+};
+
+static struct kunit_suite cal_pack_test_suite = {
+	.name = "exynos-drm-cal-pack-lut",
+	.test_cases = cal_pack_test_cases,
+};
+
+kunit_test_suite(cal_pack_test_suite);
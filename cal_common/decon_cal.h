@@ -60,7 +60,8 @@ enum decon_regs_type {
 
 extern struct cal_regs_desc regs_decon[REGS_DECON_TYPE_MAX][REGS_DECON_ID_MAX];
 
-#define decon_regs_desc(id)			(&regs_decon[REGS_DECON][id])
+#define decon_regs_desc(id)			\
+	cal_regs_desc_get(&regs_decon[REGS_DECON][id])
 #define decon_read(id, offset)			\
 	cal_read(decon_regs_desc(id), offset)
 #define decon_write(id, offset, val)		\
@@ -71,7 +72,7 @@ extern struct cal_regs_desc regs_decon[REGS_DECON_TYPE_MAX][REGS_DECON_ID_MAX];
 	cal_write_mask(decon_regs_desc(id), offset, val, mask)
 
 #define win_regs_desc(id)			\
-	(&regs_decon[REGS_DECON_WIN][id])
+	cal_regs_desc_get(&regs_decon[REGS_DECON_WIN][id])
 #define win_read(id, offset)			\
 	cal_read(win_regs_desc(id), offset)
 #define win_write(id, offset, val)		\
@@ -82,7 +83,7 @@ extern struct cal_regs_desc regs_decon[REGS_DECON_TYPE_MAX][REGS_DECON_ID_MAX];
 	cal_write_mask(win_regs_desc(id), offset, val, mask)
 
 #define wincon_regs_desc(id)				\
-	(&regs_decon[REGS_DECON_WINCON][id])
+	cal_regs_desc_get(&regs_decon[REGS_DECON_WINCON][id])
 #define wincon_read(id, offset)				\
 	cal_read(wincon_regs_desc(id), offset)
 #define wincon_write(id, offset, val)			\
@@ -93,7 +94,7 @@ extern struct cal_regs_desc regs_decon[REGS_DECON_TYPE_MAX][REGS_DECON_ID_MAX];
 	cal_write_mask(wincon_regs_desc(id), offset, val, mask)
 
 #define sub_regs_desc(id)			\
-	(&regs_decon[REGS_DECON_SUB][id])
+	cal_regs_desc_get(&regs_decon[REGS_DECON_SUB][id])
 #define dsimif_read(id, offset)			\
 	cal_read(sub_regs_desc(id), offset)
 #define dsimif_write(id, offset, val)		\
@@ -317,6 +318,18 @@ struct decon_config {
 	int			main_dsim_id;
 };
 
+#define DECON_SNAPSHOT_REG_CNT		128
+
+/*
+ * Register image of the DECON and DSC configuration written by
+ * decon_reg_init(), saved before the block is powered down.
+ */
+struct decon_reg_snapshot {
+	u32 version;
+	u32 cnt;
+	u32 regs[DECON_SNAPSHOT_REG_CNT];
+};
+
 struct decon_regs {
 	void __iomem *regs;
 	void __iomem *win_regs;
@@ -387,10 +400,14 @@ void decon_regs_desc_init(void __iomem *regs, phys_addr_t start, const char *nam
 /*************** DECON CAL APIs exposed to DECON driver ***************/
 /* DECON control */
 int decon_reg_init(u32 id, struct decon_config *config);
+int decon_reg_save(u32 id, struct decon_config *config, struct decon_reg_snapshot *snap);
+int decon_reg_restore(u32 id, struct decon_config *config,
+		const struct decon_reg_snapshot *snap);
 void decon_reg_direct_on_off(u32 id, u32 en);
 int decon_reg_start(u32 id, struct decon_config *config);
 int decon_reg_stop(u32 id, struct decon_config *config, bool rst, u32 fps);
 void decon_reg_set_bpc_and_dither_path(u32 id, struct decon_config *config);
+void dsc_reg_set_clock_gating(u32 id, struct decon_config *config, bool en);
 
 /* DECON window control */
 void decon_reg_set_win_enable(u32 id, u32 win_idx, u32 en);
@@ -405,6 +422,7 @@ void decon_reg_update_req_window(u32 id, u32 win_idx);
 /* DECON shadow update and trigger control */
 void decon_reg_set_trigger(u32 id, struct decon_mode *mode,
 		enum decon_set_trig trig);
+bool decon_reg_is_trigger_unmasked(u32 id, struct decon_mode *mode);
 void decon_reg_update_req_and_unmask(u32 id, struct decon_mode *mode);
 int decon_reg_wait_update_done_timeout(u32 id, unsigned long timeout_us);
 int decon_reg_wait_update_done_and_mask(u32 id, struct decon_mode *mode,
@@ -163,7 +163,8 @@ enum dpp_regs_type {
 
 extern struct cal_regs_desc regs_dpp[REGS_DPP_TYPE_MAX][REGS_DPP_ID_MAX];
 
-#define dpp_regs_desc(id)			(&regs_dpp[REGS_DPP][id])
+#define dpp_regs_desc(id)			\
+	cal_regs_desc_get(&regs_dpp[REGS_DPP][id])
 #define dpp_read(id, offset)			\
 	cal_read(dpp_regs_desc(id), offset)
 #define dpp_write(id, offset, val)		\
@@ -173,7 +174,8 @@ extern struct cal_regs_desc regs_dpp[REGS_DPP_TYPE_MAX][REGS_DPP_ID_MAX];
 #define dpp_write_mask(id, offset, val, mask)	\
 	cal_write_mask(dpp_regs_desc(id), offset, val, mask)
 
-#define dma_regs_desc(id)			(&regs_dpp[REGS_DMA][id])
+#define dma_regs_desc(id)			\
+	cal_regs_desc_get(&regs_dpp[REGS_DMA][id])
 #define dma_read(id, offset)			\
 	cal_read(dma_regs_desc(id), offset)
 #define dma_write(id, offset, val)		\
@@ -290,11 +292,21 @@ static inline void cgc_reg_set_config_internal(u32 id, bool en, dma_addr_t addr)
 void dpp_regs_desc_init(void __iomem *regs, phys_addr_t start, const char *name,
 		enum dpp_regs_type type, unsigned int id);
 
+/* poly-phase scaler banks, only the first 9 of the 16 phases are programmed */
+#define DPP_SCL_COEF_PHASE_CNT	9
+#define DPP_SCL_COEF_MAX_TAPS	8
+
+bool dpp_scl_coef_get(u32 ratio, u32 taps, s16 *coef);
+
 /* DPP CAL APIs exposed to DPP driver */
 void dpp_reg_init(u32 id, const unsigned long attr);
 int dpp_reg_deinit(u32 id, bool reset, const unsigned long attr);
+void dpp_reg_set_clock_gating(u32 id, const unsigned long attr, bool en);
 void dpp_reg_configure_params(u32 id, struct dpp_params_info *p,
 		const unsigned long attr);
+/* reprogram only the buffer addresses of an already configured channel */
+void dpp_reg_set_base_addr(u32 id, struct dpp_params_info *p,
+		const unsigned long attr);
 
 void dma_reg_dump_com_debug_regs(struct drm_printer *p, int id);
 void rcd_dma_dump_regs(struct drm_printer *p, u32 id, void __iomem *dma_regs);
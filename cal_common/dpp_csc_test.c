@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Samsung Electronics Co., Ltd.
+ *		http://www.samsung.com
+ *
+ * KUnit tests for the prepacked DPP CSC register images. Included from the
+ * dpp_reg.c of each CAL to reach its static functions and tables.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <kunit/test.h>
+#include <linux/sizes.h>
+
+#include <cal_fake_mmio.h>
+
+#define DPP_TEST_ID		REGS_DPP0_ID
+#define DPP_TEST_POISON		0xDEADBEEF
+
+struct dpp_csc_test_ctx {
+	struct cal_fake_mmio fake;
+};
+
+static const struct {
+	u32 std;
+	u32 idx;
+} dpp_csc_test_stds[] = {
+	{ EXYNOS_STANDARD_BT601_625, DPP_CSC_IDX_BT601_625 },
+	{ EXYNOS_STANDARD_BT601_625_UNADJUSTED, DPP_CSC_IDX_BT601_625_UNADJUSTED },
+	{ EXYNOS_STANDARD_BT601_525, DPP_CSC_IDX_BT601_525 },
+	{ EXYNOS_STANDARD_BT601_525_UNADJUSTED, DPP_CSC_IDX_BT601_525_UNADJUSTED },
+	{ EXYNOS_STANDARD_BT2020_CONSTANT_LUMINANCE, DPP_CSC_IDX_BT2020_CONSTANT_LUMINANCE },
+	{ EXYNOS_STANDARD_BT470M, DPP_CSC_IDX_BT470M },
+	{ EXYNOS_STANDARD_FILM, DPP_CSC_IDX_FILM },
+	{ EXYNOS_STANDARD_ADOBE_RGB, DPP_CSC_IDX_ADOBE_RGB },
+	{ EXYNOS_STANDARD_BT709, DPP_CSC_IDX_BT709 },
+	{ EXYNOS_STANDARD_BT2020, DPP_CSC_IDX_BT2020 },
+	{ EXYNOS_STANDARD_DCI_P3, DPP_CSC_IDX_DCI_P3 },
+};
+
+static const u32 dpp_csc_test_ranges[] = {
+	EXYNOS_RANGE_LIMITED, EXYNOS_RANGE_FULL, EXYNOS_RANGE_UNSPECIFIED,
+};
+
+#define DPP_CSC_TEST_RMW(reg, val, mask)	\
+	((reg) = ((val) & (mask)) | ((reg) & ~(mask)))
+
+/* per-coefficient read-modify-write sequence replaced by the images */
+static void dpp_csc_test_ref_pack(const u16 (*m)[3], u32 *regs)
+{
+	const u32 mask = DPP_CSC_COEF_H_MASK | DPP_CSC_COEF_L_MASK;
+
+	DPP_CSC_TEST_RMW(regs[0], DPP_CSC_COEF_H(m[0][1]) | DPP_CSC_COEF_L(m[0][0]), mask);
+	DPP_CSC_TEST_RMW(regs[1], DPP_CSC_COEF_H(m[1][0]) | DPP_CSC_COEF_L(m[0][2]), mask);
+	DPP_CSC_TEST_RMW(regs[2], DPP_CSC_COEF_H(m[1][2]) | DPP_CSC_COEF_L(m[1][1]), mask);
+	DPP_CSC_TEST_RMW(regs[3], DPP_CSC_COEF_H(m[2][1]) | DPP_CSC_COEF_L(m[2][0]), mask);
+	DPP_CSC_TEST_RMW(regs[4], DPP_CSC_COEF_L(m[2][2]), DPP_CSC_COEF_L_MASK);
+}
+
+static void dpp_csc_test_poison(struct cal_fake_mmio *fake)
+{
+	int i;
+
+	for (i = 0; i < DPP_CSC_COEF_REG_CNT; i++)
+		cal_fake_mmio_poke(fake, DPP_COM_CSC_COEF0 + i * 4, DPP_TEST_POISON);
+}
+
+static void dpp_csc_test_images(struct kunit *test)
+{
+	u32 ref[DPP_CSC_COEF_REG_CNT];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(csc_y2r_3x3_t); i++) {
+		memset(ref, 0, sizeof(ref));
+		dpp_csc_test_ref_pack(csc_y2r_3x3_t[i], ref);
+		KUNIT_EXPECT_EQ_MSG(test, memcmp(ref, csc_y2r_images[i].coef,
+				sizeof(ref)), 0, "y2r matrix %d", i);
+	}
+
+	for (i = 0; i < ARRAY_SIZE(csc_r2y_3x3_t); i++) {
+		memset(ref, 0, sizeof(ref));
+		dpp_csc_test_ref_pack(csc_r2y_3x3_t[i], ref);
+		KUNIT_EXPECT_EQ_MSG(test, memcmp(ref, csc_r2y_images[i].coef,
+				sizeof(ref)), 0, "r2y matrix %d", i);
+	}
+}
+
+/*
+ * Program every (standard, range, direction) through the register path and
+ * compare the coefficient registers with the per-coefficient packing of the
+ * matrix selected for it.
+ */
+static void dpp_csc_test_params(struct kunit *test)
+{
+	struct dpp_csc_test_ctx *ctx = test->priv;
+	const u16 (*table)[3][3];
+	u32 ref[DPP_CSC_COEF_REG_CNT];
+	unsigned long attr;
+	size_t cnt;
+	u32 idx, con;
+	int odma, i, j, k;
+
+	for (odma = 0; odma < 2; odma++) {
+		attr = odma ? BIT(DPP_ATTR_ODMA) : 0;
+		table = odma ? csc_r2y_3x3_t : csc_y2r_3x3_t;
+		cnt = odma ? ARRAY_SIZE(csc_r2y_3x3_t) : ARRAY_SIZE(csc_y2r_3x3_t);
+
+		for (i = 0; i < ARRAY_SIZE(dpp_csc_test_stds); i++) {
+			for (j = 0; j < ARRAY_SIZE(dpp_csc_test_ranges); j++) {
+				csc_loaded[DPP_TEST_ID].desc = NULL;
+				dpp_csc_test_poison(&ctx->fake);
+
+				dpp_reg_set_csc_params(DPP_TEST_ID, dpp_csc_test_stds[i].std,
+						dpp_csc_test_ranges[j], attr);
+
+				for (k = 0; k < DPP_CSC_COEF_REG_CNT; k++)
+					ref[k] = DPP_TEST_POISON;
+
+				con = cal_fake_mmio_peek(&ctx->fake, DPP_COM_CSC_CON);
+				if ((con & DPP_CSC_MODE_MASK) == DPP_CSC_MODE_CUSTOMIZED) {
+					idx = dpp_csc_test_stds[i].idx;
+					if (dpp_csc_test_ranges[j] == EXYNOS_RANGE_FULL)
+						idx++;
+					if (idx >= cnt)
+						idx = DPP_CSC_IDX_BT601_625;
+					dpp_csc_test_ref_pack(table[idx], ref);
+				} else {
+					/* only hardwired Y2R leaves the coefficients alone */
+					KUNIT_EXPECT_FALSE(test, odma);
+				}
+
+				for (k = 0; k < DPP_CSC_COEF_REG_CNT; k++)
+					KUNIT_EXPECT_EQ_MSG(test, cal_fake_mmio_peek(&ctx->fake,
+							DPP_COM_CSC_COEF0 + k * 4), ref[k],
+							"odma %d std %u range %u COEF%d", odma,
+							dpp_csc_test_stds[i].std,
+							dpp_csc_test_ranges[j], k);
+			}
+		}
+	}
+}
+
+static void dpp_csc_test_unchanged(struct kunit *test)
+{
+	struct dpp_csc_test_ctx *ctx = test->priv;
+	const unsigned long attr = BIT(DPP_ATTR_ODMA);
+
+	csc_loaded[DPP_TEST_ID].desc = NULL;
+	dpp_reg_set_csc_params(DPP_TEST_ID, EXYNOS_STANDARD_BT709,
+			EXYNOS_RANGE_LIMITED, attr);
+	KUNIT_EXPECT_GT(test, ctx->fake.write_cnt, 0);
+
+	/* same setting is not programmed again */
+	cal_fake_mmio_clear_log(&ctx->fake);
+	dpp_reg_set_csc_params(DPP_TEST_ID, EXYNOS_STANDARD_BT709,
+			EXYNOS_RANGE_LIMITED, attr);
+	KUNIT_EXPECT_EQ(test, ctx->fake.write_cnt, 0);
+
+	cal_fake_mmio_clear_log(&ctx->fake);
+	dpp_reg_set_csc_params(DPP_TEST_ID, EXYNOS_STANDARD_BT709,
+			EXYNOS_RANGE_FULL, attr);
+	KUNIT_EXPECT_GT(test, ctx->fake.write_cnt, 0);
+
+	/* nor is it trusted after the channel lost its registers */
+	cal_fake_mmio_clear_log(&ctx->fake);
+	csc_loaded[DPP_TEST_ID].desc = NULL;
+	dpp_reg_set_csc_params(DPP_TEST_ID, EXYNOS_STANDARD_BT709,
+			EXYNOS_RANGE_FULL, attr);
+	KUNIT_EXPECT_GT(test, ctx->fake.write_cnt, 0);
+}
+
+static int dpp_csc_test_init(struct kunit *test)
+{
+	struct dpp_csc_test_ctx *ctx;
+	int ret;
+
+	ctx = kunit_kzalloc(test, sizeof(*ctx), GFP_KERNEL);
+	if (!ctx)
+		return -ENOMEM;
+
+	ret = cal_fake_mmio_attach(dpp_regs_desc(DPP_TEST_ID), &ctx->fake, SZ_4K, 0);
+	if (ret)
+		return ret;
+
+	/*
+	 * Images are packed when a DPP probes, which may not have happened yet.
+	 * Packing them again stores the same values.
+	 */
+	dpp_reg_init_csc_images();
+
+	test->priv = ctx;
+
+	return 0;
+}
+
+static void dpp_csc_test_exit(struct kunit *test)
+{
+	cal_fake_mmio_detach(dpp_regs_desc(DPP_TEST_ID));
+}
+
+static struct kunit_case dpp_csc_test_cases[] = {
+	KUNIT_CASE(dpp_csc_test_images),
+	KUNIT_CASE(dpp_csc_test_params),
+	KUNIT_CASE(dpp_csc_test_unchanged),
+	{}
+};
+
+static struct kunit_suite dpp_csc_test_suite = {
+	.name = "exynos-drm-dpp-csc",
+	.init = dpp_csc_test_init,
+	.exit = dpp_csc_test_exit,
+	.test_cases = dpp_csc_test_cases,
+};
+
+kunit_test_suite(dpp_csc_test_suite);
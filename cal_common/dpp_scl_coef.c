@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Samsung Electronics Co., Ltd.
+ *		http://www.samsung.com
+ *
+ * DPP poly-phase scaler coefficient generator.
+ *
+ * The static tables in exynos_dpp_coef.h only offer seven filters for the
+ * whole downscale range. This derives a Lanczos windowed sinc filter bank
+ * for the actual ratio instead, with the cutoff following the ratio, and
+ * keeps the most recently used banks around so that steady state layers
+ * do not regenerate them.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <linux/fixp-arith.h>
+#include <linux/math64.h>
+#include <linux/module.h>
+#include <linux/spinlock.h>
+#include <linux/string.h>
+
+#include <dpp_cal.h>
+
+/*
+ * Only read when dpp_reg_set_scale_ratio() programs the coefficients, which
+ * it does when the scale ratio of a channel changes. Toggling this at runtime
+ * leaves a layer kept at the same ratio on its current filters until the
+ * ratio changes again.
+ */
+static bool scl_coef_gen;
+module_param(scl_coef_gen, bool, 0644);
+MODULE_PARM_DESC(scl_coef_gen,
+		"generate DPP downscale filters per ratio, applied on the next scale ratio change");
+
+/* banks are generated for ratios rounded up to 1/16 steps */
+#define SCL_RATIO_STEP		((1 << 20) / 16)
+#define SCL_RATIO_LIMIT		(8 << 20)
+#define SCL_COEF_SUM		512
+#define SCL_COEF_CACHE_CNT	8
+
+/* pi in Q16 */
+#define SCL_PI_Q16		205887
+
+struct scl_coef_bank {
+	u32 ratio;
+	u32 taps;
+	u64 last_use;
+	s16 coef[DPP_SCL_COEF_PHASE_CNT][DPP_SCL_COEF_MAX_TAPS];
+};
+
+static struct scl_coef_bank scl_coef_cache[SCL_COEF_CACHE_CNT];
+static u64 scl_coef_use_seq;
+static DEFINE_SPINLOCK(scl_coef_lock);
+
+/* sin(pi * t) / (pi * t) in Q30 for t in Q16 */
+static s64 scl_sinc(s64 t)
+{
+	s64 pit;
+	s32 s;
+
+	if (t < 0)
+		t = -t;
+	if (!t)
+		return 1LL << 30;
+
+	/* fixp_sin32_rad() takes the angle relative to a full period */
+	s = fixp_sin32_rad((u32)t, 2 << 16);
+	pit = (t * SCL_PI_Q16) >> 16;
+
+	return div64_s64((s64)s << 15, pit);
+}
+
+static void scl_coef_generate(struct scl_coef_bank *bank)
+{
+	const s64 half = bank->taps / 2;
+	/* cutoff relative to the input sample rate, Q16 */
+	const s64 fc = div_u64((u64)1 << 36, bank->ratio);
+	s64 w[DPP_SCL_COEF_MAX_TAPS];
+	int phase, k;
+
+	for (phase = 0; phase < DPP_SCL_COEF_PHASE_CNT; phase++) {
+		s64 sum = 0;
+		int acc = 0, err, center = half - 1;
+
+		for (k = 0; k < bank->taps; k++) {
+			/*
+			 * distance of tap k from the output sample, Q16, taken
+			 * unsigned so that mirrored taps round the same way
+			 */
+			s64 x = abs(((k - (half - 1)) << 16) - (phase << 12));
+
+			if (x >= (half << 16)) {
+				w[k] = 0;
+				continue;
+			}
+
+			w[k] = (fc * scl_sinc((fc * x) >> 16)) >> 16;
+			w[k] = (w[k] * scl_sinc(div_s64(x, half))) >> 30;
+			sum += w[k];
+		}
+
+		for (k = 0; k < bank->taps; k++) {
+			bank->coef[phase][k] = div64_s64(w[k] * SCL_COEF_SUM +
+					sum / 2, sum);
+			acc += bank->coef[phase][k];
+		}
+
+		/*
+		 * keep unity gain, put the rounding error on the nearest tap or
+		 * split it between the two middle ones halfway between samples
+		 */
+		err = SCL_COEF_SUM - acc;
+		if (phase == DPP_SCL_COEF_PHASE_CNT - 1) {
+			bank->coef[phase][center] += err / 2;
+			bank->coef[phase][center + 1] += err - err / 2;
+		} else {
+			bank->coef[phase][center] += err;
+		}
+	}
+}
+
+static bool __dpp_scl_coef_get(u32 ratio, u32 taps, s16 *coef)
+{
+	struct scl_coef_bank *bank = NULL, *victim = &scl_coef_cache[0];
+	unsigned long flags;
+	int i;
+
+	/* upscaling keeps using the tuned tables */
+	if (ratio <= (1 << 20))
+		return false;
+
+	if (WARN_ON(taps > DPP_SCL_COEF_MAX_TAPS || taps & 1))
+		return false;
+
+	ratio = min_t(u32, roundup(ratio, SCL_RATIO_STEP), SCL_RATIO_LIMIT);
+
+	spin_lock_irqsave(&scl_coef_lock, flags);
+	for (i = 0; i < SCL_COEF_CACHE_CNT; i++) {
+		struct scl_coef_bank *b = &scl_coef_cache[i];
+
+		if (b->taps == taps && b->ratio == ratio) {
+			bank = b;
+			break;
+		}
+
+		if (b->last_use < victim->last_use)
+			victim = b;
+	}
+
+	if (!bank) {
+		bank = victim;
+		bank->ratio = ratio;
+		bank->taps = taps;
+		scl_coef_generate(bank);
+		pr_debug("%s: generated %u taps for ratio %#x\n", __func__,
+				taps, ratio);
+	}
+
+	bank->last_use = ++scl_coef_use_seq;
+	for (i = 0; i < DPP_SCL_COEF_PHASE_CNT; i++)
+		memcpy(&coef[i * taps], bank->coef[i], taps * sizeof(*coef));
+	spin_unlock_irqrestore(&scl_coef_lock, flags);
+
+	return true;
+}
+
+/*
+ * Fills @coef (DPP_SCL_COEF_PHASE_CNT rows of @taps values) with a filter
+ * bank for @ratio (Q20, input/output). Returns false if generation is
+ * disabled or not needed, in which case the static tables should be used.
+ */
+bool dpp_scl_coef_get(u32 ratio, u32 taps, s16 *coef)
+{
+	if (!scl_coef_gen)
+		return false;
+
+	return __dpp_scl_coef_get(ratio, taps, coef);
+}
+
+#if IS_ENABLED(CONFIG_DRM_SAMSUNG_CAL_KUNIT_TEST)
+#include "dpp_scl_coef_test.c"
+#endif
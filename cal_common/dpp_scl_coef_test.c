@@ -0,0 +1,195 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Samsung Electronics Co., Ltd.
+ *		http://www.samsung.com
+ *
+ * KUnit tests for the DPP scaler coefficient generator. Included from
+ * dpp_scl_coef.c to reach its static functions.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <kunit/test.h>
+
+/* tuned tables of the CAL, defined by its dpp_reg.c */
+extern const s16 h_coef_8t[7][16][8];
+extern const s16 v_coef_4t[7][16][4];
+
+/* largest difference allowed from the interpolation table at ratio 1 */
+#define SCL_TEST_TABLE0_TOL	(SCL_COEF_SUM / 32)
+/*
+ * largest difference allowed from the downscale tables at the upper end of
+ * their range, taps measured up to 36 apart there
+ */
+#define SCL_TEST_TABLE_TOL	(SCL_COEF_SUM / 12)
+
+/* upper end of the ratio range each downscale table is picked for */
+static const u32 scl_test_table_ratio[] = {
+	(1 << 20) * 8 / 7,
+	(1 << 20) * 8 / 6,
+	(1 << 20) * 8 / 5,
+	(1 << 20) * 8 / 4,
+	(1 << 20) * 8 / 3,
+	SCL_RATIO_LIMIT,
+};
+
+static const u32 scl_test_taps[] = { 8, 4 };
+
+static void scl_test_generate(struct scl_coef_bank *bank, u32 ratio, u32 taps)
+{
+	memset(bank, 0, sizeof(*bank));
+	bank->ratio = ratio;
+	bank->taps = taps;
+	scl_coef_generate(bank);
+}
+
+static void dpp_scl_coef_test_unity(struct kunit *test)
+{
+	struct scl_coef_bank bank;
+	u32 ratio;
+	int i, phase, k, sum;
+
+	for (i = 0; i < ARRAY_SIZE(scl_test_taps); i++) {
+		for (ratio = 1 << 20; ratio <= SCL_RATIO_LIMIT;
+				ratio += SCL_RATIO_STEP) {
+			scl_test_generate(&bank, ratio, scl_test_taps[i]);
+
+			for (phase = 0; phase < DPP_SCL_COEF_PHASE_CNT; phase++) {
+				sum = 0;
+				for (k = 0; k < bank.taps; k++)
+					sum += bank.coef[phase][k];
+				KUNIT_EXPECT_EQ_MSG(test, sum, SCL_COEF_SUM,
+						"taps %u ratio %#x phase %d",
+						bank.taps, ratio, phase);
+			}
+		}
+	}
+}
+
+/* phase 8 is halfway between two input samples */
+static void dpp_scl_coef_test_symmetry(struct kunit *test)
+{
+	const int phase = DPP_SCL_COEF_PHASE_CNT - 1;
+	struct scl_coef_bank bank;
+	u32 ratio;
+	int i, k;
+
+	for (i = 0; i < ARRAY_SIZE(scl_test_taps); i++) {
+		for (ratio = 1 << 20; ratio <= SCL_RATIO_LIMIT;
+				ratio += SCL_RATIO_STEP) {
+			scl_test_generate(&bank, ratio, scl_test_taps[i]);
+
+			for (k = 0; k < bank.taps / 2; k++)
+				KUNIT_EXPECT_EQ_MSG(test, bank.coef[phase][k],
+						bank.coef[phase][bank.taps - 1 - k],
+						"taps %u ratio %#x tap %d",
+						bank.taps, ratio, k);
+		}
+	}
+}
+
+/*
+ * Without downscaling the cutoff is the input Nyquist rate, where the bank
+ * should come out close to the interpolation filters of table 0.
+ */
+static void dpp_scl_coef_test_table0(struct kunit *test)
+{
+	struct scl_coef_bank bank;
+	int phase, k;
+
+	scl_test_generate(&bank, 1 << 20, 8);
+	for (phase = 0; phase < DPP_SCL_COEF_PHASE_CNT; phase++)
+		for (k = 0; k < 8; k++)
+			KUNIT_EXPECT_LE_MSG(test, abs(bank.coef[phase][k] -
+					h_coef_8t[0][phase][k]),
+					SCL_TEST_TABLE0_TOL,
+					"8 taps phase %d tap %d", phase, k);
+
+	scl_test_generate(&bank, 1 << 20, 4);
+	for (phase = 0; phase < DPP_SCL_COEF_PHASE_CNT; phase++)
+		for (k = 0; k < 4; k++)
+			KUNIT_EXPECT_LE_MSG(test, abs(bank.coef[phase][k] -
+					v_coef_4t[0][phase][k]),
+					SCL_TEST_TABLE0_TOL,
+					"4 taps phase %d tap %d", phase, k);
+}
+
+/*
+ * The generated banks follow the same cutoff as the tuned tables, so at the
+ * ratio a table was made for they should stay close to it. Tables hold all
+ * 16 phases, the bank the first half up to the midpoint.
+ */
+static void dpp_scl_coef_test_tables(struct kunit *test)
+{
+	struct scl_coef_bank bank;
+	u32 ratio;
+	int i, phase, k;
+
+	for (i = 0; i < ARRAY_SIZE(scl_test_table_ratio); i++) {
+		/* as dpp_scl_coef_get() would pick it */
+		ratio = min_t(u32, roundup(scl_test_table_ratio[i], SCL_RATIO_STEP),
+				SCL_RATIO_LIMIT);
+
+		scl_test_generate(&bank, ratio, 8);
+		for (phase = 0; phase < DPP_SCL_COEF_PHASE_CNT; phase++)
+			for (k = 0; k < 8; k++)
+				KUNIT_EXPECT_LE_MSG(test, abs(bank.coef[phase][k] -
+						h_coef_8t[i + 1][phase][k]),
+						SCL_TEST_TABLE_TOL,
+						"table %d 8 taps phase %d tap %d",
+						i + 1, phase, k);
+
+		scl_test_generate(&bank, ratio, 4);
+		for (phase = 0; phase < DPP_SCL_COEF_PHASE_CNT; phase++)
+			for (k = 0; k < 4; k++)
+				KUNIT_EXPECT_LE_MSG(test, abs(bank.coef[phase][k] -
+						v_coef_4t[i + 1][phase][k]),
+						SCL_TEST_TABLE_TOL,
+						"table %d 4 taps phase %d tap %d",
+						i + 1, phase, k);
+	}
+}
+
+/* scl_coef_gen is left alone, it is shared with the probed DPPs */
+static void dpp_scl_coef_test_get(struct kunit *test)
+{
+	const u32 ratio = (1 << 20) * 3 / 2 + 1;
+	s16 coef[DPP_SCL_COEF_PHASE_CNT][8];
+	struct scl_coef_bank bank;
+	int phase;
+
+	/* upscaling and 1:1 keep the tuned tables */
+	KUNIT_EXPECT_FALSE(test, __dpp_scl_coef_get(1 << 20, 8, &coef[0][0]));
+	KUNIT_EXPECT_FALSE(test, __dpp_scl_coef_get(1 << 19, 8, &coef[0][0]));
+
+	/* bank of the ratio rounded up to the next step, from the cache too */
+	scl_test_generate(&bank, roundup(ratio, SCL_RATIO_STEP), 8);
+	KUNIT_ASSERT_TRUE(test, __dpp_scl_coef_get(ratio, 8, &coef[0][0]));
+	for (phase = 0; phase < DPP_SCL_COEF_PHASE_CNT; phase++)
+		KUNIT_EXPECT_EQ(test, memcmp(coef[phase], bank.coef[phase],
+				sizeof(coef[phase])), 0);
+
+	memset(coef, 0, sizeof(coef));
+	KUNIT_ASSERT_TRUE(test, __dpp_scl_coef_get(ratio, 8, &coef[0][0]));
+	for (phase = 0; phase < DPP_SCL_COEF_PHASE_CNT; phase++)
+		KUNIT_EXPECT_EQ(test, memcmp(coef[phase], bank.coef[phase],
+				sizeof(coef[phase])), 0);
+}
+
+static struct kunit_case dpp_scl_coef_test_cases[] = {
+	KUNIT_CASE(dpp_scl_coef_test_unity),
+	KUNIT_CASE(dpp_scl_coef_test_symmetry),
+	KUNIT_CASE(dpp_scl_coef_test_table0),
+	KUNIT_CASE(dpp_scl_coef_test_tables),
+	KUNIT_CASE(dpp_scl_coef_test_get),
+	{}
+};
+
+static struct kunit_suite dpp_scl_coef_test_suite = {
+	.name = "exynos-drm-dpp-scl-coef",
+	.test_cases = dpp_scl_coef_test_cases,
+};
+
+kunit_test_suite(dpp_scl_coef_test_suite);
@@ -37,6 +37,9 @@
 #define GAMMA_MATRIX_OFFSETS_CNT	3
 #define LINEAR_MATRIX_COEFFS_CNT	9
 #define LINEAR_MATRIX_OFFSETS_CNT	3
+/* two's complement field widths */
+#define LINEAR_MATRIX_COEFF_BITS	16
+#define LINEAR_MATRIX_OFFSET_BITS	14
 
 #define CGC_EN(_v)			((_v) << 0)
 #define CGC_EN_MASK			(1 << 0)
@@ -102,7 +105,8 @@ static struct cal_regs_offset regs_dqe_offset[DQE_VERSION_MAX] = {
 };
 
 
-#define dqe_regs_desc(dqe_id)				(&regs_dqe[dqe_id].desc)
+#define dqe_regs_desc(dqe_id)			\
+	cal_regs_desc_get(&regs_dqe[dqe_id].desc)
 #define dqe_read(dqe_id, offset)			\
 	cal_read(dqe_regs_desc(dqe_id), offset)
 #define dqe_write(dqe_id, offset, val)			\
@@ -116,7 +120,8 @@ static struct cal_regs_offset regs_dqe_offset[DQE_VERSION_MAX] = {
 #define dqe_write_relaxed(dqe_id, offset, val)		\
 	cal_write_relaxed(dqe_regs_desc(dqe_id), offset, val)
 
-#define dqe_cgc_regs_desc(dqe_id)			(&regs_dqe_cgc[dqe_id].desc)
+#define dqe_cgc_regs_desc(dqe_id)			\
+	cal_regs_desc_get(&regs_dqe_cgc[dqe_id].desc)
 #define dqe_cgc_read(dqe_id, offset)			\
 	cal_read(dqe_cgc_regs_desc(dqe_id), offset)
 #define dqe_cgc_read_mask(dqe_id, offset, mask)			\
@@ -15,6 +15,14 @@
 
 #include <drm/samsung_drm.h>
 
+enum hdr_lut_type {
+	HDR_LUT_EOTF,
+	HDR_LUT_OETF,
+	HDR_LUT_GM,
+	HDR_LUT_TM,
+	HDR_LUT_MAX,
+};
+
 void hdr_regs_desc_init(void __iomem *regs, phys_addr_t start, const char *name, u32 id);
 void hdr_reg_set_hdr(u32 id, bool en);
 #if defined(CONFIG_SOC_ZUMA)
@@ -29,6 +37,8 @@ void hdr_reg_set_tm(u32 id, struct hdr_tm_data *tm);
 static inline void hdr_reg_set_fp16(u32 id, bool fp16_en, bool fp16_cvt_en) {}
 #endif
 void hdr_reg_set_gm(u32 id, struct hdr_gm_data *data);
+/* re-enable a block whose LUT registers still hold the wanted curve */
+void hdr_reg_enable_lut(u32 id, enum hdr_lut_type type);
 void hdr_reg_print_eotf_lut(u32 id, struct drm_printer *p);
 void hdr_reg_print_oetf_lut(u32 id, struct drm_printer *p);
 void hdr_reg_print_gm(u32 id, struct drm_printer *p);
@@ -621,6 +621,191 @@ static void dpu_bts_update_disp_ch_bw(struct decon_device *decon,
 	}
 }
 
+/*
+ * Per port read bandwidth of the windows of this decon for a given window to
+ * port mapping, with the same overlap rule as dpu_bts_update_disp_ch_bw().
+ */
+static void dpu_bts_calc_port_bw(struct decon_device *decon, const u32 *port,
+				 u32 *ch_bw)
+{
+	const struct dpu_bts_win_config *win_config = decon->bts.win_config;
+	int i, j;
+
+	memset(ch_bw, 0, sizeof(*ch_bw) * MAX_AXI_PORT);
+	for (i = 0; i < decon->win_cnt; i++) {
+		u32 overlap_ch_bw = 0;
+
+		if (win_config[i].state != DPU_WIN_STATE_BUFFER)
+			continue;
+
+		for (j = 0; j < decon->win_cnt; j++) {
+			if (win_config[j].state != DPU_WIN_STATE_BUFFER || port[j] != port[i])
+				continue;
+
+			if (is_win_half_covered(&win_config[i], &win_config[j]))
+				overlap_ch_bw += dpu_bts_get_rt_bw(decon, &win_config[j]);
+		}
+		ch_bw[port[i]] = max(ch_bw[port[i]], overlap_ch_bw);
+	}
+}
+
+/* bus part of max_disp_freq if this decon used @ch_bw, other decons as they are */
+static u32 dpu_bts_port_bw_to_freq(struct decon_device *decon, const u32 *ch_bw)
+{
+	u32 max_bw = 0;
+	int i, j;
+
+	for (j = 0; j < MAX_AXI_PORT; j++) {
+		u32 bw = ch_bw[j];
+
+		for (i = 0; i < MAX_DECON_CNT; i++) {
+			const struct decon_device *other = get_decon_drvdata(i);
+
+			if (other && other != decon)
+				bw += other->bts.ch_bw[j];
+		}
+		max_bw = max(max_bw, bw);
+	}
+
+	return max_bw * 100 / (decon->bts.bus_width * decon->bts.bus_util_pct);
+}
+
+/* DPP features a window depends on, beyond a plain IDMA read */
+static unsigned long dpu_bts_win_required_attr(struct decon_device *decon,
+					       const struct dpu_bts_win_config *config)
+{
+	const struct dpp_device *dpp = decon->dpp[DPPCH2PLANE(config->dpp_id)];
+	const struct dpu_fmt *fmt_info = dpu_find_fmt_info(config->format);
+	u32 src_w = config->is_rot ? config->src_h : config->src_w;
+	u32 src_h = config->is_rot ? config->src_w : config->src_h;
+	unsigned long attr = BIT(DPP_ATTR_IDMA);
+
+	if (config->is_rot)
+		attr |= BIT(DPP_ATTR_ROT);
+	if (config->is_comp)
+		attr |= dpp->attr & (BIT(DPP_ATTR_AFBC) | BIT(DPP_ATTR_SBWC));
+	if (config->hdr_en)
+		attr |= BIT(DPP_ATTR_HDR);
+	if (src_w != config->dst_w || src_h != config->dst_h)
+		attr |= BIT(DPP_ATTR_SCALE);
+	if (fmt_info && IS_YUV(fmt_info))
+		attr |= BIT(DPP_ATTR_CSC);
+
+	return attr;
+}
+
+/*
+ * Planes map 1:1 onto DPP channels and each channel sits on a fixed AXI port,
+ * so the composer's plane choice decides how read bandwidth spreads over the
+ * ports. This places the same windows greedily, largest bandwidth first, on
+ * the least loaded port that still has a capable idle channel, and records
+ * the DISP clock that placement would need next to the actual one. It only
+ * reports; nothing is reassigned, since moving a window to another channel
+ * means moving it to another DRM plane, which is the composer's call.
+ */
+static void dpu_bts_eval_assignment(struct decon_device *decon, u32 disp_op_freq)
+{
+	struct dpu_bts_assign_eval *eval = &decon->bts.assign;
+	const struct dpu_bts_win_config *win_config = decon->bts.win_config;
+	u32 cur_port[MAX_WIN_PER_DECON] = { 0 }, best_port[MAX_WIN_PER_DECON] = { 0 };
+	u32 load[MAX_AXI_PORT] = { 0 }, ch_bw[MAX_AXI_PORT];
+	u32 best_dpp_id[MAX_WIN_PER_DECON];
+	int order[MAX_WIN_PER_DECON];
+	bool used[MAX_DPP_CNT] = { false };
+	int i, j, k, n = 0;
+
+	if (!eval->enabled)
+		return;
+
+	for (i = 0; i < decon->win_cnt; i++) {
+		const struct dpu_bts_win_config *config = &win_config[i];
+		const u32 plane = DPPCH2PLANE(config->dpp_id);
+
+		best_dpp_id[i] = config->dpp_id;
+		if (config->state != DPU_WIN_STATE_BUFFER)
+			continue;
+
+		cur_port[i] = decon->bts.rt_bw[plane].ch_num;
+		if (cur_port[i] >= MAX_AXI_PORT)
+			return;
+
+		/* protection is set up per channel, keep secure buffers in place */
+		if (config->is_secure) {
+			used[plane] = true;
+			best_port[i] = cur_port[i];
+			load[cur_port[i]] += dpu_bts_get_rt_bw(decon, config);
+			continue;
+		}
+
+		/* insertion sort by descending rt bandwidth */
+		for (k = n; k > 0; k--) {
+			if (dpu_bts_get_rt_bw(decon, &win_config[order[k - 1]]) >=
+					dpu_bts_get_rt_bw(decon, config))
+				break;
+			order[k] = order[k - 1];
+		}
+		order[k] = i;
+		n++;
+	}
+
+	if (!n)
+		return;
+
+	for (k = 0; k < n; k++) {
+		const struct dpu_bts_win_config *config = &win_config[order[k]];
+		const unsigned long need = dpu_bts_win_required_attr(decon, config);
+		int best = -1;
+		u32 port;
+
+		for (j = 0; j < decon->dpp_cnt; j++) {
+			const struct dpp_device *dpp = decon->dpp[j];
+
+			port = decon->bts.rt_bw[j].ch_num;
+			if (used[j] || port >= MAX_AXI_PORT || (dpp->attr & need) != need)
+				continue;
+
+			if (dpp->decon_id >= 0 && dpp->decon_id != decon->id)
+				continue;
+
+			/* prefer the least capable channel to keep others free */
+			if (best < 0 || load[port] < load[decon->bts.rt_bw[best].ch_num] ||
+			    (load[port] == load[decon->bts.rt_bw[best].ch_num] &&
+			     hweight_long(dpp->attr) < hweight_long(decon->dpp[best]->attr)))
+				best = j;
+		}
+
+		if (best < 0) {
+			eval->fail_cnt++;
+			return;
+		}
+
+		port = decon->bts.rt_bw[best].ch_num;
+		used[best] = true;
+		load[port] += dpu_bts_get_rt_bw(decon, config);
+		best_port[order[k]] = port;
+		best_dpp_id[order[k]] = decon->dpp[best]->id;
+	}
+
+	dpu_bts_calc_port_bw(decon, cur_port, ch_bw);
+	eval->cur_freq = max(dpu_bts_port_bw_to_freq(decon, ch_bw), disp_op_freq);
+	dpu_bts_calc_port_bw(decon, best_port, ch_bw);
+	eval->best_freq = max(dpu_bts_port_bw_to_freq(decon, ch_bw), disp_op_freq);
+	eval->eval_cnt++;
+
+	if (eval->best_freq >= eval->cur_freq) {
+		eval->best_freq = eval->cur_freq;
+		for (i = 0; i < decon->win_cnt; i++)
+			eval->best_dpp_id[i] = win_config[i].dpp_id;
+		return;
+	}
+
+	memcpy(eval->best_dpp_id, best_dpp_id, sizeof(eval->best_dpp_id));
+	eval->better_cnt++;
+	eval->saved_khz_sum += eval->cur_freq - eval->best_freq;
+	DPU_DEBUG_BTS("  balanced placement DISP freq %u -> %u\n",
+			eval->cur_freq, eval->best_freq);
+}
+
 static void dpu_bts_find_max_disp_freq(struct decon_device *decon)
 {
 	int i;
@@ -665,6 +850,8 @@ static void dpu_bts_find_max_disp_freq(struct decon_device *decon)
 	if (disp_op_freq == 0)
 		disp_op_freq = dpu_bts_calc_disp_with_full_size(decon);
 
+	dpu_bts_eval_assignment(decon, disp_op_freq);
+
 	DPU_DEBUG_BTS("  DISP bus freq(%u), operating freq(%u)\n",
 			decon->bts.max_disp_freq, disp_op_freq);
 
@@ -1153,3 +1340,7 @@ struct dpu_bts_ops dpu_bts_control = {
 	.release_bw	= dpu_bts_release_resources,
 	.deinit		= dpu_bts_deinit,
 };
+
+#if IS_ENABLED(CONFIG_DRM_SAMSUNG_BTS_KUNIT_TEST)
+#include "exynos_drm_bts_test.c"
+#endif
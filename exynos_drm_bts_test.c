@@ -0,0 +1,256 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * Copyright (c) 2023 Samsung Electronics Co., Ltd.
+ *		http://www.samsung.com
+ *
+ * KUnit tests for the DPP placement evaluator of the BTS code. Included from
+ * exynos_drm_bts.c to reach its static functions.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#include <kunit/test.h>
+
+#define BTS_TEST_IDMA		BIT(DPP_ATTR_IDMA)
+#define BTS_TEST_COMP		(BIT(DPP_ATTR_AFBC) | BIT(DPP_ATTR_SBWC))
+#define BTS_TEST_VG		(BIT(DPP_ATTR_SCALE) | BIT(DPP_ATTR_CSC))
+
+/* bus part of the DISP clock is then bandwidth / 16 */
+#define BTS_TEST_BUS_WIDTH	16
+#define BTS_TEST_BUS_UTIL	100
+
+/* read bandwidth of 60Hz layers on a 1080x2400 panel */
+#define BTS_TEST_BW_FULL	622080	/* 1080x2400 ARGB8888 */
+#define BTS_TEST_BW_FULL_NV12	233280	/* 1080x2400 NV12 */
+#define BTS_TEST_BW_FHD_NV12	186624	/* 1920x1080 NV12 */
+#define BTS_TEST_BW_NAVBAR	38880	/* 1080x150 ARGB8888 */
+#define BTS_TEST_BW_STATUSBAR	25920	/* 1080x100 ARGB8888 */
+#define BTS_TEST_BW_SUBTITLE	51840	/* 1080x200 ARGB8888 */
+
+/* channel layout the stacks were recorded on, two channels per port */
+struct bts_test_ch {
+	unsigned long attr;
+	u32 port;
+};
+
+static const struct bts_test_ch bts_test_chs[] = {
+	{ BTS_TEST_IDMA, 0 },
+	{ BTS_TEST_IDMA | BTS_TEST_COMP, 0 },
+	{ BTS_TEST_IDMA | BTS_TEST_COMP | BTS_TEST_VG | BIT(DPP_ATTR_ROT) |
+	  BIT(DPP_ATTR_HDR), 1 },
+	{ BTS_TEST_IDMA, 1 },
+	{ BTS_TEST_IDMA | BIT(DPP_ATTR_AFBC) | BTS_TEST_VG, 0 },
+	{ BTS_TEST_IDMA, 1 },
+};
+
+#define BTS_TEST_MAX_WIN	4
+
+struct bts_test_stack {
+	const char *name;
+	int win_cnt;
+	struct dpu_bts_win_config win[BTS_TEST_MAX_WIN];
+	u32 bw[BTS_TEST_MAX_WIN];
+	/* expected result */
+	u32 cur_freq;
+	u32 best_freq;
+	u32 best_dpp_id[BTS_TEST_MAX_WIN];
+};
+
+#define BTS_TEST_WIN(y, w, h, fmt, ch, ...)				\
+	{ .state = DPU_WIN_STATE_BUFFER, .dst_y = (y), .dst_w = (w),	\
+	  .dst_h = (h), .src_w = (w), .src_h = (h), .format = (fmt),	\
+	  .dpp_id = (ch), __VA_ARGS__ }
+
+/* layer stacks as committed by the composer, with the DPP it picked */
+static const struct bts_test_stack bts_test_stacks[] = {
+	{
+		/* app and wallpaper on the same port */
+		.name = "launcher",
+		.win_cnt = 4,
+		.win = {
+			BTS_TEST_WIN(0, 1080, 2400, DRM_FORMAT_ARGB8888, 0),
+			BTS_TEST_WIN(0, 1080, 2400, DRM_FORMAT_ARGB8888, 1,
+				     .is_comp = true),
+			BTS_TEST_WIN(0, 1080, 100, DRM_FORMAT_ARGB8888, 3),
+			BTS_TEST_WIN(2250, 1080, 150, DRM_FORMAT_ARGB8888, 5),
+		},
+		.bw = { BTS_TEST_BW_FULL, BTS_TEST_BW_FULL,
+			BTS_TEST_BW_STATUSBAR, BTS_TEST_BW_NAVBAR },
+		.cur_freq = 2 * BTS_TEST_BW_FULL / BTS_TEST_BUS_WIDTH,
+		.best_freq = (BTS_TEST_BW_FULL + BTS_TEST_BW_NAVBAR) /
+			     BTS_TEST_BUS_WIDTH,
+		.best_dpp_id = { 0, 2, 1, 3 },
+	}, {
+		/* already balanced, the placement is kept */
+		.name = "video",
+		.win_cnt = 3,
+		.win = {
+			BTS_TEST_WIN(896, 1080, 608, DRM_FORMAT_NV12, 2,
+				     .src_w = 1920, .src_h = 1080),
+			BTS_TEST_WIN(0, 1080, 2400, DRM_FORMAT_ARGB8888, 0),
+			BTS_TEST_WIN(0, 1080, 100, DRM_FORMAT_ARGB8888, 3),
+		},
+		.bw = { BTS_TEST_BW_FHD_NV12, BTS_TEST_BW_FULL,
+			BTS_TEST_BW_STATUSBAR },
+		.cur_freq = BTS_TEST_BW_FULL / BTS_TEST_BUS_WIDTH,
+		.best_freq = BTS_TEST_BW_FULL / BTS_TEST_BUS_WIDTH,
+		.best_dpp_id = { 2, 0, 3 },
+	}, {
+		/* the secure layer stays, the rest moves around it */
+		.name = "secure video",
+		.win_cnt = 3,
+		.win = {
+			BTS_TEST_WIN(0, 1080, 2400, DRM_FORMAT_NV12, 4,
+				     .is_secure = true),
+			BTS_TEST_WIN(0, 1080, 2400, DRM_FORMAT_ARGB8888, 0),
+			BTS_TEST_WIN(2000, 1080, 200, DRM_FORMAT_ARGB8888, 1),
+		},
+		.bw = { BTS_TEST_BW_FULL_NV12, BTS_TEST_BW_FULL,
+			BTS_TEST_BW_SUBTITLE },
+		.cur_freq = (BTS_TEST_BW_FULL_NV12 + BTS_TEST_BW_FULL +
+			     BTS_TEST_BW_SUBTITLE) / BTS_TEST_BUS_WIDTH,
+		.best_freq = BTS_TEST_BW_FULL / BTS_TEST_BUS_WIDTH,
+		.best_dpp_id = { 4, 3, 0 },
+	},
+};
+
+static struct decon_device *bts_test_decon(struct kunit *test,
+					   const struct bts_test_stack *stack)
+{
+	struct decon_device *decon;
+	int i;
+
+	for (i = 0; i < MAX_DECON_CNT; i++)
+		if (get_decon_drvdata(i))
+			kunit_skip(test, "decon%d is probed, its bandwidth would add up", i);
+
+	decon = kunit_kzalloc(test, sizeof(*decon), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, decon);
+
+	decon->dpp_cnt = ARRAY_SIZE(bts_test_chs);
+	for (i = 0; i < decon->dpp_cnt; i++) {
+		struct dpp_device *dpp = kunit_kzalloc(test, sizeof(*dpp), GFP_KERNEL);
+
+		KUNIT_ASSERT_NOT_NULL(test, dpp);
+		dpp->id = i;
+		dpp->attr = bts_test_chs[i].attr;
+		dpp->decon_id = -1;
+		decon->dpp[i] = dpp;
+		decon->bts.rt_bw[i].ch_num = bts_test_chs[i].port;
+	}
+
+	decon->win_cnt = stack->win_cnt;
+	for (i = 0; i < stack->win_cnt; i++) {
+		decon->bts.win_config[i] = stack->win[i];
+		decon->bts.rt_bw[DPPCH2PLANE(stack->win[i].dpp_id)].val = stack->bw[i];
+	}
+
+	decon->bts.bus_width = BTS_TEST_BUS_WIDTH;
+	decon->bts.bus_util_pct = BTS_TEST_BUS_UTIL;
+	decon->bts.assign.enabled = true;
+
+	return decon;
+}
+
+static void dpu_bts_test_eval_recorded(struct kunit *test)
+{
+	int i, k;
+
+	for (i = 0; i < ARRAY_SIZE(bts_test_stacks); i++) {
+		const struct bts_test_stack *stack = &bts_test_stacks[i];
+		struct decon_device *decon = bts_test_decon(test, stack);
+		const struct dpu_bts_assign_eval *eval = &decon->bts.assign;
+		bool used[ARRAY_SIZE(bts_test_chs)] = { false };
+
+		dpu_bts_eval_assignment(decon, 0);
+
+		KUNIT_EXPECT_EQ_MSG(test, eval->eval_cnt, 1, "%s", stack->name);
+		KUNIT_EXPECT_EQ_MSG(test, eval->fail_cnt, 0, "%s", stack->name);
+		KUNIT_EXPECT_EQ_MSG(test, eval->better_cnt,
+				stack->best_freq < stack->cur_freq, "%s", stack->name);
+		KUNIT_EXPECT_EQ_MSG(test, eval->cur_freq, stack->cur_freq,
+				"%s", stack->name);
+		KUNIT_EXPECT_EQ_MSG(test, eval->best_freq, stack->best_freq,
+				"%s", stack->name);
+
+		for (k = 0; k < stack->win_cnt; k++) {
+			const u32 dpp_id = eval->best_dpp_id[k];
+			const unsigned long need = dpu_bts_win_required_attr(decon,
+						&stack->win[k]);
+
+			KUNIT_EXPECT_EQ_MSG(test, dpp_id, stack->best_dpp_id[k],
+					"%s win%d", stack->name, k);
+			KUNIT_ASSERT_LT(test, dpp_id, ARRAY_SIZE(bts_test_chs));
+			KUNIT_EXPECT_EQ_MSG(test, bts_test_chs[dpp_id].attr & need, need,
+					"%s win%d", stack->name, k);
+			KUNIT_EXPECT_FALSE_MSG(test, used[dpp_id], "%s win%d",
+					stack->name, k);
+			used[dpp_id] = true;
+
+			if (stack->win[k].is_secure)
+				KUNIT_EXPECT_EQ_MSG(test, dpp_id, stack->win[k].dpp_id,
+						"%s win%d", stack->name, k);
+		}
+	}
+}
+
+/* the operating clock is a floor for both placements */
+static void dpu_bts_test_eval_op_freq(struct kunit *test)
+{
+	const struct bts_test_stack *stack = &bts_test_stacks[0];
+	struct decon_device *decon = bts_test_decon(test, stack);
+	const struct dpu_bts_assign_eval *eval = &decon->bts.assign;
+
+	dpu_bts_eval_assignment(decon, stack->cur_freq + 1);
+
+	KUNIT_EXPECT_EQ(test, eval->eval_cnt, 1);
+	KUNIT_EXPECT_EQ(test, eval->better_cnt, 0);
+	KUNIT_EXPECT_EQ(test, eval->cur_freq, stack->cur_freq + 1);
+	KUNIT_EXPECT_EQ(test, eval->best_freq, stack->cur_freq + 1);
+}
+
+/*
+ * Greedy placement can hand the only rotating channel to a larger layer that
+ * had other options. That is counted as a failure, nothing is suggested.
+ */
+static void dpu_bts_test_eval_no_channel(struct kunit *test)
+{
+	static const struct bts_test_stack stack = {
+		.name = "rotated",
+		.win_cnt = 3,
+		.win = {
+			BTS_TEST_WIN(0, 1080, 100, DRM_FORMAT_ARGB8888, 0,
+				     .is_secure = true),
+			BTS_TEST_WIN(0, 1080, 2400, DRM_FORMAT_ARGB8888, 1,
+				     .is_comp = true),
+			BTS_TEST_WIN(0, 1080, 2400, DRM_FORMAT_ARGB8888, 2,
+				     .is_rot = true, .src_w = 2400, .src_h = 1080),
+		},
+		.bw = { BTS_TEST_BW_STATUSBAR, BTS_TEST_BW_FULL,
+			BTS_TEST_BW_FULL },
+	};
+	struct decon_device *decon = bts_test_decon(test, &stack);
+	const struct dpu_bts_assign_eval *eval = &decon->bts.assign;
+
+	dpu_bts_eval_assignment(decon, 0);
+
+	KUNIT_EXPECT_EQ(test, eval->fail_cnt, 1);
+	KUNIT_EXPECT_EQ(test, eval->eval_cnt, 0);
+	KUNIT_EXPECT_EQ(test, eval->better_cnt, 0);
+}
+
+static struct kunit_case dpu_bts_test_cases[] = {
+	KUNIT_CASE(dpu_bts_test_eval_recorded),
+	KUNIT_CASE(dpu_bts_test_eval_op_freq),
+	KUNIT_CASE(dpu_bts_test_eval_no_channel),
+	{}
+};
+
+static struct kunit_suite dpu_bts_test_suite = {
+	.name = "exynos-drm-bts",
+	.test_cases = dpu_bts_test_cases,
+};
+
+kunit_test_suite(dpu_bts_test_suite);
@@ -80,8 +80,8 @@ static struct exynos_matrix *exynos_drm_crtc_get_linear_matrix(struct drm_crtc_s
 
 	exynos_state = to_exynos_crtc_state(state);
 
-	if (exynos_state->linear_matrix) {
-		original = exynos_state->linear_matrix->data;
+	if (exynos_state->blobs->linear_matrix) {
+		original = exynos_state->blobs->linear_matrix->data;
 	} else {
 		original = NULL;
 	}
@@ -168,34 +168,34 @@ static void exynos_crtc_update_lut(struct drm_crtc *crtc,
 	exynos_state = to_exynos_crtc_state(state);
 	dqe_state = &exynos_state->dqe;
 
-	if (exynos_state->cgc_lut) {
-		cgc_lut = exynos_state->cgc_lut->data;
+	if (exynos_state->blobs->cgc_lut) {
+		cgc_lut = exynos_state->blobs->cgc_lut->data;
 		dqe_state->cgc_lut = cgc_lut;
 	} else {
 		dqe_state->cgc_lut = NULL;
 	}
 
-	if (exynos_state->disp_dither)
-		dqe_state->disp_dither_config = exynos_state->disp_dither->data;
+	if (exynos_state->blobs->disp_dither)
+		dqe_state->disp_dither_config = exynos_state->blobs->disp_dither->data;
 	else
 		dqe_state->disp_dither_config = NULL;
 
-	if (exynos_state->cgc_dither)
-		dqe_state->cgc_dither_config = exynos_state->cgc_dither->data;
+	if (exynos_state->blobs->cgc_dither)
+		dqe_state->cgc_dither_config = exynos_state->blobs->cgc_dither->data;
 	else
 		dqe_state->cgc_dither_config = NULL;
 
 	for (i = 0; i < HISTOGRAM_MAX; i++) {
-		if (exynos_state->histogram[i])
-			dqe_state->hist_chan[i].config = exynos_state->histogram[i]->data;
+		if (exynos_state->blobs->histogram[i])
+			dqe_state->hist_chan[i].config = exynos_state->blobs->histogram[i]->data;
 		else
 			dqe_state->hist_chan[i].config = NULL;
 	}
 
 	dqe_state->linear_matrix = exynos_drm_crtc_get_linear_matrix(state);
 
-	if (exynos_state->gamma_matrix)
-		dqe_state->gamma_matrix = exynos_state->gamma_matrix->data;
+	if (exynos_state->blobs->gamma_matrix)
+		dqe_state->gamma_matrix = exynos_state->blobs->gamma_matrix->data;
 	else
 		dqe_state->gamma_matrix = NULL;
 
@@ -213,7 +213,158 @@ static void exynos_crtc_update_lut(struct drm_crtc *crtc,
 		dqe_state->regamma_lut = NULL;
 	}
 
-	dqe_state->cgc_gem = exynos_state->cgc_gem;
+	dqe_state->cgc_gem = exynos_state->blobs->cgc_gem;
+}
+
+/*
+ * Whether anything affecting the content of the output frame differs between
+ * two plane states. The old state still holds its references, so equal fb and
+ * blob pointers are the very same objects.
+ */
+static bool exynos_plane_frame_equal(const struct drm_plane_state *new_state,
+				     const struct drm_plane_state *old_state)
+{
+	const struct exynos_drm_plane_state *new_exynos_state = to_exynos_plane_state(new_state);
+	const struct exynos_drm_plane_state *old_exynos_state = to_exynos_plane_state(old_state);
+	const struct exynos_plane_blobs *new_blobs = new_exynos_state->blobs;
+	const struct exynos_plane_blobs *old_blobs = old_exynos_state->blobs;
+
+	if (new_state->fb != old_state->fb ||
+	    new_state->crtc_x != old_state->crtc_x || new_state->crtc_y != old_state->crtc_y ||
+	    new_state->crtc_w != old_state->crtc_w || new_state->crtc_h != old_state->crtc_h ||
+	    new_state->src_x != old_state->src_x || new_state->src_y != old_state->src_y ||
+	    new_state->src_w != old_state->src_w || new_state->src_h != old_state->src_h ||
+	    new_state->rotation != old_state->rotation ||
+	    new_state->normalized_zpos != old_state->normalized_zpos ||
+	    new_state->alpha != old_state->alpha ||
+	    new_state->pixel_blend_mode != old_state->pixel_blend_mode)
+		return false;
+
+	if (new_exynos_state->standard != old_exynos_state->standard ||
+	    new_exynos_state->transfer != old_exynos_state->transfer ||
+	    new_exynos_state->range != old_exynos_state->range ||
+	    new_exynos_state->colormap != old_exynos_state->colormap ||
+	    new_exynos_state->max_luminance != old_exynos_state->max_luminance ||
+	    new_exynos_state->min_luminance != old_exynos_state->min_luminance)
+		return false;
+
+	return new_blobs == old_blobs ||
+	       (new_blobs->eotf_lut == old_blobs->eotf_lut &&
+		new_blobs->oetf_lut == old_blobs->oetf_lut &&
+		new_blobs->gm == old_blobs->gm &&
+		new_blobs->tm == old_blobs->tm &&
+		new_blobs->block == old_blobs->block);
+}
+
+static bool exynos_crtc_blobs_frame_equal(const struct exynos_crtc_blobs *new_blobs,
+					  const struct exynos_crtc_blobs *old_blobs)
+{
+	return new_blobs == old_blobs ||
+	       (new_blobs->cgc_lut == old_blobs->cgc_lut &&
+		new_blobs->disp_dither == old_blobs->disp_dither &&
+		new_blobs->cgc_dither == old_blobs->cgc_dither &&
+		new_blobs->linear_matrix == old_blobs->linear_matrix &&
+		new_blobs->linear_matrix_override == old_blobs->linear_matrix_override &&
+		new_blobs->gamma_matrix == old_blobs->gamma_matrix &&
+		new_blobs->cgc_gem == old_blobs->cgc_gem);
+}
+
+static bool exynos_crtc_frame_equal(const struct drm_crtc_state *new_crtc_state,
+				    const struct drm_crtc_state *old_crtc_state)
+{
+	const struct exynos_drm_crtc_state *new_exynos_state =
+						to_exynos_crtc_state(new_crtc_state);
+	const struct exynos_drm_crtc_state *old_exynos_state =
+						to_exynos_crtc_state(old_crtc_state);
+	const struct drm_plane_state *old_plane_state, *new_plane_state;
+	struct drm_plane *plane;
+	int i;
+
+	if (new_crtc_state->plane_mask != old_crtc_state->plane_mask ||
+	    new_crtc_state->degamma_lut != old_crtc_state->degamma_lut ||
+	    new_crtc_state->ctm != old_crtc_state->ctm ||
+	    new_crtc_state->gamma_lut != old_crtc_state->gamma_lut)
+		return false;
+
+	if (new_exynos_state->color_mode != old_exynos_state->color_mode ||
+	    new_exynos_state->in_bpc != old_exynos_state->in_bpc ||
+	    new_exynos_state->dqe.enabled != old_exynos_state->dqe.enabled ||
+	    !drm_rect_equals(&new_exynos_state->partial_region,
+			     &old_exynos_state->partial_region) ||
+	    !exynos_crtc_blobs_frame_equal(new_exynos_state->blobs, old_exynos_state->blobs))
+		return false;
+
+	/* planes which are not part of the commit keep their state */
+	for_each_oldnew_plane_in_state(new_crtc_state->state, plane, old_plane_state,
+				       new_plane_state, i) {
+		if (!(new_crtc_state->plane_mask & drm_plane_mask(plane)))
+			continue;
+
+		if (!exynos_plane_frame_equal(new_plane_state, old_plane_state))
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Skip the frame transfer for command mode panels if nothing affecting the
+ * frame content changed since the previous commit, and the same content was
+ * already proven by DSIM CRC to reproduce an identical frame. Commits with
+ * new acquire fences or writeback jobs are never skipped, and a frame is let
+ * through after dup.max_skips skips in a row so that in place updates of a
+ * buffer are caught by the CRC check.
+ */
+static void exynos_crtc_check_duplicate_frame(struct drm_crtc_state *crtc_state,
+					      const struct drm_crtc_state *old_crtc_state)
+{
+	struct exynos_drm_crtc_state *new_exynos_state = to_exynos_crtc_state(crtc_state);
+	const struct exynos_drm_crtc_state *old_exynos_state =
+						to_exynos_crtc_state(old_crtc_state);
+	struct decon_device *decon = to_exynos_crtc(crtc_state->crtc)->ctx;
+	const struct drm_plane_state *plane_state;
+	const struct drm_connector_state *conn_state;
+	struct drm_connector *conn;
+	struct drm_plane *plane;
+	int i;
+
+	/* sequence numbers are never reused, unlike fb ids or blob pointers */
+	if (old_exynos_state->frame_seq && exynos_crtc_frame_equal(crtc_state, old_crtc_state))
+		new_exynos_state->frame_seq = old_exynos_state->frame_seq;
+	else
+		new_exynos_state->frame_seq = atomic64_inc_return(&decon->dup.seq);
+
+	if (!READ_ONCE(decon->dup.enabled) || new_exynos_state->skip_update)
+		return;
+
+	if (decon->config.mode.op_mode != DECON_COMMAND_MODE || decon->keep_unmask)
+		return;
+
+	if (!crtc_state->active || drm_atomic_crtc_needs_modeset(crtc_state) ||
+	    crtc_state->color_mgmt_changed || crtc_state->self_refresh_active ||
+	    old_crtc_state->self_refresh_active || new_exynos_state->seamless_mode_changed)
+		return;
+
+	if (decon->dqe && decon->dqe->force_atc_config.dirty)
+		return;
+
+	/* a new acquire fence means the buffer content may have changed */
+	drm_atomic_crtc_state_for_each_plane_state(plane, plane_state, crtc_state)
+		if (plane_state->fence)
+			return;
+
+	for_each_new_connector_in_state(crtc_state->state, conn, conn_state, i)
+		if (conn_state->crtc == crtc_state->crtc && wb_check_job(conn_state))
+			return;
+
+	if (new_exynos_state->frame_seq != READ_ONCE(decon->dup.verified_seq))
+		return;
+
+	if (READ_ONCE(decon->dup.skip_streak) >= READ_ONCE(decon->dup.max_skips))
+		return;
+
+	new_exynos_state->skip_update = true;
+	new_exynos_state->dup_frame = true;
 }
 
 static int exynos_crtc_atomic_check(struct drm_crtc *crtc,
@@ -327,6 +478,8 @@ static int exynos_crtc_atomic_check(struct drm_crtc *crtc,
 		}
 	}
 
+	exynos_crtc_check_duplicate_frame(crtc_state, old_crtc_state);
+
 	DRM_DEBUG("%s -\n", __func__);
 
 	return 0;
@@ -442,29 +595,94 @@ static u32 exynos_drm_crtc_get_vblank_counter(struct drm_crtc *crtc)
 	return 0;
 }
 
+static struct kmem_cache *exynos_crtc_state_cache;
+static struct kmem_cache *exynos_crtc_blobs_cache;
+
+static struct exynos_crtc_blobs *exynos_crtc_blobs_alloc(struct drm_device *dev)
+{
+	struct exynos_crtc_blobs *blobs;
+
+	blobs = kmem_cache_zalloc(exynos_crtc_blobs_cache, GFP_KERNEL);
+	if (!blobs)
+		return NULL;
+
+	kref_init(&blobs->ref);
+	atomic_inc(&drm_to_exynos_dev(dev)->state_alloc_cnt);
+
+	return blobs;
+}
+
+static void exynos_crtc_blobs_release(struct kref *ref)
+{
+	struct exynos_crtc_blobs *blobs = container_of(ref, struct exynos_crtc_blobs, ref);
+	int i;
+
+	drm_property_blob_put(blobs->cgc_lut);
+	drm_property_blob_put(blobs->disp_dither);
+	drm_property_blob_put(blobs->cgc_dither);
+	drm_property_blob_put(blobs->linear_matrix);
+	drm_property_blob_put(blobs->linear_matrix_override);
+	drm_property_blob_put(blobs->gamma_matrix);
+	drm_property_blob_put(blobs->histogram_roi);
+	drm_property_blob_put(blobs->histogram_weights);
+	for (i = 0; i < HISTOGRAM_MAX; i++)
+		drm_property_blob_put(blobs->histogram[i]);
+
+	if (blobs->cgc_gem)
+		drm_gem_object_put(blobs->cgc_gem);
+
+	kmem_cache_free(exynos_crtc_blobs_cache, blobs);
+}
+
+/* returns blobs of the state which can be modified, copying them if they are shared */
+static struct exynos_crtc_blobs *
+exynos_crtc_blobs_get_writable(struct drm_crtc_state *state)
+{
+	struct exynos_drm_crtc_state *exynos_crtc_state = to_exynos_crtc_state(state);
+	struct exynos_crtc_blobs *old = exynos_crtc_state->blobs;
+	struct exynos_crtc_blobs *blobs;
+	int i;
+
+	if (kref_read(&old->ref) == 1)
+		return old;
+
+	blobs = exynos_crtc_blobs_alloc(state->crtc->dev);
+	if (!blobs)
+		return NULL;
+
+	blobs->cgc_lut = drm_property_blob_get(old->cgc_lut);
+	blobs->disp_dither = drm_property_blob_get(old->disp_dither);
+	blobs->cgc_dither = drm_property_blob_get(old->cgc_dither);
+	blobs->linear_matrix = drm_property_blob_get(old->linear_matrix);
+	blobs->linear_matrix_override = drm_property_blob_get(old->linear_matrix_override);
+	blobs->gamma_matrix = drm_property_blob_get(old->gamma_matrix);
+	blobs->histogram_roi = drm_property_blob_get(old->histogram_roi);
+	blobs->histogram_weights = drm_property_blob_get(old->histogram_weights);
+	for (i = 0; i < HISTOGRAM_MAX; i++)
+		blobs->histogram[i] = drm_property_blob_get(old->histogram[i]);
+
+	blobs->cgc_gem = old->cgc_gem;
+	if (blobs->cgc_gem)
+		drm_gem_object_get(blobs->cgc_gem);
+
+	kref_put(&old->ref, exynos_crtc_blobs_release);
+	exynos_crtc_state->blobs = blobs;
+
+	return blobs;
+}
+
 static void exynos_drm_crtc_destroy_state(struct drm_crtc *crtc,
 					struct drm_crtc_state *state)
 {
 	struct exynos_drm_crtc_state *exynos_crtc_state;
-	int i;
 
 	exynos_crtc_state = to_exynos_crtc_state(state);
-	drm_property_blob_put(exynos_crtc_state->cgc_lut);
-	drm_property_blob_put(exynos_crtc_state->disp_dither);
-	drm_property_blob_put(exynos_crtc_state->cgc_dither);
-	drm_property_blob_put(exynos_crtc_state->linear_matrix);
-	drm_property_blob_put(exynos_crtc_state->linear_matrix_override);
-	drm_property_blob_put(exynos_crtc_state->gamma_matrix);
-	drm_property_blob_put(exynos_crtc_state->histogram_roi);
-	drm_property_blob_put(exynos_crtc_state->histogram_weights);
+	if (exynos_crtc_state->blobs)
+		kref_put(&exynos_crtc_state->blobs->ref, exynos_crtc_blobs_release);
 	drm_property_blob_put(exynos_crtc_state->partial);
-	for (i = 0; i < HISTOGRAM_MAX; i++)
-		drm_property_blob_put(exynos_crtc_state->histogram[i]);
 
-	if (exynos_crtc_state->cgc_gem)
-		drm_gem_object_put(exynos_crtc_state->cgc_gem);
 	__drm_atomic_helper_crtc_destroy_state(state);
-	kfree(exynos_crtc_state);
+	kmem_cache_free(exynos_crtc_state_cache, exynos_crtc_state);
 }
 
 static void exynos_drm_crtc_reset(struct drm_crtc *crtc)
@@ -476,11 +694,17 @@ static void exynos_drm_crtc_reset(struct drm_crtc *crtc)
 		crtc->state = NULL;
 	}
 
-	exynos_crtc_state = kzalloc(sizeof(*exynos_crtc_state), GFP_KERNEL);
-	if (exynos_crtc_state) {
+	exynos_crtc_state = kmem_cache_zalloc(exynos_crtc_state_cache, GFP_KERNEL);
+	if (exynos_crtc_state)
+		exynos_crtc_state->blobs = exynos_crtc_blobs_alloc(crtc->dev);
+
+	if (exynos_crtc_state && exynos_crtc_state->blobs) {
 		exynos_crtc_state->dqe.enabled = true;
+		exynos_crtc_state->partial_fallback = PARTIAL_FALLBACK_NONE;
 		__drm_atomic_helper_crtc_reset(crtc, &exynos_crtc_state->base);
 	} else {
+		if (exynos_crtc_state)
+			kmem_cache_free(exynos_crtc_state_cache, exynos_crtc_state);
 		pr_err("failed to allocate exynos crtc state\n");
 	}
 }
@@ -488,51 +712,25 @@ static void exynos_drm_crtc_reset(struct drm_crtc *crtc)
 static struct drm_crtc_state *
 exynos_drm_crtc_duplicate_state(struct drm_crtc *crtc)
 {
+	struct exynos_drm_private *private = drm_to_exynos_dev(crtc->dev);
 	struct exynos_drm_crtc_state *exynos_crtc_state;
 	struct exynos_drm_crtc_state *copy;
-	int i;
 
 	exynos_crtc_state = to_exynos_crtc_state(crtc->state);
-	copy = kzalloc(sizeof(*copy), GFP_KERNEL);
+	copy = kmem_cache_alloc(exynos_crtc_state_cache, GFP_KERNEL);
 	if (!copy)
 		return NULL;
 
 	memcpy(copy, exynos_crtc_state, sizeof(*copy));
 
-	if (copy->cgc_lut)
-		drm_property_blob_get(copy->cgc_lut);
-
-	if (copy->disp_dither)
-		drm_property_blob_get(copy->disp_dither);
-
-	if (copy->cgc_dither)
-		drm_property_blob_get(copy->cgc_dither);
-
-	if (copy->linear_matrix)
-		drm_property_blob_get(copy->linear_matrix);
-
-	if (copy->linear_matrix_override)
-		drm_property_blob_get(copy->linear_matrix_override);
-
-	if (copy->gamma_matrix)
-		drm_property_blob_get(copy->gamma_matrix);
-
-	if (copy->histogram_roi)
-		drm_property_blob_get(copy->histogram_roi);
-
-	if (copy->histogram_weights)
-		drm_property_blob_get(copy->histogram_weights);
-
-	for (i = 0; i < HISTOGRAM_MAX; i++) {
-		if (copy->histogram[i])
-			drm_property_blob_get(copy->histogram[i]);
-	}
+	/* all DQE blobs and the CGC buffer are shared until modified */
+	kref_get(&copy->blobs->ref);
 
 	if (copy->partial)
 		drm_property_blob_get(copy->partial);
 
-	if (copy->cgc_gem)
-		drm_gem_object_get(copy->cgc_gem);
+	atomic_inc(&private->state_alloc_cnt);
+	atomic_inc(&private->state_ref_cnt);
 
 	__drm_atomic_helper_crtc_duplicate_state(crtc, &copy->base);
 
@@ -540,10 +738,35 @@ exynos_drm_crtc_duplicate_state(struct drm_crtc *crtc)
 	copy->skip_update = false;
 	copy->planes_updated = false;
 	copy->hibernation_exit = false;
+	copy->dup_frame = false;
+	copy->partial_expanded = 0;
+	copy->partial_fallback = PARTIAL_FALLBACK_NONE;
+	copy->fence_join = NULL;
+	memset(copy->frame_ts, 0, sizeof(copy->frame_ts));
 
 	return &copy->base;
 }
 
+int exynos_drm_crtc_init_caches(void)
+{
+	exynos_crtc_state_cache = KMEM_CACHE(exynos_drm_crtc_state, 0);
+	exynos_crtc_blobs_cache = KMEM_CACHE(exynos_crtc_blobs, 0);
+	if (!exynos_crtc_state_cache || !exynos_crtc_blobs_cache) {
+		exynos_drm_crtc_destroy_caches();
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+void exynos_drm_crtc_destroy_caches(void)
+{
+	kmem_cache_destroy(exynos_crtc_blobs_cache);
+	kmem_cache_destroy(exynos_crtc_state_cache);
+	exynos_crtc_blobs_cache = NULL;
+	exynos_crtc_state_cache = NULL;
+}
+
 struct drm_atomic_state
 *exynos_duplicate_active_crtc_state(struct drm_crtc *crtc,
 				struct drm_modeset_acquire_ctx *ctx)
@@ -711,12 +934,32 @@ exynos_drm_replace_property_blob_from_id(struct drm_device *dev,
 	return 0;
 }
 
+/* replace one of the DQE blobs, which are copied first if still shared */
+static int exynos_crtc_replace_blob(struct drm_crtc_state *state, size_t offset,
+				    uint64_t blob_id, ssize_t expected_size, bool *replaced)
+{
+	struct exynos_crtc_blobs *blobs = to_exynos_crtc_state(state)->blobs;
+	struct drm_property_blob **blob = (void *)blobs + offset;
+
+	/* setting the current blob again must not unshare them */
+	if ((*blob ? (*blob)->base.id : 0) == blob_id)
+		return 0;
+
+	blobs = exynos_crtc_blobs_get_writable(state);
+	if (!blobs)
+		return -ENOMEM;
+
+	return exynos_drm_replace_property_blob_from_id(state->crtc->dev,
+			(void *)blobs + offset, blob_id, expected_size, -1, replaced);
+}
+
 static int exynos_drm_crtc_set_property(struct drm_crtc *crtc,
 					struct drm_crtc_state *state,
 					struct drm_property *property,
 					uint64_t val)
 {
 	struct exynos_drm_crtc *exynos_crtc = to_exynos_crtc(crtc);
+	const struct decon_device *decon = exynos_crtc->ctx;
 	struct exynos_drm_crtc_state *exynos_crtc_state;
 	int ret = 0;
 	bool replaced = false;
@@ -742,29 +985,29 @@ static int exynos_drm_crtc_set_property(struct drm_crtc *crtc,
 			replaced = true;
 		}
 	} else if (property == exynos_crtc->props.cgc_lut) {
-		ret = exynos_drm_replace_property_blob_from_id(state->crtc->dev,
-				&exynos_crtc_state->cgc_lut, val,
-				sizeof(struct cgc_lut), -1, &replaced);
+		ret = exynos_crtc_replace_blob(state,
+				offsetof(struct exynos_crtc_blobs, cgc_lut),
+				val, sizeof(struct cgc_lut), &replaced);
 	} else if (property == exynos_crtc->props.disp_dither) {
-		ret = exynos_drm_replace_property_blob_from_id(state->crtc->dev,
-				&exynos_crtc_state->disp_dither, val,
-				sizeof(struct dither_config), -1, &replaced);
+		ret = exynos_crtc_replace_blob(state,
+				offsetof(struct exynos_crtc_blobs, disp_dither),
+				val, sizeof(struct dither_config), &replaced);
 	} else if (property == exynos_crtc->props.cgc_dither) {
-		ret = exynos_drm_replace_property_blob_from_id(state->crtc->dev,
-				&exynos_crtc_state->cgc_dither, val,
-				sizeof(struct dither_config), -1, &replaced);
+		ret = exynos_crtc_replace_blob(state,
+				offsetof(struct exynos_crtc_blobs, cgc_dither),
+				val, sizeof(struct dither_config), &replaced);
 	} else if (property == exynos_crtc->props.linear_matrix) {
-		ret = exynos_drm_replace_property_blob_from_id(state->crtc->dev,
-				&exynos_crtc_state->linear_matrix, val,
-				sizeof(struct exynos_matrix), -1, &replaced);
+		ret = exynos_crtc_replace_blob(state,
+				offsetof(struct exynos_crtc_blobs, linear_matrix),
+				val, sizeof(struct exynos_matrix), &replaced);
 	} else if (property == exynos_crtc->props.linear_matrix_override) {
 		/* This blob will never get any non-null value set as we cannot
 		 * commit changes from the panel driver. Force a change here
 		 * so that setting null matrix works.
 		 */
-		ret = exynos_drm_replace_property_blob_from_id(state->crtc->dev,
-				&exynos_crtc_state->linear_matrix_override, val,
-				sizeof(struct exynos_matrix), -1, &replaced);
+		ret = exynos_crtc_replace_blob(state,
+				offsetof(struct exynos_crtc_blobs, linear_matrix_override),
+				val, sizeof(struct exynos_matrix), &replaced);
 
 		replaced = true;
 
@@ -773,23 +1016,26 @@ static int exynos_drm_crtc_set_property(struct drm_crtc *crtc,
 		} else {
 			linear_matrix_override_enabled = 1;
 			memcpy(&linear_matrix_override,
-					exynos_crtc_state->linear_matrix_override->data,
+					exynos_crtc_state->blobs->linear_matrix_override->data,
 					sizeof(linear_matrix_override));
 		}
+	} else if (property == exynos_crtc->props.linear_matrix_transition_ms) {
+		/* only affects how later linear matrix changes are applied */
+		exynos_crtc_state->dqe.linear_matrix_ms = val;
 	} else if (property == exynos_crtc->props.gamma_matrix) {
-		ret = exynos_drm_replace_property_blob_from_id(state->crtc->dev,
-				&exynos_crtc_state->gamma_matrix, val,
-				sizeof(struct exynos_matrix), -1, &replaced);
+		ret = exynos_crtc_replace_blob(state,
+				offsetof(struct exynos_crtc_blobs, gamma_matrix),
+				val, sizeof(struct exynos_matrix), &replaced);
 	} else if (property == exynos_crtc->props.histogram_roi) {
 		pr_warn_once("legacy property(%s): ignored\n", property->name);
-		ret = exynos_drm_replace_property_blob_from_id(state->crtc->dev,
-				&exynos_crtc_state->histogram_roi, val,
-				sizeof(struct histogram_roi), -1, &replaced);
+		ret = exynos_crtc_replace_blob(state,
+				offsetof(struct exynos_crtc_blobs, histogram_roi),
+				val, sizeof(struct histogram_roi), &replaced);
 	} else if (property == exynos_crtc->props.histogram_weights) {
 		pr_warn_once("legacy property(%s): ignored\n", property->name);
-		ret = exynos_drm_replace_property_blob_from_id(state->crtc->dev,
-				&exynos_crtc_state->histogram_weights, val,
-				sizeof(struct histogram_weights), -1, &replaced);
+		ret = exynos_crtc_replace_blob(state,
+				offsetof(struct exynos_crtc_blobs, histogram_weights),
+				val, sizeof(struct histogram_weights), &replaced);
 	} else if (property == exynos_crtc->props.histogram_pos) {
 		pr_warn_once("legacy property(%s): ignored\n", property->name);
 		if (val != exynos_crtc_state->dqe.histogram_pos) {
@@ -808,9 +1054,9 @@ static int exynos_drm_crtc_set_property(struct drm_crtc *crtc,
 		ret = -EINVAL; /* assume an error by default */
 		for (i = 0; i < HISTOGRAM_MAX; i++) {
 			if (property == exynos_crtc->props.histogram[i]) {
-				ret = exynos_drm_replace_property_blob_from_id(state->crtc->dev,
-					&exynos_crtc_state->histogram[i], val,
-					sizeof(struct histogram_channel_config), -1, &replaced);
+				ret = exynos_crtc_replace_blob(state,
+					offsetof(struct exynos_crtc_blobs, histogram[i]),
+					val, sizeof(struct histogram_channel_config), &replaced);
 				break;
 			}
 		}
@@ -820,10 +1066,19 @@ static int exynos_drm_crtc_set_property(struct drm_crtc *crtc,
 				sizeof(struct drm_clip_rect), -1, &replaced);
 		return ret;
 	} else if (property == exynos_crtc->props.cgc_lut_fd) {
-		if (exynos_crtc_state->cgc_gem)
-			drm_gem_object_put(exynos_crtc_state->cgc_gem);
-		exynos_crtc_state->cgc_gem = (U642I64(val) >= 0) ?
-			exynos_drm_gem_fd_to_obj(crtc->dev, U642I64(val)) : NULL;
+		struct exynos_crtc_blobs *blobs = exynos_crtc_blobs_get_writable(state);
+
+		if (!blobs)
+			return -ENOMEM;
+
+		if (blobs->cgc_gem)
+			drm_gem_object_put(blobs->cgc_gem);
+		if (U642I64(val) < 0)
+			blobs->cgc_gem = NULL;
+		else if (decon->dqe)
+			blobs->cgc_gem = exynos_dqe_cgc_gem_get(decon->dqe, U642I64(val));
+		else
+			blobs->cgc_gem = exynos_drm_gem_fd_to_obj(crtc->dev, U642I64(val));
 		replaced = true;
 	} else if (property == exynos_crtc->props.expected_present_time) {
 		exynos_crtc_state->expected_present_time = val;
@@ -858,39 +1113,41 @@ static int exynos_drm_crtc_get_property(struct drm_crtc *crtc,
 	} else if (property == exynos_crtc->props.dqe_enabled) {
 		*val = exynos_crtc_state->dqe.enabled;
 	} else if (property == exynos_crtc->props.cgc_lut) {
-		*val = (exynos_crtc_state->cgc_lut) ?
-			exynos_crtc_state->cgc_lut->base.id : 0;
+		*val = (exynos_crtc_state->blobs->cgc_lut) ?
+			exynos_crtc_state->blobs->cgc_lut->base.id : 0;
 	} else if (property == exynos_crtc->props.disp_dither) {
-		*val = (exynos_crtc_state->disp_dither) ?
-			exynos_crtc_state->disp_dither->base.id : 0;
+		*val = (exynos_crtc_state->blobs->disp_dither) ?
+			exynos_crtc_state->blobs->disp_dither->base.id : 0;
 	} else if (property == exynos_crtc->props.cgc_dither) {
-		*val = (exynos_crtc_state->cgc_dither) ?
-			exynos_crtc_state->cgc_dither->base.id : 0;
+		*val = (exynos_crtc_state->blobs->cgc_dither) ?
+			exynos_crtc_state->blobs->cgc_dither->base.id : 0;
 	} else if (property == exynos_crtc->props.linear_matrix) {
-		*val = (exynos_crtc_state->linear_matrix) ?
-			exynos_crtc_state->linear_matrix->base.id : 0;
+		*val = (exynos_crtc_state->blobs->linear_matrix) ?
+			exynos_crtc_state->blobs->linear_matrix->base.id : 0;
 	} else if (property == exynos_crtc->props.linear_matrix_override) {
-		*val = (exynos_crtc_state->linear_matrix_override) ?
-			exynos_crtc_state->linear_matrix_override->base.id : 0;
+		*val = (exynos_crtc_state->blobs->linear_matrix_override) ?
+			exynos_crtc_state->blobs->linear_matrix_override->base.id : 0;
+	} else if (property == exynos_crtc->props.linear_matrix_transition_ms) {
+		*val = exynos_crtc_state->dqe.linear_matrix_ms;
 	} else if (property == exynos_crtc->props.gamma_matrix) {
-		*val = (exynos_crtc_state->gamma_matrix) ?
-			exynos_crtc_state->gamma_matrix->base.id : 0;
+		*val = (exynos_crtc_state->blobs->gamma_matrix) ?
+			exynos_crtc_state->blobs->gamma_matrix->base.id : 0;
 	} else if (property == exynos_crtc->props.partial) {
 		*val = (exynos_crtc_state->partial) ?
 			exynos_crtc_state->partial->base.id : 0;
 	} else if (property == exynos_crtc->props.cgc_lut_fd) {
-		*val =  (exynos_crtc_state->cgc_gem) ?
-			dma_buf_fd(exynos_crtc_state->cgc_gem->dma_buf, 0) : 0;
+		*val =  (exynos_crtc_state->blobs->cgc_gem) ?
+			dma_buf_fd(exynos_crtc_state->blobs->cgc_gem->dma_buf, 0) : 0;
 	} else if (property == exynos_crtc->props.expected_present_time) {
 		*val = exynos_crtc_state->expected_present_time;
 	} else if (property == exynos_crtc->props.rcd_plane_id) {
 		*val = decon->rcd->plane.base.base.id;
 	} else if (property == exynos_crtc->props.histogram_roi) {
-		*val = (exynos_crtc_state->histogram_roi) ?
-			exynos_crtc_state->histogram_roi->base.id : 0;
+		*val = (exynos_crtc_state->blobs->histogram_roi) ?
+			exynos_crtc_state->blobs->histogram_roi->base.id : 0;
 	} else if (property == exynos_crtc->props.histogram_weights) {
-		*val = (exynos_crtc_state->histogram_weights) ?
-			exynos_crtc_state->histogram_weights->base.id : 0;
+		*val = (exynos_crtc_state->blobs->histogram_weights) ?
+			exynos_crtc_state->blobs->histogram_weights->base.id : 0;
 	} else if (property == exynos_crtc->props.histogram_pos) {
 		*val = exynos_crtc_state->dqe.histogram_pos;
 	} else if (property == exynos_crtc->props.histogram_threshold) {
@@ -906,7 +1163,7 @@ static int exynos_drm_crtc_get_property(struct drm_crtc *crtc,
 				struct exynos_dqe *dqe = decon->dqe;
 				struct histogram_chan_state *hist_chan = &dqe->state.hist_chan[i];
 
-				*val = (exynos_crtc_state->histogram[i] || hist_chan->cb) ? 1 : 0;
+				*val = (exynos_crtc_state->blobs->histogram[i] || hist_chan->cb) ? 1 : 0;
 				return 0;
 			}
 		}
@@ -1296,6 +1553,12 @@ struct exynos_drm_crtc *exynos_drm_crtc_create(struct drm_device *drm_dev,
 		if (ret)
 			goto err_crtc;
 
+		ret = exynos_drm_crtc_create_range(crtc, "linear_matrix_transition_ms",
+				&exynos_crtc->props.linear_matrix_transition_ms, 0,
+				LINEAR_MATRIX_TRANSITION_MAX_MS);
+		if (ret)
+			goto err_crtc;
+
 		ret = exynos_drm_crtc_create_blob(crtc, "gamma_matrix",
 				&exynos_crtc->props.gamma_matrix);
 		if (ret)
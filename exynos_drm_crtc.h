@@ -74,4 +74,6 @@ struct drm_atomic_state
 		struct drm_modeset_acquire_ctx *ctx);
 int exynos_crtc_resume(struct drm_atomic_state *state,
 				struct drm_modeset_acquire_ctx *ctx);
+int exynos_drm_crtc_init_caches(void);
+void exynos_drm_crtc_destroy_caches(void);
 #endif
@@ -16,6 +16,8 @@
 #include <linux/moduleparam.h>
 #include <linux/pm_runtime.h>
 #include <linux/sched/clock.h>
+#include <linux/slab.h>
+#include <linux/sort.h>
 #include <linux/sysfs.h>
 #include <linux/time.h>
 #include <video/mipi_display.h>
@@ -46,6 +48,9 @@
 #include "exynos_drm_dsim.h"
 #include "exynos_drm_writeback.h"
 
+#define CREATE_TRACE_POINTS
+#include "exynos_drm_trace.h"
+
 /* Default is 1024 entries array for event log buffer */
 static unsigned int dpu_event_log_max = 1024;
 static unsigned int dpu_event_print_max = 512;
@@ -353,6 +358,15 @@ void DPU_EVENT_LOG(enum dpu_event_type type, int index, void *priv)
 	case DPU_EVT_TE_INTERRUPT:
 		log->data.value = decon->d.te_cnt;
 		break;
+	case DPU_EVT_DUP_FRAME_SKIP:
+		log->data.value = decon->dup.skip_cnt;
+		break;
+	case DPU_EVT_DUP_FRAME_VERIFY:
+		log->data.value = *(bool *)priv;
+		break;
+	case DPU_EVT_FENCE_JOIN:
+		memcpy(&log->data.fence_join, priv, sizeof(struct dpu_log_fence_join));
+		break;
 	default:
 		break;
 	}
@@ -618,6 +632,9 @@ static const char *get_event_name(enum dpu_event_type type)
 		"CGC_FRAMEDONE",
 		"ITMON_ERROR",
 		"SYSMMU_FAULT",
+		"DUP_FRAME_SKIP",
+		"DUP_FRAME_VERIFY",
+		"FENCE_JOIN",
 	};
 
 	if (type >= DPU_EVT_MAX)
@@ -955,6 +972,26 @@ static void dpu_event_log_print(const struct decon_device *decon, struct drm_pri
 					"\tecc count(%u)",
 					log->data.value);
 			break;
+		case DPU_EVT_DUP_FRAME_SKIP:
+			scnprintf(buf + len, sizeof(buf) - len,
+					"\tskip count(%u)",
+					log->data.value);
+			break;
+		case DPU_EVT_DUP_FRAME_VERIFY:
+			scnprintf(buf + len, sizeof(buf) - len,
+					"\tcrc %s",
+					log->data.value ? "match" : "mismatch");
+			break;
+		case DPU_EVT_FENCE_JOIN:
+			scnprintf(buf + len, sizeof(buf) - len,
+					"\tfences(%u) wait(%uus) last CH:%d %llu-%llu%s",
+					log->data.fence_join.num_fences,
+					log->data.fence_join.wait_us,
+					log->data.fence_join.plane_idx,
+					log->data.fence_join.context,
+					log->data.fence_join.seqno,
+					log->data.fence_join.timeout ? " TIMEOUT" : "");
+			break;
 		case DPU_EVT_TE_INTERRUPT:
 			scnprintf(buf + len, sizeof(buf) - len,
 					"\tte cnt(%u)",
@@ -1299,6 +1336,67 @@ static void exynos_debugfs_add_lut(const char *name, umode_t mode,
 	debugfs_create_file(name, mode, parent, lut, &lut_fops);
 }
 
+static int cgc_dma_stats_show(struct seq_file *s, void *unused)
+{
+	const struct cgc_debug_override *cgc = s->private;
+	const struct cgc_dma_stats *stats = &cgc->stats;
+
+	seq_printf(s, "early=%u late=%u timeout=%u\n", stats->early_cnt,
+		   stats->late_cnt, stats->timeout_cnt);
+	seq_printf(s, "commit: cnt=%u avg=%lluus max=%uus\n", stats->cnt,
+		   stats->cnt ? div_u64(stats->total_us, stats->cnt) : 0, stats->max_us);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(cgc_dma_stats);
+
+static int cgc_cache_stats_show(struct seq_file *s, void *unused)
+{
+	struct cgc_cache *cache = s->private;
+	const struct cgc_cache_stats *stats = &cache->stats;
+	const u32 hit_cnt = stats->buf_hit_cnt;
+	int i;
+
+	seq_printf(s, "hit: cnt=%u avg=%lluus max=%uus\n", hit_cnt,
+		   hit_cnt ? div_u64(stats->hit_total_us, hit_cnt) : 0, stats->hit_max_us);
+	seq_printf(s, "miss: cnt=%u avg=%lluus max=%uus\n", stats->miss_cnt,
+		   stats->miss_cnt ? div_u64(stats->miss_total_us, stats->miss_cnt) : 0,
+		   stats->miss_max_us);
+	seq_printf(s, "evict=%u dma_skip=%u\n", stats->evict_cnt, stats->dma_skip_cnt);
+
+	mutex_lock(&cache->lock);
+	for (i = 0; i < CGC_CACHE_SLOT_CNT; i++) {
+		const struct cgc_cache_slot *slot = &cache->slots[i];
+
+		if (!slot->gem)
+			continue;
+
+		seq_printf(s, "slot%d: hash=%016llx last_use=%llu%s%s\n", i, slot->hash,
+			   slot->last_use, slot->gem == cache->active ? " active" : "",
+			   slot->gem == cache->pending ? " pending" : "");
+	}
+	mutex_unlock(&cache->lock);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(cgc_cache_stats);
+
+static int matrix_transition_show(struct seq_file *s, void *unused)
+{
+	const struct matrix_transition *tr = s->private;
+	const struct matrix_transition_stats *stats = &tr->stats;
+
+	seq_printf(s, "state: %s\n", !tr->active ? "idle" : tr->paused ? "paused" : "active");
+	if (tr->active)
+		seq_printf(s, "elapsed=%uus duration=%uus%s\n", tr->elapsed_us,
+			   tr->duration_us, tr->to_bypass ? " to_bypass" : "");
+	seq_printf(s, "start=%u done=%u cancel=%u pause=%u step=%u\n", stats->start_cnt,
+		   stats->done_cnt, stats->cancel_cnt, stats->pause_cnt, stats->step_cnt);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(matrix_transition);
+
 #define DEFAULT_PRINT_CNT	128
 static struct dentry *
 exynos_debugfs_add_cgc(struct cgc_debug_override *cgc, struct dentry *parent,
@@ -1317,6 +1415,7 @@ exynos_debugfs_add_cgc(struct cgc_debug_override *cgc, struct dentry *parent,
 	debugfs_create_bool("verbose", 0664, dent, &info->verbose);
 	debugfs_create_u32("verbose_count", 0664, dent, &cgc->verbose_cnt);
 	cgc->verbose_cnt = DEFAULT_PRINT_CNT;
+	debugfs_create_file("dma_stats", 0444, dent, cgc, &cgc_dma_stats_fops);
 	exynos_debugfs_add_dump(DUMP_TYPE_CGC_LUT, 0444, dent, 0, 0, drm);
 
 	dent_lut = debugfs_create_dir("lut", dent);
@@ -1468,7 +1567,7 @@ exynos_debugfs_add_matrix(struct matrix_debug_override *matrix,
 static void
 exynos_debugfs_add_dqe(struct exynos_dqe *dqe, struct dentry *parent)
 {
-	struct dentry *dent_dir;
+	struct dentry *dent_dir, *dent;
 	struct matrix_debug_override *gamma = &dqe->gamma;
 	struct matrix_debug_override *linear = &dqe->linear;
 	struct drm_device *drm = dqe->decon->drm_dev;
@@ -1492,7 +1591,10 @@ exynos_debugfs_add_dqe(struct exynos_dqe *dqe, struct dentry *parent)
 			&dqe->disp_dither_override, dent_dir, drm))
 		goto err;
 
-	exynos_debugfs_add_cgc(&dqe->cgc, dent_dir, drm);
+	dent = exynos_debugfs_add_cgc(&dqe->cgc, dent_dir, drm);
+	if (dent)
+		debugfs_create_file("cache", 0444, dent, &dqe->cgc_cache,
+				    &cgc_cache_stats_fops);
 	exynos_debugfs_add_regamma(&dqe->regamma, dent_dir, drm);
 	exynos_debugfs_add_degamma(&dqe->degamma, dent_dir, drm);
 
@@ -1502,9 +1604,12 @@ exynos_debugfs_add_dqe(struct exynos_dqe *dqe, struct dentry *parent)
 	if (!exynos_debugfs_add_histogram(dqe, dent_dir, drm))
 		goto err;
 
-	if (!exynos_debugfs_add_matrix(linear, "linear_matrix", dent_dir,
-				DUMP_TYPE_LINEAR_MATRIX, drm))
+	dent = exynos_debugfs_add_matrix(linear, "linear_matrix", dent_dir,
+				DUMP_TYPE_LINEAR_MATRIX, drm);
+	if (!dent)
 		goto err;
+	debugfs_create_file("transition", 0444, dent, &dqe->linear_tr,
+			    &matrix_transition_fops);
 
 	if (!exynos_debugfs_add_matrix(gamma, "gamma_matrix", dent_dir,
 				DUMP_TYPE_GAMMA_MATRIX, drm))
@@ -1609,8 +1714,19 @@ static const struct attribute *decon_debug_attrs[] = {
 static int recovery_show(struct seq_file *s, void *unused)
 {
 	struct decon_device *decon = s->private;
+	const struct exynos_recovery *recovery = &decon->recovery;
+	int i;
+
+	seq_printf(s, "%d\n", recovery->count);
+
+	for (i = 0; i < EXYNOS_RECOVERY_TIER_CNT; i++) {
+		const struct exynos_recovery_tier_stats *stats = &recovery->stats[i];
 
-	seq_printf(s, "%d\n", decon->recovery.count);
+		seq_printf(s, "%s: attempts=%u successes=%u avg=%lluus max=%uus\n",
+			   exynos_recovery_tier_name(i), stats->attempts, stats->successes,
+			   stats->attempts ? div_u64(stats->total_us, stats->attempts) : 0,
+			   stats->max_us);
+	}
 
 	return 0;
 }
@@ -1639,6 +1755,299 @@ static const struct file_operations recovery_fops = {
 	.release = seq_release,
 };
 
+static int partial_stats_show(struct seq_file *s, void *unused)
+{
+	struct decon_device *decon = s->private;
+	struct drm_printer p = drm_seq_file_printer(s);
+
+	if (!decon->partial) {
+		drm_printf(&p, "partial update is not enabled\n");
+		return 0;
+	}
+
+	exynos_partial_print_stats(decon->partial, &p);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(partial_stats);
+
+static void decon_timeline_drop_locked(struct decon_frame_timeline *tl, u64 upto)
+{
+	tl->reported = max(tl->reported, upto);
+	tl->started = max(tl->started, tl->reported);
+	tl->done = max(tl->done, tl->reported);
+}
+
+/* queue a triggered frame with the stamps collected on the commit side */
+void decon_timeline_queue_locked(struct decon_device *decon, const ktime_t *frame_ts)
+{
+	struct decon_frame_timeline *tl = &decon->timeline;
+	ktime_t *ts;
+
+	/* the oldest frame never completed, it would be overwritten */
+	if (tl->queued - tl->reported >= DECON_TIMELINE_DEPTH)
+		decon_timeline_drop_locked(tl, tl->queued - DECON_TIMELINE_DEPTH + 1);
+
+	ts = tl->ts[tl->queued % DECON_TIMELINE_DEPTH];
+	memcpy(ts, frame_ts, sizeof(ktime_t) * EXYNOS_FRAME_START);
+	ts[EXYNOS_FRAME_START] = 0;
+	ts[EXYNOS_FRAME_DONE] = 0;
+	tl->queued++;
+}
+
+void decon_timeline_stamp_locked(struct decon_device *decon,
+				 enum exynos_frame_stage stage, ktime_t ts)
+{
+	struct decon_frame_timeline *tl = &decon->timeline;
+
+	/* frame start/done of frames which weren't triggered by a commit are ignored */
+	if (stage == EXYNOS_FRAME_START && tl->started < tl->queued)
+		tl->ts[tl->started++ % DECON_TIMELINE_DEPTH][stage] = ts;
+	else if (stage == EXYNOS_FRAME_DONE && tl->done < tl->started)
+		tl->ts[tl->done++ % DECON_TIMELINE_DEPTH][stage] = ts;
+}
+
+void decon_timeline_reset_locked(struct decon_device *decon)
+{
+	decon_timeline_drop_locked(&decon->timeline, decon->timeline.queued);
+}
+
+static void decon_timeline_hist_add(struct decon_timeline_hist *hist, s64 us)
+{
+	const u32 val = clamp_t(s64, us, 0, U32_MAX);
+
+	hist->buckets[min_t(u32, fls(val), DECON_TIMELINE_BUCKETS - 1)]++;
+	hist->cnt++;
+	hist->max_us = max(hist->max_us, val);
+}
+
+/* account frames which completed, called from the irq bottom half */
+void decon_timeline_report_locked(struct decon_device *decon)
+{
+	struct decon_frame_timeline *tl = &decon->timeline;
+	ktime_t *ts;
+	int i;
+
+	for (; tl->reported < tl->done; tl->reported++) {
+		ts = tl->ts[tl->reported % DECON_TIMELINE_DEPTH];
+
+		/* stages that were skipped (e.g. no fences) take the next stamp */
+		for (i = EXYNOS_FRAME_STAGE_CNT - 2; i >= 0; i--)
+			if (!ts[i])
+				ts[i] = ts[i + 1];
+
+		decon_timeline_hist_add(&tl->hist[0],
+				ktime_us_delta(ts[EXYNOS_FRAME_DONE], ts[EXYNOS_FRAME_COMMIT]));
+		for (i = 1; i < EXYNOS_FRAME_STAGE_CNT; i++)
+			decon_timeline_hist_add(&tl->hist[i], ktime_us_delta(ts[i], ts[i - 1]));
+
+		trace_exynos_frame_timeline(decon->id, tl->reported, ts);
+	}
+}
+
+/* upper bound of the bucket holding the given percentile */
+static u32 decon_timeline_hist_pct(const struct decon_timeline_hist *hist, u32 pct)
+{
+	const u32 target = DIV_ROUND_UP(hist->cnt * pct, 100);
+	u32 sum = 0;
+	int i;
+
+	for (i = 0; i < DECON_TIMELINE_BUCKETS; i++) {
+		sum += hist->buckets[i];
+		if (sum >= target)
+			return min_t(u32, 1U << i, hist->max_us);
+	}
+
+	return hist->max_us;
+}
+
+static int frame_timeline_show(struct seq_file *s, void *unused)
+{
+	static const char * const names[EXYNOS_FRAME_STAGE_CNT] = {
+		[0]			= "total",
+		[EXYNOS_FRAME_TAIL]	= "tail",
+		[EXYNOS_FRAME_FENCE]	= "fence",
+		[EXYNOS_FRAME_EPT]	= "ept",
+		[EXYNOS_FRAME_TRIGGER]	= "trigger",
+		[EXYNOS_FRAME_START]	= "start",
+		[EXYNOS_FRAME_DONE]	= "done",
+	};
+	struct decon_device *decon = s->private;
+	struct decon_timeline_hist *hist;
+	unsigned long flags;
+	int i;
+
+	hist = kmalloc(sizeof(decon->timeline.hist), GFP_KERNEL);
+	if (!hist)
+		return -ENOMEM;
+
+	spin_lock_irqsave(&decon->slock, flags);
+	memcpy(hist, decon->timeline.hist, sizeof(decon->timeline.hist));
+	spin_unlock_irqrestore(&decon->slock, flags);
+
+	seq_puts(s, "stage     frames   p50(us)   p90(us)   p99(us)   max(us)\n");
+	for (i = 0; i < EXYNOS_FRAME_STAGE_CNT; i++)
+		seq_printf(s, "%-8s %7u %9u %9u %9u %9u\n", names[i], hist[i].cnt,
+			   decon_timeline_hist_pct(&hist[i], 50),
+			   decon_timeline_hist_pct(&hist[i], 90),
+			   decon_timeline_hist_pct(&hist[i], 99), hist[i].max_us);
+
+	kfree(hist);
+
+	return 0;
+}
+
+static ssize_t frame_timeline_write(struct file *file, const char __user *buf,
+				    size_t len, loff_t *unused)
+{
+	struct seq_file *s = file->private_data;
+	struct decon_device *decon = s->private;
+	unsigned long flags;
+
+	/* any write clears the histograms */
+	spin_lock_irqsave(&decon->slock, flags);
+	memset(decon->timeline.hist, 0, sizeof(decon->timeline.hist));
+	spin_unlock_irqrestore(&decon->slock, flags);
+
+	return len;
+}
+
+static int frame_timeline_open(struct inode *inode, struct file *file)
+{
+	return single_open(file, frame_timeline_show, inode->i_private);
+}
+
+static const struct file_operations frame_timeline_fops = {
+	.open = frame_timeline_open,
+	.read = seq_read,
+	.write = frame_timeline_write,
+	.llseek = seq_lseek,
+	.release = single_release,
+};
+
+static int irq_lat_cmp(const void *a, const void *b)
+{
+	const u32 l = *(const u32 *)a, r = *(const u32 *)b;
+
+	return l < r ? -1 : l > r;
+}
+
+static void irq_lat_print(struct seq_file *s, const char *name,
+			  const struct decon_irq_lat *lat)
+{
+	const u32 cnt = min_t(u32, atomic_read(&lat->cnt), DECON_IRQ_LAT_SAMPLES);
+	u32 *samples;
+
+	if (!cnt) {
+		seq_printf(s, "%-8s no samples\n", name);
+		return;
+	}
+
+	samples = kmemdup(lat->samples_ns, sizeof(lat->samples_ns), GFP_KERNEL);
+	if (!samples)
+		return;
+
+	/* unfilled slots are still zero until the ring wrapped once */
+	if (cnt < DECON_IRQ_LAT_SAMPLES)
+		memcpy(samples, &lat->samples_ns[1], cnt * sizeof(u32));
+	sort(samples, cnt, sizeof(u32), irq_lat_cmp, NULL);
+
+	seq_printf(s, "%-8s samples:%u p50:%uns p90:%uns p99:%uns max:%uns\n",
+		   name, cnt, samples[cnt * 50 / 100], samples[cnt * 90 / 100],
+		   samples[cnt * 99 / 100], samples[cnt - 1]);
+
+	kfree(samples);
+}
+
+static int irq_latency_show(struct seq_file *s, void *unused)
+{
+	struct decon_device *decon = s->private;
+
+	irq_lat_print(s, "hard", &decon->irq_bh.hard);
+	irq_lat_print(s, "delay", &decon->irq_bh.delay);
+	irq_lat_print(s, "thread", &decon->irq_bh.thread);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(irq_latency);
+
+static int hibernation_exit_show(struct seq_file *s, void *unused)
+{
+	struct decon_device *decon = s->private;
+	static const char * const names[DECON_HIBER_EXIT_PATH_CNT] = {
+		[DECON_HIBER_EXIT_SNAPSHOT] = "snapshot",
+		[DECON_HIBER_EXIT_FULL] = "full",
+	};
+	struct decon_hiber_exit_lat lat;
+	unsigned long flags;
+	int i;
+
+	for (i = 0; i < DECON_HIBER_EXIT_PATH_CNT; i++) {
+		spin_lock_irqsave(&decon->slock, flags);
+		lat = decon->hiber_snapshot.exit_lat[i];
+		spin_unlock_irqrestore(&decon->slock, flags);
+
+		seq_printf(s, "%-8s exits:%u avg:%lluus max:%uus\n", names[i], lat.cnt,
+			   lat.cnt ? div_u64(lat.total_us, lat.cnt) : 0, lat.max_us);
+	}
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(hibernation_exit);
+
+static void idle_gate_print(struct seq_file *s, const char *name, u32 id,
+			    const struct exynos_idle_gate *gate)
+{
+	seq_printf(s, "%s%-4u gated:%d entries:%u residency:%lluus\n", name, id,
+		   gate->gated, gate->gate_cnt, exynos_idle_gate_residency_us(gate));
+}
+
+static int idle_residency_show(struct seq_file *s, void *unused)
+{
+	struct decon_device *decon = s->private;
+	const struct writeback_device *wb = decon_get_wb(decon);
+	int i;
+
+	seq_printf(s, "light idle entry: %ums\n", decon->light_idle.entry_ms);
+	idle_gate_print(s, "dsc", decon->id, &decon->light_idle.dsc);
+
+	for (i = 0; i < decon->dpp_cnt; i++)
+		idle_gate_print(s, "dpp", decon->dpp[i]->id, &decon->dpp[i]->idle_gate);
+	if (decon->rcd)
+		idle_gate_print(s, "rcd", decon->rcd->id, &decon->rcd->idle_gate);
+	if (wb)
+		idle_gate_print(s, "wb", wb->id, &wb->idle_gate);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(idle_residency);
+
+static int bts_assign_show(struct seq_file *s, void *unused)
+{
+	struct decon_device *decon = s->private;
+	const struct dpu_bts_assign_eval *eval = &decon->bts.assign;
+	int i;
+
+	seq_printf(s, "evaluated: %u better: %u failed: %u\n", eval->eval_cnt,
+		   eval->better_cnt, eval->fail_cnt);
+	seq_printf(s, "disp freq cur: %ukhz best: %ukhz avg saved: %llukhz\n",
+		   eval->cur_freq, eval->best_freq, eval->better_cnt ?
+		   div_u64(eval->saved_khz_sum, eval->better_cnt) : 0);
+
+	for (i = 0; i < decon->win_cnt; i++) {
+		const struct dpu_bts_win_config *config = &decon->bts.win_config[i];
+
+		if (config->state != DPU_WIN_STATE_BUFFER)
+			continue;
+
+		seq_printf(s, "win%d: dpp%u -> dpp%u\n", i, config->dpp_id,
+			   eval->best_dpp_id[i]);
+	}
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(bts_assign);
+
 bool is_console_enabled(void)
 {
 	return exynos_uart_console_enabled();
@@ -1815,6 +2224,24 @@ int dpu_init_debug(struct decon_device *decon)
 	if (ret)
 		pr_warn("unable to add decon_debug sysfs files (%d)\n", ret);
 
+	debugfs_create_file("partial_stats", 0444, crtc->debugfs_entry, decon,
+			&partial_stats_fops);
+	debugfs_create_file("irq_latency", 0444, crtc->debugfs_entry, decon,
+			&irq_latency_fops);
+	debugfs_create_file("frame_timeline", 0644, crtc->debugfs_entry, decon,
+			&frame_timeline_fops);
+	debugfs_create_bool("hibernation_snapshot", 0664, crtc->debugfs_entry,
+			&decon->hiber_snapshot.enabled);
+	debugfs_create_file("hibernation_exit", 0444, crtc->debugfs_entry, decon,
+			&hibernation_exit_fops);
+	debugfs_create_u32("light_idle_entry_ms", 0664, crtc->debugfs_entry,
+			&decon->light_idle.entry_ms);
+	debugfs_create_file("idle_residency", 0444, crtc->debugfs_entry, decon,
+			&idle_residency_fops);
+	debugfs_create_bool("bts_assign_eval", 0664, crtc->debugfs_entry,
+			&decon->bts.assign.enabled);
+	debugfs_create_file("bts_assign", 0444, crtc->debugfs_entry, decon,
+			&bts_assign_fops);
 	debugfs_create_file("force_te_on", 0664, crtc->debugfs_entry, decon, &force_te_fops);
 	debugfs_create_file("tout_en", 0664, crtc->debugfs_entry, decon, &tout_fops);
 	debugfs_create_u32("underrun_cnt", 0664, crtc->debugfs_entry, &decon->d.underrun_cnt);
@@ -1823,6 +2250,19 @@ int dpu_init_debug(struct decon_device *decon)
 	debugfs_create_u32("idma_err_cnt", 0444, crtc->debugfs_entry, &decon->d.idma_err_cnt);
 	debugfs_create_u32("te_count", 0444, crtc->debugfs_entry, &decon->d.te_cnt);
 	debugfs_create_u32("frame_done_count", 0444, crtc->debugfs_entry, &decon->d.framedone_cnt);
+	debugfs_create_bool("dup_frame_skip", 0664, crtc->debugfs_entry, &decon->dup.enabled);
+	debugfs_create_u32("dup_max_skips", 0664, crtc->debugfs_entry, &decon->dup.max_skips);
+	debugfs_create_u32("dup_skip_cnt", 0444, crtc->debugfs_entry, &decon->dup.skip_cnt);
+	debugfs_create_u32("dup_verify_cnt", 0444, crtc->debugfs_entry, &decon->dup.verify_cnt);
+	debugfs_create_u32("dup_mismatch_cnt", 0444, crtc->debugfs_entry,
+			   &decon->dup.mismatch_cnt);
+	debugfs_create_bool("late_latch", 0664, crtc->debugfs_entry, &decon->late_latch.enabled);
+	debugfs_create_u32("late_latch_cnt", 0444, crtc->debugfs_entry,
+			   &decon->late_latch.commit_cnt);
+	debugfs_create_u32("commit_to_trigger_us", 0444, crtc->debugfs_entry,
+			   &decon->late_latch.trigger_lat_us);
+	debugfs_create_u32("commit_to_trigger_max_us", 0644, crtc->debugfs_entry,
+			   &decon->late_latch.trigger_lat_max_us);
 
 	urgent_dent = debugfs_create_dir("urgent", crtc->debugfs_entry);
 	if (!urgent_dent) {
@@ -2028,11 +2468,19 @@ int exynos_drm_debugfs_plane_add(struct exynos_drm_plane *exynos_plane)
 
 	exynos_plane->debugfs_entry = root;
 
+	debugfs_create_u32("addr_only_cnt", 0444, root, &dpp->addr_only_cnt);
+	debugfs_create_u32("full_config_cnt", 0444, root, &dpp->full_config_cnt);
+
 	if (test_bit(DPP_ATTR_HDR, &dpp->attr)) {
 		hdr_dent = debugfs_create_dir("hdr", root);
 		if (!hdr_dent)
 			goto err;
 
+		debugfs_create_u32("lut_cache_hit", 0444, hdr_dent,
+				&hdr->lut_cache.hit_cnt);
+		debugfs_create_u32("lut_cache_miss", 0444, hdr_dent,
+				&hdr->lut_cache.miss_cnt);
+
 #if defined(CONFIG_SOC_ZUMA)
 		debugfs_create_bool("fp16_en", 0664, hdr_dent, &hdr->fp16_en);
 		debugfs_create_bool("fp16_cvt_en", 0664, hdr_dent, &hdr->fp16_cvt_en);
@@ -86,6 +86,7 @@ static int decon_request_te_irq(struct exynos_drm_crtc *exynos_crtc,
 				const struct drm_connector_state *conn_state);
 static void decon_request_tout_irq(struct decon_device *decon);
 static bool decon_check_fs_pending_locked(struct decon_device *decon);
+static void decon_irq_bh_locked(struct decon_device *decon);
 
 #ifdef CONFIG_BOARD_EMULATOR
 #define FRAME_TIMEOUT  msecs_to_jiffies(100000)
@@ -378,6 +379,23 @@ static bool has_writeback_job(struct drm_crtc_state *new_crtc_state)
 		if (wb_check_job(conn_state))
 			return true;
 	}
+
+	return false;
+}
+
+static bool has_writeback_stream(struct drm_crtc_state *new_crtc_state)
+{
+	struct drm_connector *conn;
+
+	drm_for_each_connector_mask(conn, new_crtc_state->crtc->dev,
+				    new_crtc_state->connector_mask) {
+		if (conn->connector_type != DRM_MODE_CONNECTOR_WRITEBACK)
+			continue;
+
+		if (writeback_stream_is_active(conn_to_wb_dev(conn)))
+			return true;
+	}
+
 	return false;
 }
 
@@ -677,7 +695,7 @@ static int decon_atomic_check(struct exynos_drm_crtc *exynos_crtc,
 			      struct drm_crtc_state *crtc_state)
 {
 	const struct decon_device *decon = exynos_crtc->ctx;
-	const bool is_wb = has_writeback_job(crtc_state);
+	const bool is_wb = has_writeback_job(crtc_state) || has_writeback_stream(crtc_state);
 	bool is_swb;
 	struct exynos_drm_crtc_state *exynos_crtc_state = to_exynos_crtc_state(crtc_state);
 	int out_type;
@@ -790,6 +808,10 @@ static int decon_update_lhbm_hist_roi(struct decon_device *decon, struct drm_ato
 static void decon_atomic_begin(struct exynos_drm_crtc *crtc, struct drm_atomic_state *state)
 {
 	struct decon_device *decon = crtc->ctx;
+	const struct drm_crtc_state *new_crtc_state =
+			drm_atomic_get_new_crtc_state(state, &crtc->base);
+	const struct exynos_drm_crtc_state *new_exynos_crtc_state =
+			to_exynos_crtc_state(new_crtc_state);
 
 	decon_debug(decon, "%s +\n", __func__);
 	DPU_EVENT_LOG(DPU_EVT_ATOMIC_BEGIN, decon->id, NULL);
@@ -798,6 +820,11 @@ static void decon_atomic_begin(struct exynos_drm_crtc *crtc, struct drm_atomic_s
 #endif
 	decon_reg_wait_update_done_and_mask(decon->id, &decon->config.mode,
 			SHADOW_UPDATE_TIMEOUT_US);
+
+	/* previous shadow update is done, new CGC coefficients can be loaded */
+	if (decon->dqe && new_crtc_state->color_mgmt_changed &&
+	    !new_exynos_crtc_state->skip_update)
+		exynos_dqe_prepare_cgc(decon->dqe, &new_exynos_crtc_state->dqe);
 	decon_debug(decon, "%s -\n", __func__);
 }
 
@@ -968,21 +995,29 @@ static void decon_disable_plane(struct exynos_drm_crtc *exynos_crtc,
 	decon_debug(decon, "%s -\n", __func__);
 }
 
-static void decon_send_vblank_event_locked(struct decon_device *decon)
+static void __decon_send_vblank_event(struct decon_device *decon,
+				      struct drm_pending_vblank_event **event)
 {
 	struct drm_crtc *crtc = &decon->crtc->base;
 	struct drm_device *dev = crtc->dev;
 
-	if (!decon->event)
+	if (!*event)
 		return;
 
 	spin_lock(&dev->event_lock);
-	drm_send_event_locked(dev, &decon->event->base);
+	drm_send_event_locked(dev, &(*event)->base);
 	spin_unlock(&dev->event_lock);
 
 	drm_crtc_vblank_put(crtc);
 
-	decon->event = NULL;
+	*event = NULL;
+}
+
+static void decon_send_vblank_event_locked(struct decon_device *decon)
+{
+	/* an event handed off at an earlier frame start goes out first */
+	__decon_send_vblank_event(decon, &decon->irq_bh.event);
+	__decon_send_vblank_event(decon, &decon->event);
 }
 
 void decon_force_vblank_event(struct decon_device *decon)
@@ -1056,6 +1091,165 @@ static void decon_wait_earliest_process_time(
 	}
 }
 
+static u32 decon_get_crc_dsim_id(const struct decon_device *decon)
+{
+	if (decon->config.out_type == DECON_OUT_DSI)
+		return decon->config.main_dsim_id;
+
+	return (decon->config.out_type & DECON_OUT_DSI1) ? 1 : 0;
+}
+
+/* called with slock held before the frame is started */
+static void decon_dup_frame_prepare_locked(struct decon_device *decon, u64 frame_seq)
+{
+	struct decon_dup_frame *dup = &decon->dup;
+
+	if (!dup->enabled || decon->config.mode.op_mode != DECON_COMMAND_MODE) {
+		dup->verified_seq = 0;
+		dup->inflight_seq = 0;
+		dup->crc_valid = false;
+		return;
+	}
+
+	decon_reg_set_start_crc(decon_get_crc_dsim_id(decon), 1);
+	dup->inflight_seq = frame_seq;
+	WRITE_ONCE(dup->skip_streak, 0);
+}
+
+/*
+ * called with slock held on frame done, compares the CRC of the transferred
+ * frame with the previous one when both frames share the same content sequence
+ */
+static void decon_dup_frame_done_locked(struct decon_device *decon)
+{
+	struct decon_dup_frame *dup = &decon->dup;
+	u32 crc[3];
+	bool match;
+
+	if (!dup->inflight_seq)
+		return;
+
+	decon_reg_get_crc_data(decon_get_crc_dsim_id(decon), crc);
+
+	if (dup->crc_valid && dup->last_seq == dup->inflight_seq) {
+		match = !memcmp(crc, dup->last_crc, sizeof(crc));
+		dup->verify_cnt++;
+		if (match) {
+			WRITE_ONCE(dup->verified_seq, dup->inflight_seq);
+		} else {
+			dup->mismatch_cnt++;
+			WRITE_ONCE(dup->verified_seq, 0);
+		}
+		DPU_EVENT_LOG(DPU_EVT_DUP_FRAME_VERIFY, decon->id, &match);
+	}
+
+	dup->last_seq = dup->inflight_seq;
+	memcpy(dup->last_crc, crc, sizeof(crc));
+	dup->crc_valid = true;
+	dup->inflight_seq = 0;
+}
+
+static void decon_light_idle_exit_locked(struct decon_device *decon)
+{
+	if (exynos_idle_gate_exit(&decon->light_idle.dsc))
+		dsc_reg_set_clock_gating(decon->id, &decon->config, false);
+}
+
+static void decon_light_idle_handler(struct kthread_work *work)
+{
+	struct decon_device *decon = container_of(work, struct decon_device,
+						  light_idle.dwork.work);
+	struct decon_light_idle *idle = &decon->light_idle;
+	unsigned long flags;
+	bool busy;
+
+	spin_lock_irqsave(&decon->slock, flags);
+	/*
+	 * With the trigger left unmasked hw sends a frame on every TE without
+	 * decon_reg_start(), DSC must stay ungated then. Dimming end re-arms.
+	 */
+	if (decon->state != DECON_STATE_ON || decon->keep_unmask ||
+	    decon_reg_is_trigger_unmasked(decon->id, &decon->config.mode)) {
+		spin_unlock_irqrestore(&decon->slock, flags);
+		return;
+	}
+
+	busy = atomic_read(&decon->frames_pending) > 0;
+	if (!busy && exynos_idle_gate_enter(&idle->dsc))
+		dsc_reg_set_clock_gating(decon->id, &decon->config, true);
+	spin_unlock_irqrestore(&decon->slock, flags);
+
+	if (busy)
+		kthread_mod_delayed_work(&decon->worker, &idle->dwork,
+					 msecs_to_jiffies(idle->entry_ms));
+}
+
+static void decon_light_idle_arm(struct decon_device *decon)
+{
+	struct decon_light_idle *idle = &decon->light_idle;
+
+	/* video mode and dimming keep DSC busy all the time */
+	if (decon->config.mode.op_mode != DECON_COMMAND_MODE || !decon->config.dsc.enabled ||
+	    !idle->entry_ms || READ_ONCE(decon->keep_unmask))
+		return;
+
+	kthread_mod_delayed_work(&decon->worker, &idle->dwork, msecs_to_jiffies(idle->entry_ms));
+}
+
+/*
+ * Pushes the next step of a DQE matrix transition. In command mode a frame
+ * is triggered for it, once the previous one is done.
+ */
+static void decon_dqe_ramp_handler(struct kthread_work *work)
+{
+	struct decon_device *decon = container_of(work, struct decon_device, dqe_ramp_work);
+	struct decon_dup_frame *dup = &decon->dup;
+	unsigned long flags;
+	bool triggered = false;
+
+	/* keeps pushing hibernation entry out while the ramp runs */
+	hibernation_block(decon->hibernation);
+
+	spin_lock_irqsave(&decon->slock, flags);
+	if (decon->state != DECON_STATE_ON)
+		goto out;
+
+	if (decon->config.mode.op_mode == DECON_COMMAND_MODE) {
+		if (atomic_read(&decon->frames_pending))
+			goto out;
+
+		/* previous step is done, stop hw from following TE on its own */
+		if (decon->dqe_ramp_trig && !decon->keep_unmask) {
+			DPU_EVENT_LOG(DPU_EVT_DECON_TRIG_MASK, decon->id, NULL);
+			decon_reg_set_trigger(decon->id, &decon->config.mode, DECON_TRIG_MASK);
+		}
+		decon->dqe_ramp_trig = false;
+	}
+
+	if (!decon->dqe || !exynos_dqe_matrix_transition_step(decon->dqe))
+		goto out;
+
+	if (decon->config.mode.op_mode == DECON_COMMAND_MODE) {
+		decon_reg_update_req_dqe(decon->id);
+		/* output differs from the last committed frame */
+		dup->crc_valid = false;
+		WRITE_ONCE(dup->verified_seq, 0);
+		decon_light_idle_exit_locked(decon);
+		decon_reg_start(decon->id, &decon->config);
+		atomic_inc(&decon->frames_pending);
+		decon->dqe_ramp_trig = true;
+		triggered = true;
+	} else {
+		decon_video_mode_reg_update_req(decon->id, false, true);
+	}
+out:
+	spin_unlock_irqrestore(&decon->slock, flags);
+
+	hibernation_unblock_enter(decon->hibernation);
+	if (triggered)
+		decon_light_idle_arm(decon);
+}
+
 static void decon_atomic_flush(struct exynos_drm_crtc *exynos_crtc,
 		struct drm_crtc_state *old_crtc_state)
 {
@@ -1077,6 +1271,14 @@ static void decon_atomic_flush(struct exynos_drm_crtc *exynos_crtc,
 		return;
 
 	if (new_exynos_crtc_state->skip_update) {
+		if (new_exynos_crtc_state->dup_frame) {
+			decon->dup.skip_cnt++;
+			WRITE_ONCE(decon->dup.skip_streak, decon->dup.skip_streak + 1);
+			DPU_ATRACE_INT_PID("dup_frame_skip", decon->dup.skip_cnt,
+					   decon->thread->pid);
+			DPU_EVENT_LOG(DPU_EVT_DUP_FRAME_SKIP, decon->id, decon);
+		}
+
 		/* for seamless mode change, change pipeline but skip update from decon */
 		if (new_exynos_crtc_state->seamless_mode_changed)
 			decon_seamless_mode_set(exynos_crtc, old_crtc_state);
@@ -1098,8 +1300,13 @@ static void decon_atomic_flush(struct exynos_drm_crtc *exynos_crtc,
 		return;
 	}
 
-	if (new_exynos_crtc_state->wb_type == EXYNOS_WB_CWB)
-		decon_reg_set_cwb_enable(decon->id, true);
+	if (new_exynos_crtc_state->wb_type == EXYNOS_WB_CWB) {
+		struct writeback_device *wb = decon_get_wb(decon);
+
+		/* streaming writeback skips decimated frames or when no buffer is free */
+		if (!wb || !writeback_stream_is_active(wb) || writeback_stream_queue_frame(wb))
+			decon_reg_set_cwb_enable(decon->id, true);
+	}
 
 	/* if there are no dpp planes attached, enable colormap as fallback */
 	if ((new_crtc_state->plane_mask & ~exynos_crtc->rcd_plane_mask) == 0) {
@@ -1141,14 +1348,20 @@ static void decon_atomic_flush(struct exynos_drm_crtc *exynos_crtc,
 				width, height);
 	}
 
-	if (partial)
+	if (partial) {
 		exynos_partial_update(partial, &old_exynos_crtc_state->partial_region,
 				&new_exynos_crtc_state->partial_region);
+		exynos_partial_count_stats(partial, new_exynos_crtc_state);
+	}
 
 	if (new_exynos_crtc_state->seamless_mode_changed)
 		decon_seamless_mode_set(exynos_crtc, old_crtc_state);
 
 	decon_wait_earliest_process_time(old_exynos_crtc_state, new_exynos_crtc_state);
+	new_exynos_crtc_state->frame_ts[EXYNOS_FRAME_EPT] = ktime_get();
+
+	if (dqe)
+		exynos_dqe_wait_cgc(dqe);
 
 	spin_lock_irqsave(&decon->slock, flags);
 	if (decon->config.mode.op_mode == DECON_COMMAND_MODE) {
@@ -1168,12 +1381,30 @@ static void decon_atomic_flush(struct exynos_drm_crtc *exynos_crtc,
 		decon->cgc_need_update = false;
 		decon->dqe_need_update = false;
 	}
+	decon_dup_frame_prepare_locked(decon, new_exynos_crtc_state->frame_seq);
+	decon_light_idle_exit_locked(decon);
+	/* trigger is masked again by this commit after frame start */
+	decon->dqe_ramp_trig = false;
 	decon_reg_start(decon->id, &decon->config);
+	new_exynos_crtc_state->frame_ts[EXYNOS_FRAME_TRIGGER] = ktime_get();
+	decon_timeline_queue_locked(decon, new_exynos_crtc_state->frame_ts);
 	atomic_inc(&decon->frames_pending);
 	if (!new_crtc_state->no_vblank)
 		decon_arm_event_locked(exynos_crtc);
 	spin_unlock_irqrestore(&decon->slock, flags);
 
+	decon_light_idle_arm(decon);
+
+	if (new_exynos_crtc_state->frame_ts[EXYNOS_FRAME_TAIL]) {
+		struct decon_late_latch *ll = &decon->late_latch;
+
+		ll->trigger_lat_us = ktime_us_delta(
+				new_exynos_crtc_state->frame_ts[EXYNOS_FRAME_TRIGGER],
+				new_exynos_crtc_state->frame_ts[EXYNOS_FRAME_TAIL]);
+		ll->trigger_lat_max_us = max(ll->trigger_lat_max_us, ll->trigger_lat_us);
+		DPU_ATRACE_INT_PID("commit_to_trigger_us", ll->trigger_lat_us, decon->thread->pid);
+	}
+
 	DPU_EVENT_LOG(DPU_EVT_ATOMIC_FLUSH, decon->id, NULL);
 
 	decon_debug(decon, "%s -\n", __func__);
@@ -1491,6 +1722,14 @@ static int _decon_reinit_locked(struct decon_device *decon)
 	return 0;
 }
 
+static void decon_hdr_lut_cache_invalidate(struct decon_device *decon)
+{
+	int i;
+
+	for (i = 0; i < decon->dpp_cnt; ++i)
+		dpp_hdr_lut_cache_invalidate(decon->dpp[i]);
+}
+
 static void _decon_stop_locked(struct decon_device *decon, bool reset, u32 vrefresh)
 {
 	int i;
@@ -1514,11 +1753,74 @@ static void _decon_stop_locked(struct decon_device *decon, bool reset, u32 vrefr
 
 	if (reset && decon->dqe)
 		exynos_dqe_reset(decon->dqe);
+
+	if (reset)
+		decon_hdr_lut_cache_invalidate(decon);
+}
+
+static bool decon_config_equal(const struct decon_config *a, const struct decon_config *b)
+{
+	struct decon_config tmp;
+
+	/* input bpc is programmed per frame, not by decon_reg_init() */
+	memcpy(&tmp, b, sizeof(tmp));
+	tmp.in_bpc = a->in_bpc;
+
+	return !memcmp(a, &tmp, sizeof(tmp));
+}
+
+static void decon_hiber_snapshot_save_locked(struct decon_device *decon, bool reset)
+{
+	struct decon_hiber_snapshot *snap = &decon->hiber_snapshot;
+
+	snap->valid = false;
+	if (!snap->enabled || reset)
+		return;
+
+	if (decon_reg_save(decon->id, &decon->config, &snap->regs))
+		return;
+
+	memcpy(&snap->config, &decon->config, sizeof(snap->config));
+	snap->valid = true;
+}
+
+static enum decon_hiber_exit_path decon_hiber_snapshot_restore_locked(struct decon_device *decon)
+{
+	struct decon_hiber_snapshot *snap = &decon->hiber_snapshot;
+	bool restored = false;
+
+	if (snap->enabled && snap->valid && decon_config_equal(&snap->config, &decon->config))
+		restored = !decon_reg_restore(decon->id, &decon->config, &snap->regs);
+	snap->valid = false;
+
+	if (!restored) {
+		_decon_enable_locked(decon);
+		return DECON_HIBER_EXIT_FULL;
+	}
+
+	decon_enable_irqs(decon);
+	return DECON_HIBER_EXIT_SNAPSHOT;
+}
+
+static u32 decon_hiber_exit_lat_add(struct decon_device *decon,
+				    enum decon_hiber_exit_path path, ktime_t start)
+{
+	const u32 us = ktime_us_delta(ktime_get(), start);
+	struct decon_hiber_exit_lat *lat = &decon->hiber_snapshot.exit_lat[path];
+
+	lat->cnt++;
+	lat->total_us += us;
+	lat->max_us = max(lat->max_us, us);
+
+	return us;
 }
 
 static void decon_exit_hibernation(struct decon_device *decon)
 {
+	enum decon_hiber_exit_path path;
 	unsigned long flags;
+	ktime_t start;
+	u32 exit_us;
 
 	if (decon->state != DECON_STATE_HIBERNATION)
 		return;
@@ -1531,13 +1833,18 @@ static void decon_exit_hibernation(struct decon_device *decon)
 		decon_err(decon, "%s: failed to pm_runtime_get_sync\n", __func__);
 
 	spin_lock_irqsave(&decon->slock, flags);
-	_decon_enable_locked(decon);
+	start = ktime_get();
+	path = decon_hiber_snapshot_restore_locked(decon);
 	exynos_dqe_restore_lpd_data(decon->dqe);
 	if (decon->partial)
 		exynos_partial_restore(decon->partial);
+	exit_us = decon_hiber_exit_lat_add(decon, path, start);
 	decon->state = DECON_STATE_ON;
 	spin_unlock_irqrestore(&decon->slock, flags);
 
+	DPU_ATRACE_INT(path == DECON_HIBER_EXIT_SNAPSHOT ? "hiber_exit_snapshot_us" :
+		       "hiber_exit_full_us", exit_us);
+
 	decon_debug(decon, "%s -\n", __func__);
 	DPU_ATRACE_END(__func__);
 	DPU_EVENT_LOG(DPU_EVT_EXIT_HIBERNATION_OUT, decon->id, NULL);
@@ -1565,6 +1872,7 @@ static void decon_enable(struct exynos_drm_crtc *exynos_crtc, struct drm_crtc_st
 		if (old_exynos_crtc_state->bypass) {
 			spin_lock_irqsave(&decon->slock, flags);
 			_decon_stop_locked(decon, true, vrefresh);
+			decon->hiber_snapshot.valid = false;
 			spin_unlock_irqrestore(&decon->slock, flags);
 		}
 
@@ -1674,11 +1982,60 @@ static bool _decon_wait_for_framedone(struct decon_device *decon)
 	}
 }
 
+/*
+ * Sends one frame with the current configuration in command mode. Used by
+ * recovery after a link reset, when panel needs fresh content and the frame
+ * done tells whether the link works again.
+ */
+int decon_send_recovery_frame(struct decon_device *decon)
+{
+	const u32 fps = _decon_get_current_fps(decon);
+	unsigned long flags;
+	long ret;
+
+	spin_lock_irqsave(&decon->slock, flags);
+	if (decon->state != DECON_STATE_ON ||
+	    decon->config.mode.op_mode != DECON_COMMAND_MODE) {
+		spin_unlock_irqrestore(&decon->slock, flags);
+		return -EINVAL;
+	}
+
+	decon_light_idle_exit_locked(decon);
+	decon_reg_start(decon->id, &decon->config);
+	atomic_inc(&decon->frames_pending);
+	spin_unlock_irqrestore(&decon->slock, flags);
+
+	ret = wait_event_timeout(decon->framedone_wait,
+				 atomic_read(&decon->frames_pending) == 0,
+				 fps_timeout(fps));
+
+	spin_lock_irqsave(&decon->slock, flags);
+	if (!decon->keep_unmask) {
+		DPU_EVENT_LOG(DPU_EVT_DECON_TRIG_MASK, decon->id, NULL);
+		decon_reg_set_trigger(decon->id, &decon->config.mode, DECON_TRIG_MASK);
+	}
+	spin_unlock_irqrestore(&decon->slock, flags);
+
+	decon_light_idle_arm(decon);
+
+	if (!ret) {
+		decon_warn(decon, "recovery frame done timed out (%dhz)\n", fps);
+		return -ETIMEDOUT;
+	}
+
+	return 0;
+}
+
 static void _decon_disable_locked(struct decon_device *decon, bool reset)
 {
 	decon_disable_irqs(decon);
+	/* drain bottom half work while the registers are still accessible */
+	decon_irq_bh_locked(decon);
+	decon_timeline_reset_locked(decon);
 	atomic_set(&decon->frames_pending, 0);
 	atomic_set(&decon->frame_transfer_pending, 0);
+	decon->dqe_ramp_trig = false;
+	decon_light_idle_exit_locked(decon);
 	_decon_stop_locked(decon, reset, _decon_get_current_fps(decon));
 }
 
@@ -1698,6 +2055,7 @@ static void decon_enter_hibernation(struct decon_device *decon)
 	reset = _decon_wait_for_framedone(decon);
 	spin_lock_irqsave(&decon->slock, flags);
 	exynos_dqe_hibernation_enter(decon->dqe);
+	decon_hiber_snapshot_save_locked(decon, reset);
 	_decon_disable_locked(decon, reset);
 	pm_runtime_put(decon->dev);
 	decon->state = DECON_STATE_HIBERNATION;
@@ -1755,6 +2113,10 @@ static void decon_disable(struct exynos_drm_crtc *crtc)
 		pm_runtime_put(decon->dev);
 	}
 	decon->state = DECON_STATE_OFF;
+	/* panel contents are lost, restart duplicate frame verification */
+	decon->dup.verified_seq = 0;
+	decon->dup.inflight_seq = 0;
+	decon->dup.crc_valid = false;
 	spin_unlock_irqrestore(&decon->slock, flags);
 
 	DPU_EVENT_LOG(DPU_EVT_DECON_DISABLED, decon->id, decon);
@@ -1790,6 +2152,8 @@ static void decon_wait_for_flip_done(struct exynos_drm_crtc *crtc,
 
 		spin_lock_irqsave(&decon->slock, flags);
 		fs_irq_pending = decon_check_fs_pending_locked(decon);
+		if (fs_irq_pending)
+			decon_irq_bh_locked(decon);
 		spin_unlock_irqrestore(&decon->slock, flags);
 
 		if (!fs_irq_pending) {
@@ -1969,6 +2333,9 @@ static void decon_unbind(struct device *dev, struct device *master,
 	if (decon_is_effectively_active(decon))
 		decon_disable(decon->crtc);
 
+	if (decon->dqe)
+		exynos_dqe_cgc_cache_release(decon->dqe);
+
 	device_remove_file(dev, &dev_attr_early_wakeup);
 
 	/* Remove symlink to decon device */
@@ -1992,9 +2359,144 @@ static const struct component_ops decon_component_ops = {
 	.unbind = decon_unbind,
 };
 
+static void decon_irq_lat_add(struct decon_irq_lat *lat, ktime_t start)
+{
+	const u32 idx = (u32)atomic_inc_return(&lat->cnt) % DECON_IRQ_LAT_SAMPLES;
+
+	lat->samples_ns[idx] = ktime_to_ns(ktime_sub(ktime_get(), start));
+}
+
+/* hand off work to the irq thread, caller must hold slock */
+static void decon_irq_bh_queue_locked(struct decon_device *decon,
+				      unsigned int bits, ktime_t ts)
+{
+	decon->irq_bh.ts = ts;
+	atomic_or(bits, &decon->irq_bh.pending);
+}
+
+/* the ramp handler checks again under slock, a stale read only costs a wakeup */
+static void decon_dqe_ramp_queue(struct decon_device *decon)
+{
+	if (READ_ONCE(decon->dqe_ramp_trig) ||
+	    (decon->dqe && READ_ONCE(decon->dqe->linear_tr.active)))
+		kthread_queue_work(&decon->worker, &decon->dqe_ramp_work);
+}
+
+/*
+ * Takes the work handed off by the hard irq handlers. Only the parts that
+ * need slock are done here: the vblank event and the timeline ring. The rest
+ * is done by decon_irq_bh_run().
+ */
+static unsigned int decon_irq_bh_take_locked(struct decon_device *decon,
+					     struct drm_pending_vblank_event **event)
+{
+	const unsigned int pending = atomic_xchg(&decon->irq_bh.pending, 0);
+
+	*event = NULL;
+	if (pending & DECON_IRQ_BH_FRAMESTART) {
+		DPU_EVENT_LOG(DPU_EVT_DECON_FRAMESTART, decon->id, decon);
+		*event = decon->irq_bh.event;
+		decon->irq_bh.event = NULL;
+	}
+
+	if (pending & DECON_IRQ_BH_FRAMEDONE) {
+		DPU_EVENT_LOG(DPU_EVT_DECON_FRAMEDONE, decon->id, decon);
+		decon_timeline_report_locked(decon);
+	}
+
+	return pending;
+}
+
+/* @hw_on: registers can be read back, either slock or a pm reference is held */
+static void decon_irq_bh_run(struct decon_device *decon, unsigned int pending,
+			     struct drm_pending_vblank_event *event, bool hw_on)
+{
+	const bool cmd_mode = decon->config.mode.op_mode == DECON_COMMAND_MODE;
+
+	if (pending & DECON_IRQ_BH_FRAMESTART) {
+		__decon_send_vblank_event(decon, &event);
+		if (!cmd_mode)
+			decon_dqe_ramp_queue(decon);
+	}
+
+	if (pending & DECON_IRQ_BH_FRAMEDONE) {
+		/* LPD and histogram are read back from registers */
+		if (hw_on) {
+			exynos_dqe_save_lpd_data(decon->dqe);
+			if (decon->dqe)
+				handle_histogram_event(decon->dqe);
+		}
+		if (cmd_mode)
+			decon_dqe_ramp_queue(decon);
+	}
+
+	if (pending & DECON_IRQ_BH_DIMMING_START)
+		DPU_EVENT_LOG(DPU_EVT_DIMMING_START, decon->id, NULL);
+
+	if (pending & DECON_IRQ_BH_DIMMING_END) {
+		DPU_EVENT_LOG(DPU_EVT_DIMMING_END, decon->id, NULL);
+		decon_light_idle_arm(decon);
+	}
+}
+
+/* drains the bottom half synchronously, used where the irq thread can't run */
+static void decon_irq_bh_locked(struct decon_device *decon)
+{
+	struct drm_pending_vblank_event *event;
+	const unsigned int pending = decon_irq_bh_take_locked(decon, &event);
+
+	if (!pending)
+		return;
+
+	decon_irq_bh_run(decon, pending, event, decon->state == DECON_STATE_ON);
+
+	if (pending & DECON_IRQ_BH_TIMEOUT) {
+		decon_err(decon, "%s: timeout irq occurs\n", __func__);
+		decon_dump_locked(decon, NULL);
+		WARN_ON(1);
+	}
+}
+
+static irqreturn_t decon_irq_thread(int irq, void *dev_data)
+{
+	struct decon_device *decon = dev_data;
+	const ktime_t start = ktime_get();
+	struct drm_pending_vblank_event *event;
+	unsigned int pending;
+	unsigned long flags;
+	bool hw_on;
+
+	spin_lock_irqsave(&decon->slock, flags);
+	/* may already have been drained by the disable path */
+	if (atomic_read(&decon->irq_bh.pending))
+		decon_irq_lat_add(&decon->irq_bh.delay, decon->irq_bh.ts);
+	pending = decon_irq_bh_take_locked(decon, &event);
+	/* keeps registers powered for the read back without holding slock */
+	hw_on = pending && decon->state == DECON_STATE_ON &&
+		pm_runtime_get_if_in_use(decon->dev) == 1;
+	spin_unlock_irqrestore(&decon->slock, flags);
+
+	if (pending)
+		decon_irq_bh_run(decon, pending, event, hw_on);
+	if (hw_on)
+		pm_runtime_put(decon->dev);
+
+	if (pending & DECON_IRQ_BH_TIMEOUT) {
+		decon_err(decon, "%s: timeout irq occurs\n", __func__);
+		decon_dump(decon, NULL);
+		WARN_ON(1);
+	}
+
+	decon_irq_lat_add(&decon->irq_bh.thread, start);
+
+	return IRQ_HANDLED;
+}
+
 static irqreturn_t decon_irq_handler(int irq, void *dev_data)
 {
 	struct decon_device *decon = dev_data;
+	const ktime_t start = ktime_get();
+	unsigned int bh = 0;
 	u32 irq_sts_reg;
 	u32 ext_irq = 0;
 
@@ -2011,24 +2513,25 @@ static irqreturn_t decon_irq_handler(int irq, void *dev_data)
 	if (irq_sts_reg & DPU_FRAME_DONE_INT_PEND) {
 		DPU_ATRACE_INT_PID("frame_transfer", 0, decon->thread->pid);
 		atomic_set(&decon->frame_transfer_pending, 0);
-		DPU_EVENT_LOG(DPU_EVT_DECON_FRAMEDONE, decon->id, decon);
 		decon->d.framedone_cnt++;
-		exynos_dqe_save_lpd_data(decon->dqe);
+		decon_timeline_stamp_locked(decon, EXYNOS_FRAME_DONE, start);
+		/* dsim CRC belongs to this frame, read it before the next one starts */
+		decon_dup_frame_done_locked(decon);
 		atomic_dec_if_positive(&decon->frames_pending);
-		if (decon->dqe)
-			handle_histogram_event(decon->dqe);
 		wake_up_all(&decon->framedone_wait);
-		decon_debug(decon, "%s: frame done\n", __func__);
+		bh |= DECON_IRQ_BH_FRAMEDONE;
 	}
 
 	if (irq_sts_reg & INT_PEND_DQE_DIMMING_START) {
 		DPU_ATRACE_INT_PID("dqe_dimming", 1, decon->thread->pid);
 		decon->keep_unmask = true;
-		if (decon->config.mode.op_mode == DECON_COMMAND_MODE)
+		if (decon->config.mode.op_mode == DECON_COMMAND_MODE) {
+			/* frames follow TE from now on, DSC must be clocked for them */
+			decon_light_idle_exit_locked(decon);
 			decon_reg_set_trigger(decon->id, &decon->config.mode,
 					DECON_TRIG_UNMASK);
-
-		DPU_EVENT_LOG(DPU_EVT_DIMMING_START, decon->id, NULL);
+		}
+		bh |= DECON_IRQ_BH_DIMMING_START;
 	}
 
 	if (irq_sts_reg & INT_PEND_DQE_DIMMING_END) {
@@ -2037,24 +2540,29 @@ static irqreturn_t decon_irq_handler(int irq, void *dev_data)
 		if (!decon->event && decon->config.mode.op_mode == DECON_COMMAND_MODE)
 			decon_reg_set_trigger(decon->id, &decon->config.mode,
 					DECON_TRIG_MASK);
-
-		DPU_EVENT_LOG(DPU_EVT_DIMMING_END, decon->id, NULL);
+		bh |= DECON_IRQ_BH_DIMMING_END;
 	}
 
 	if (ext_irq & DPU_RESOURCE_CONFLICT_INT_PEND)
 		decon_debug(decon, "%s: resource conflict\n", __func__);
 
-	if (ext_irq & DPU_TIME_OUT_INT_PEND) {
-		decon_err(decon, "%s: timeout irq occurs\n", __func__);
-		decon_dump_locked(decon, NULL);
-		WARN_ON(1);
-	}
+	if (ext_irq & DPU_TIME_OUT_INT_PEND)
+		bh |= DECON_IRQ_BH_TIMEOUT;
+
+	if (bh)
+		decon_irq_bh_queue_locked(decon, bh, start);
 
 irq_end:
 	spin_unlock(&decon->slock);
-	return IRQ_HANDLED;
+	decon_irq_lat_add(&decon->irq_bh.hard, start);
+
+	return bh ? IRQ_WAKE_THREAD : IRQ_HANDLED;
 }
 
+/*
+ * Acks a pending frame start and hands the armed vblank event off to the
+ * bottom half, which must run afterwards (irq thread or caller).
+ */
 static bool decon_check_fs_pending_locked(struct decon_device *decon)
 {
 	u32 pending_irq;
@@ -2067,8 +2575,15 @@ static bool decon_check_fs_pending_locked(struct decon_device *decon)
 	if (pending_irq & DPU_FRAME_START_INT_PEND) {
 		DPU_ATRACE_INT_PID("frame_transfer", 1, decon->thread->pid);
 		atomic_set(&decon->frame_transfer_pending, 1);
-		DPU_EVENT_LOG(DPU_EVT_DECON_FRAMESTART, decon->id, decon);
-		decon_send_vblank_event_locked(decon);
+		decon_timeline_stamp_locked(decon, EXYNOS_FRAME_START, ktime_get());
+
+		/* bottom half fell a whole frame behind, don't lose its event */
+		if (decon->irq_bh.event)
+			__decon_send_vblank_event(decon, &decon->irq_bh.event);
+		decon->irq_bh.event = decon->event;
+		decon->event = NULL;
+
+		/* kept here so the vblank timestamp is taken at frame start */
 		if (decon->config.mode.op_mode == DECON_VIDEO_MODE)
 			drm_crtc_handle_vblank(&decon->crtc->base);
 
@@ -2082,14 +2597,21 @@ static bool decon_check_fs_pending_locked(struct decon_device *decon)
 static irqreturn_t decon_fs_irq_handler(int irq, void *dev_data)
 {
 	struct decon_device *decon = dev_data;
+	const ktime_t start = ktime_get();
+	irqreturn_t ret = IRQ_HANDLED;
 
 	spin_lock(&decon->slock);
 
-	if (decon_check_fs_pending_locked(decon))
+	if (decon_check_fs_pending_locked(decon)) {
 		decon_debug(decon, "%s: frame start\n", __func__);
+		decon_irq_bh_queue_locked(decon, DECON_IRQ_BH_FRAMESTART, start);
+		ret = IRQ_WAKE_THREAD;
+	}
 
 	spin_unlock(&decon->slock);
-	return IRQ_HANDLED;
+	decon_irq_lat_add(&decon->irq_bh.hard, start);
+
+	return ret;
 }
 
 static int decon_parse_dt(struct decon_device *decon, struct device_node *np)
@@ -2533,8 +3055,8 @@ static int decon_register_irqs(struct decon_device *decon)
 
 	/* 1: FRAME START */
 	decon->irq_fs = of_irq_get_byname(np, "frame_start");
-	ret = devm_request_irq(dev, decon->irq_fs, decon_fs_irq_handler,
-			0, pdev->name, decon);
+	ret = devm_request_threaded_irq(dev, decon->irq_fs, decon_fs_irq_handler,
+			decon_irq_thread, 0, pdev->name, decon);
 	if (ret) {
 		decon_err(decon, "failed to install FRAME START irq\n");
 		return ret;
@@ -2543,8 +3065,8 @@ static int decon_register_irqs(struct decon_device *decon)
 
 	/* 2: FRAME DONE */
 	decon->irq_fd = of_irq_get_byname(np, "frame_done");
-	ret = devm_request_irq(dev, decon->irq_fd, decon_irq_handler,
-			0, pdev->name, decon);
+	ret = devm_request_threaded_irq(dev, decon->irq_fd, decon_irq_handler,
+			decon_irq_thread, 0, pdev->name, decon);
 	if (ret) {
 		decon_err(decon, "failed to install FRAME DONE irq\n");
 		return ret;
@@ -2553,8 +3075,8 @@ static int decon_register_irqs(struct decon_device *decon)
 
 	/* 3: EXTRA: resource conflict, timeout and error irq */
 	decon->irq_ext = of_irq_get_byname(np, "extra");
-	ret = devm_request_irq(dev, decon->irq_ext, decon_irq_handler,
-			0, pdev->name, decon);
+	ret = devm_request_threaded_irq(dev, decon->irq_ext, decon_irq_handler,
+			decon_irq_thread, 0, pdev->name, decon);
 	if (ret) {
 		decon_err(decon, "failed to install EXTRA irq\n");
 		return ret;
@@ -2563,8 +3085,8 @@ static int decon_register_irqs(struct decon_device *decon)
 
 	/* 4: DIMMING START */
 	decon->irq_ds = of_irq_get_byname(np, "dimming_start");
-	if (devm_request_irq(dev, decon->irq_ds, decon_irq_handler,
-			0, pdev->name, decon)) {
+	if (devm_request_threaded_irq(dev, decon->irq_ds, decon_irq_handler,
+			decon_irq_thread, 0, pdev->name, decon)) {
 		decon->irq_ds = -1;
 		decon_info(decon, "dimming start irq is not supported\n");
 	} else {
@@ -2573,8 +3095,8 @@ static int decon_register_irqs(struct decon_device *decon)
 
 	/* 5: DIMMING END */
 	decon->irq_de = of_irq_get_byname(np, "dimming_end");
-	if (devm_request_irq(dev, decon->irq_de, decon_irq_handler,
-			0, pdev->name, decon)) {
+	if (devm_request_threaded_irq(dev, decon->irq_de, decon_irq_handler,
+			decon_irq_thread, 0, pdev->name, decon)) {
 		decon->irq_de = -1;
 		decon_info(decon, "dimming end irq is not supported\n");
 	} else {
@@ -2674,6 +3196,11 @@ static int decon_probe(struct platform_device *pdev)
 	}
 	sched_setscheduler_nocheck(decon->thread, SCHED_FIFO, &param);
 
+	kthread_init_delayed_work(&decon->light_idle.dwork, decon_light_idle_handler);
+	kthread_init_work(&decon->dqe_ramp_work, decon_dqe_ramp_handler);
+	decon->light_idle.entry_ms = DECON_LIGHT_IDLE_ENTRY_MS;
+	decon->dup.max_skips = DECON_DUP_FRAME_MAX_SKIPS;
+
 	decon->hibernation = exynos_hibernation_register(decon);
 	exynos_recovery_register(decon);
 
@@ -2702,8 +3229,10 @@ static int decon_remove(struct platform_device *pdev)
 {
 	struct decon_device *decon = platform_get_drvdata(pdev);
 
-	if (decon->thread)
+	if (decon->thread) {
+		kthread_cancel_delayed_work_sync(&decon->light_idle.dwork);
 		kthread_stop(decon->thread);
+	}
 
 	exynos_hibernation_destroy(decon->hibernation);
 
@@ -2738,6 +3267,9 @@ static int decon_runtime_suspend(struct device *dev)
 	if (decon->dqe)
 		exynos_dqe_reset(decon->dqe);
 
+	/* DPP registers may not survive the power domain going down */
+	decon_hdr_lut_cache_invalidate(decon);
+
 	DPU_EVENT_LOG(DPU_EVT_DECON_RUNTIME_SUSPEND, decon->id, NULL);
 
 	decon_debug(decon, "suspended\n");
@@ -129,6 +129,22 @@ struct decon_win_config {
 	dma_addr_t dma_addr;
 };
 
+/*
+ * Estimate of what a port balanced placement of the current windows onto DPP
+ * channels would need in DISP clock, compared with the actual placement.
+ */
+struct dpu_bts_assign_eval {
+	bool enabled;
+	u32 eval_cnt;
+	u32 better_cnt;
+	u32 fail_cnt;
+	u32 cur_freq;
+	u32 best_freq;
+	u64 saved_khz_sum;
+	/* suggested dpp_id per window, only valid for buffer windows */
+	u32 best_dpp_id[MAX_WIN_PER_DECON];
+};
+
 struct dpu_bts {
 	bool enabled;
 	bool pending_fps_update;
@@ -188,6 +204,7 @@ struct dpu_bts {
 	struct dpu_bts_win_config wb_config;
 	struct decon_win_config rcd_win_config;
 	atomic_t delayed_update;
+	struct dpu_bts_assign_eval assign;
 };
 
 struct dpu_bts_scenario {
@@ -313,6 +330,11 @@ enum dpu_event_type {
 	DPU_EVT_ITMON_ERROR,
 	DPU_EVT_SYSMMU_FAULT,
 
+	DPU_EVT_DUP_FRAME_SKIP,
+	DPU_EVT_DUP_FRAME_VERIFY,
+
+	DPU_EVT_FENCE_JOIN,
+
 	DPU_EVT_MAX, /* End of EVENT */
 };
 
@@ -443,6 +465,16 @@ struct dpu_log_decon_cfg {
 	struct decon_mode mode;
 };
 
+struct dpu_log_fence_join {
+	u32 wait_us;
+	u32 num_fences;
+	/* plane of the fence which signaled last, -1 if none had to be waited */
+	int plane_idx;
+	u64 context;
+	u64 seqno;
+	bool timeout;
+};
+
 struct dpu_log {
 	u64 ts_nsec;
 	enum dpu_event_type type;
@@ -463,6 +495,7 @@ struct dpu_log {
 		struct dpu_log_plane_info plane_info;
 		struct dpu_log_hist_info hist_info;
 		struct dpu_log_decon_cfg decon_cfg;
+		struct dpu_log_fence_join fence_join;
 		unsigned int value;
 	} data;
 };
@@ -497,6 +530,150 @@ struct decon_debug {
 	bool tout_en;
 };
 
+/*
+ * Duplicate frame detection for command mode panels. A commit whose content
+ * sequence matches the previous one is only skipped once an earlier pair of
+ * frames with that sequence produced the same DSIM CRC, and at most
+ * @max_skips times in a row before a frame is sent to check the CRC again.
+ */
+struct decon_dup_frame {
+	bool enabled;
+	/* source of crtc state content sequence numbers */
+	atomic64_t seq;
+	/* sequence whose output was verified by CRC, 0 if none */
+	u64 verified_seq;
+	/* sequence of the frame currently being transferred */
+	u64 inflight_seq;
+	/* sequence and CRC of the last transferred frame */
+	u64 last_seq;
+	u32 last_crc[3];
+	bool crc_valid;
+	/* frames skipped since the last transferred one */
+	u32 skip_streak;
+	u32 max_skips;
+
+	u32 skip_cnt;
+	u32 verify_cnt;
+	u32 mismatch_cnt;
+};
+
+/*
+ * Late-latch commit mode: on command mode panels each DPP window is programmed
+ * as soon as its own plane fence signals, only the frame trigger waits for all.
+ */
+struct decon_late_latch {
+	bool enabled;
+	u32 commit_cnt;
+
+	/* commit tail start to frame trigger */
+	u32 trigger_lat_us;
+	u32 trigger_lat_max_us;
+};
+
+#define DECON_LIGHT_IDLE_ENTRY_MS	20
+#define DECON_DUP_FRAME_MAX_SKIPS	8
+
+/*
+ * Idle mode lighter than hibernation: blocks which are not needed between
+ * frames are clock gated while DECON stays on, so histogram and CGC DMA keep
+ * running. Unused DPP channels and writeback are gated as soon as they are
+ * disabled (see their own idle gates), DSC once no frame was triggered for
+ * @entry_ms.
+ */
+struct decon_light_idle {
+	u32 entry_ms;
+	struct kthread_delayed_work dwork;
+	struct exynos_idle_gate dsc;
+};
+
+enum decon_hiber_exit_path {
+	DECON_HIBER_EXIT_SNAPSHOT,
+	DECON_HIBER_EXIT_FULL,
+	DECON_HIBER_EXIT_PATH_CNT,
+};
+
+/* register programming time of hibernation exit */
+struct decon_hiber_exit_lat {
+	u32 cnt;
+	u32 max_us;
+	u64 total_us;
+};
+
+/*
+ * Register image of the DECON configuration saved at hibernation entry. On
+ * exit it is replayed instead of running decon_reg_init(), unless the
+ * hardware version or the decon configuration changed in between.
+ */
+struct decon_hiber_snapshot {
+	bool enabled;
+	bool valid;
+	struct decon_config config;
+	struct decon_reg_snapshot regs;
+	struct decon_hiber_exit_lat exit_lat[DECON_HIBER_EXIT_PATH_CNT];
+};
+
+#define DECON_TIMELINE_DEPTH	4
+#define DECON_TIMELINE_BUCKETS	20
+
+/* log2 histogram of a frame stage latency, bucket n counts [2^(n-1), 2^n) us */
+struct decon_timeline_hist {
+	u32 buckets[DECON_TIMELINE_BUCKETS];
+	u32 cnt;
+	u32 max_us;
+};
+
+/*
+ * Per-frame timeline. Commit side stamps are carried in the crtc state and
+ * queued at frame trigger, frame start/done are stamped from the irq
+ * handlers and completed frames are reported from the irq thread. Frames are
+ * numbered in trigger order; each counter below is the number of frames that
+ * reached the corresponding point.
+ */
+struct decon_frame_timeline {
+	u64 queued;
+	u64 started;
+	u64 done;
+	u64 reported;
+	ktime_t ts[DECON_TIMELINE_DEPTH][EXYNOS_FRAME_STAGE_CNT];
+
+	/* [0] is commit to frame done, [n] is stage n - 1 to stage n */
+	struct decon_timeline_hist hist[EXYNOS_FRAME_STAGE_CNT];
+};
+
+#define DECON_IRQ_LAT_SAMPLES	256
+
+/* ring of the most recent irq handling latencies, in ns */
+struct decon_irq_lat {
+	u32 samples_ns[DECON_IRQ_LAT_SAMPLES];
+	atomic_t cnt;
+};
+
+#define DECON_IRQ_BH_FRAMEDONE		BIT(0)
+#define DECON_IRQ_BH_FRAMESTART		BIT(1)
+#define DECON_IRQ_BH_DIMMING_START	BIT(2)
+#define DECON_IRQ_BH_DIMMING_END	BIT(3)
+#define DECON_IRQ_BH_TIMEOUT		BIT(4)
+
+/*
+ * Work handed off from the hard irq handlers to the threaded bottom half.
+ * Hard handlers only ack the hardware, wake framedone waiters and set bits
+ * in pending. The irq thread takes the pending bits and the vblank event
+ * under slock, then delivers the event and does the LPD save and histogram
+ * handling after dropping it.
+ */
+struct decon_irq_bh {
+	atomic_t pending;
+	/* vblank event of the last started frame, not yet sent */
+	struct drm_pending_vblank_event *event;
+	/* time of the last hand off from a hard irq handler */
+	ktime_t ts;
+
+	struct decon_irq_lat hard;
+	struct decon_irq_lat thread;
+	/* hard irq hand off to irq thread start */
+	struct decon_irq_lat delay;
+};
+
 struct decon_device {
 	u32				id;
 	enum decon_state		state;
@@ -554,6 +731,16 @@ struct decon_device {
 	struct exynos_partial *partial;
 	bool cgc_need_update;
 	bool dqe_need_update;
+	/* steps DQE matrix transitions, queued once per frame */
+	struct kthread_work dqe_ramp_work;
+	/* trigger left unmasked by a ramp frame */
+	bool dqe_ramp_trig;
+	struct decon_dup_frame dup;
+	struct decon_late_latch late_latch;
+	struct decon_hiber_snapshot hiber_snapshot;
+	struct decon_light_idle light_idle;
+	struct decon_irq_bh irq_bh;
+	struct decon_frame_timeline timeline;
 };
 
 static inline struct decon_device *to_decon_device(const struct device *dev)
@@ -590,6 +777,12 @@ void DPU_EVENT_LOG(enum dpu_event_type type, int index, void *priv);
 void DPU_EVENT_LOG_ATOMIC_COMMIT(int index);
 void DPU_EVENT_LOG_CMD(struct dsim_device *dsim, u8 type, u8 d0, u16 len);
 void decon_force_vblank_event(struct decon_device *decon);
+int decon_send_recovery_frame(struct decon_device *decon);
+void decon_timeline_queue_locked(struct decon_device *decon, const ktime_t *frame_ts);
+void decon_timeline_stamp_locked(struct decon_device *decon,
+				 enum exynos_frame_stage stage, ktime_t ts);
+void decon_timeline_report_locked(struct decon_device *decon);
+void decon_timeline_reset_locked(struct decon_device *decon);
 
 #if IS_ENABLED(CONFIG_EXYNOS_BTS)
 void decon_mode_bts_pre_update(struct decon_device *decon,
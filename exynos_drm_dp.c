@@ -10,6 +10,7 @@
  */
 
 #include <linux/kernel.h>
+#include <linux/crc32.h>
 #include <linux/errno.h>
 #include <linux/clk.h>
 #include <linux/component.h>
@@ -625,6 +626,17 @@ static int dp_init_link_training_cr(struct dp_device *dp)
 	return 0;
 }
 
+static void dp_reset_swing_level(struct dp_device *dp)
+{
+	int i;
+
+	for (i = 0; i < MAX_LANE_CNT; i++) {
+		dp->host.vol_swing_level[i] = 0;
+		dp->host.pre_empha_level[i] = 0;
+		dp->host.max_reach_value[i] = 0;
+	}
+}
+
 static bool dp_do_link_training_cr(struct dp_device *dp, u32 interval_us)
 {
 	u8 *vol_swing_level = dp->host.vol_swing_level;
@@ -641,12 +653,6 @@ static bool dp_do_link_training_cr(struct dp_device *dp, u32 interval_us)
 	dp_info(dp, "Link Training CR Phase with Rate(%d) and Lanes(%u)\n",
 		dp->link.link_rate / 100, dp->link.num_lanes);
 
-	for (i = 0; i < MAX_LANE_CNT; i++) {
-		vol_swing_level[i] = 0;
-		pre_empha_level[i] = 0;
-		max_reach_value[i] = 0;
-	}
-
 	if (dp_init_link_training_cr(dp))
 		goto err;
 
@@ -833,6 +839,7 @@ static int dp_do_full_link_training(struct dp_device *dp, u32 interval_us)
 		}
 
 		// Link Training: CR (Clock Revovery)
+		dp_reset_swing_level(dp);
 		if (!dp_do_link_training_cr(dp, interval_us)) {
 			if (drm_dp_link_rate_to_bw_code(dp->link.link_rate) !=
 			    DP_LINK_BW_1_62) {
@@ -901,6 +908,181 @@ err:
 	return -EIO;
 }
 
+static u32 dp_get_dpcd_hash(struct dp_device *dp, const u8 *dpcd)
+{
+	/* OUI, device ID and HW/SW revisions */
+	u8 sink_id[12] = {0}, branch_id[12] = {0};
+	u32 hash;
+
+	/*
+	 * Receiver caps alone can't tell two sinks of the same family apart,
+	 * so mix in the sink and branch identification blocks as well.
+	 */
+	drm_dp_dpcd_read(&dp->dp_aux, DP_SINK_OUI, sink_id, sizeof(sink_id));
+	drm_dp_dpcd_read(&dp->dp_aux, DP_BRANCH_OUI, branch_id, sizeof(branch_id));
+
+	hash = crc32_le(~0, dpcd, DP_RECEIVER_CAP_SIZE + 1);
+	hash = crc32_le(hash, sink_id, sizeof(sink_id));
+	hash = crc32_le(hash, branch_id, sizeof(branch_id));
+
+	return hash ?: 1;
+}
+
+static struct dp_lt_cache_entry *dp_lt_cache_lookup(struct dp_device *dp, u32 dpcd_hash)
+{
+	struct dp_lt_cache *cache = &dp->lt_cache;
+	int i;
+
+	for (i = 0; i < DP_LT_CACHE_SIZE; i++) {
+		struct dp_lt_cache_entry *entry = &cache->entries[i];
+
+		if (entry->valid && entry->dpcd_hash == dpcd_hash)
+			return entry;
+	}
+
+	return NULL;
+}
+
+static void dp_lt_cache_invalidate(struct dp_device *dp)
+{
+	struct dp_lt_cache *cache = &dp->lt_cache;
+
+	if (cache->cur) {
+		cache->cur->valid = false;
+		cache->cur = NULL;
+	}
+}
+
+/* Store the current link parameters for the connected sink, evicting the LRU entry */
+static void dp_lt_cache_store(struct dp_device *dp)
+{
+	struct dp_lt_cache *cache = &dp->lt_cache;
+	struct dp_lt_cache_entry *entry;
+	int i;
+
+	entry = dp_lt_cache_lookup(dp, dp->sink.dpcd_hash);
+	if (!entry) {
+		entry = &cache->entries[0];
+		for (i = 1; i < DP_LT_CACHE_SIZE; i++) {
+			struct dp_lt_cache_entry *e = &cache->entries[i];
+
+			if (!entry->valid)
+				break;
+			if (!e->valid || time_before(e->last_used, entry->last_used))
+				entry = e;
+		}
+		entry->edid_hash = 0;
+	}
+
+	entry->dpcd_hash = dp->sink.dpcd_hash;
+	entry->link_rate = dp->link.link_rate;
+	entry->num_lanes = dp->link.num_lanes;
+	memcpy(entry->vol_swing_level, dp->host.vol_swing_level, MAX_LANE_CNT);
+	memcpy(entry->pre_empha_level, dp->host.pre_empha_level, MAX_LANE_CNT);
+	entry->last_used = jiffies;
+	entry->valid = true;
+	cache->cur = entry;
+}
+
+/*
+ * The EDID is only available after the link is up, so the entry picked at
+ * training time is validated against it here. A mismatch means a different
+ * sink reported the same DPCD identity and the entry is dropped.
+ */
+static void dp_lt_cache_check_edid(struct dp_device *dp, const struct edid *edid)
+{
+	struct dp_lt_cache_entry *entry = dp->lt_cache.cur;
+	u32 edid_hash;
+
+	if (!entry)
+		return;
+
+	edid_hash = crc32_le(~0, (const u8 *)edid, EDID_LENGTH * (edid->extensions + 1)) ?: 1;
+	if (!entry->edid_hash) {
+		entry->edid_hash = edid_hash;
+	} else if (entry->edid_hash != edid_hash) {
+		dp_info(dp, "DP Link: cached training result belongs to another sink\n");
+		dp_lt_cache_invalidate(dp);
+	}
+}
+
+static int dp_do_cached_link_training(struct dp_device *dp, u32 interval_us,
+				      const struct dp_lt_cache_entry *entry)
+{
+	const u8 supported_tps = dp_get_supported_pattern(dp);
+	int i;
+
+	dp->link.link_rate = entry->link_rate;
+	dp->link.num_lanes = entry->num_lanes;
+
+	/* Start from the levels the sink settled on last time */
+	for (i = 0; i < MAX_LANE_CNT; i++) {
+		dp->host.vol_swing_level[i] = min(entry->vol_swing_level[i],
+						  dp->host.volt_swing_max);
+		dp->host.pre_empha_level[i] = min(entry->pre_empha_level[i],
+						  dp->host.pre_emphasis_max);
+		dp->host.max_reach_value[i] = 0;
+		if (dp->host.vol_swing_level[i] == dp->host.volt_swing_max)
+			dp->host.max_reach_value[i] |= DP_TRAIN_MAX_SWING_REACHED;
+		if (dp->host.pre_empha_level[i] == dp->host.pre_emphasis_max)
+			dp->host.max_reach_value[i] |= DP_TRAIN_MAX_PRE_EMPHASIS_REACHED;
+	}
+
+	dp_info(dp, "DP Link: cached training: Rate(%d Mbps) and Lanes(%u)\n",
+		dp->link.link_rate / 100, dp->link.num_lanes);
+
+	if (!dp_do_link_training_cr(dp, interval_us) ||
+	    !dp_do_link_training_eq(dp, interval_us, supported_tps))
+		return -EIO;
+
+	dp_info(dp, "DP Link: training done: Rate(%d Mbps) and Lanes(%u)\n",
+		dp->link.link_rate / 100, dp->link.num_lanes);
+
+	dp_hw_set_training_pattern(NORMAL_DATA);
+	drm_dp_dpcd_writeb(&dp->dp_aux, DP_TRAINING_PATTERN_SET,
+			   dp->host.scrambler ? 0 : DP_LINK_SCRAMBLING_DISABLE);
+
+	return 0;
+}
+
+static int dp_do_link_training(struct dp_device *dp, u32 interval_us)
+{
+	struct dp_lt_cache *cache = &dp->lt_cache;
+	struct dp_lt_cache_entry *entry;
+	ktime_t start = ktime_get();
+	int ret;
+
+	cache->cur = NULL;
+
+	entry = dp_lt_cache_lookup(dp, dp->sink.dpcd_hash);
+	if (entry && entry->link_rate <= dp->link.link_rate &&
+	    entry->num_lanes <= dp->link.num_lanes) {
+		dp->stats.link_training_cache_hits++;
+		if (!dp_do_cached_link_training(dp, interval_us, entry))
+			goto done;
+
+		dp_info(dp, "DP Link: cached training failed, fall back to full training\n");
+		dp->stats.link_training_cache_fallbacks++;
+		entry->valid = false;
+
+		/* Restore the maximum link parameters */
+		dp->link.link_rate = dp_get_max_link_rate(dp);
+		dp->link.num_lanes = dp_get_max_num_lanes(dp);
+	} else {
+		dp->stats.link_training_cache_misses++;
+	}
+
+	ret = dp_do_full_link_training(dp, interval_us);
+	if (ret)
+		return ret;
+done:
+	dp_lt_cache_store(dp);
+	dp_info(dp, "DP Link: training took %lld ms\n",
+		ktime_ms_delta(ktime_get(), start));
+
+	return 0;
+}
+
 /* Increment stats counters based off DSC and FEC support */
 static void dp_stat_fec_dsc(struct dp_device *dp, bool dp_fec, bool dp_dsc)
 {
@@ -941,6 +1123,7 @@ static int dp_link_up(struct dp_device *dp)
 		dp->sink.support_tps = DP_SUPPORT_TPS(1) | DP_SUPPORT_TPS(2) |
 				       DP_SUPPORT_TPS(3) | DP_SUPPORT_TPS(4);
 		dp->sink.fast_training = true;
+		dp->sink.dpcd_hash = 0;
 		dp->sink_count = 1;
 
 		dp->link.link_rate = dp_get_max_link_rate(dp);
@@ -1003,6 +1186,7 @@ static int dp_link_up(struct dp_device *dp)
 
 	/* Fill Sink Capabilities */
 	dp_fill_sink_caps(dp, dpcd);
+	dp->sink.dpcd_hash = dp_get_dpcd_hash(dp, dpcd);
 
 	/* Dump Sink Capabilities */
 	dp_info(dp, "DP Sink: DPCD_%X Rate(%d Mbps) Lanes(%u) EF(%d) SSC(%d) FEC(%d) DSC(%d)\n",
@@ -1099,7 +1283,7 @@ static int dp_link_up(struct dp_device *dp)
 	/* Link Training */
 	interval = dpcd[DP_TRAINING_AUX_RD_INTERVAL] & DP_TRAINING_AUX_RD_MASK;
 	interval_us = dp_get_training_interval_us(dp, interval);
-	if (!interval_us || dp_do_full_link_training(dp, interval_us)) {
+	if (!interval_us || dp_do_link_training(dp, interval_us)) {
 		dp_err(dp, "failed to train DP Link\n");
 		mutex_unlock(&dp->training_lock);
 		dp->stats.link_negotiation_failures++;
@@ -1335,6 +1519,12 @@ static void dp_enable(struct drm_encoder *encoder)
 	dp_info(dp, "enabled DP as cur_mode = %s@%d\n", dp->cur_mode.name,
 		drm_mode_vrefresh(&dp->cur_mode));
 
+	if (dp->hpd_plug_ts) {
+		dp->stats.hotplug_to_first_frame_ms = ktime_ms_delta(ktime_get(), dp->hpd_plug_ts);
+		dp->hpd_plug_ts = 0;
+		dp_info(dp, "hotplug to first frame: %u ms\n", dp->stats.hotplug_to_first_frame_ms);
+	}
+
 	if (dp->bist_mode != DP_BIST_OFF) {
 		/* BIST mode */
 		dp->hw_config.num_audio_ch = 2;
@@ -1586,43 +1776,169 @@ static void dp_check_max_res(struct dp_device *dp, u16 h_res, u16 v_res)
 	}
 }
 
+static void dp_caps_cache_invalidate(struct dp_device *dp)
+{
+	struct dp_caps_cache *cache = &dp->caps_cache;
+	struct drm_display_mode *mode, *t;
+
+	list_for_each_entry_safe (mode, t, &cache->modes, head) {
+		list_del(&mode->head);
+		drm_mode_destroy(dp->connector.dev, mode);
+	}
+
+	kfree(cache->edid);
+	cache->edid = NULL;
+	kfree(cache->sads);
+	cache->sads = NULL;
+	cache->num_sads = 0;
+	cache->dpcd_hash = 0;
+	cache->valid = false;
+}
+
+/*
+ * Returns the cached EDID if the connected sink is the one it was read from.
+ * The DPCD identity hash computed during link up rules out most other sinks
+ * for free, but it only identifies the DP receiver, which may be a branch or
+ * scaler chip shared by different monitors. The EDID base block is always
+ * read and compared, so only the extension blocks are saved.
+ */
+static struct edid *dp_caps_cache_lookup(struct dp_device *dp)
+{
+	struct dp_caps_cache *cache = &dp->caps_cache;
+	u8 block0[EDID_LENGTH];
+
+	if (!cache->valid || !dp->sink.dpcd_hash || cache->dpcd_hash != dp->sink.dpcd_hash)
+		return NULL;
+
+	if (dp_get_edid_block(dp, block0, 0, EDID_LENGTH) < 0 ||
+	    memcmp(block0, cache->edid, EDID_LENGTH))
+		return NULL;
+
+	return kmemdup(cache->edid, EDID_LENGTH * (cache->edid->extensions + 1), GFP_KERNEL);
+}
+
+/* Caller holds mode_config.mutex, probed_modes is copied into the cache */
+static void dp_caps_cache_store(struct dp_device *dp, const struct edid *edid,
+				const struct cea_sad *sads)
+{
+	struct dp_caps_cache *cache = &dp->caps_cache;
+	struct drm_display_mode *mode, *dup;
+
+	dp_caps_cache_invalidate(dp);
+
+	if (!dp->sink.dpcd_hash)
+		return;
+
+	cache->edid = kmemdup(edid, EDID_LENGTH * (edid->extensions + 1), GFP_KERNEL);
+	if (!cache->edid)
+		return;
+
+	if (dp->num_sads > 0) {
+		cache->sads = kmemdup(sads, dp->num_sads * sizeof(*sads), GFP_KERNEL);
+		if (!cache->sads)
+			goto err;
+	}
+	cache->num_sads = max(dp->num_sads, 0);
+
+	list_for_each_entry (mode, &dp->connector.probed_modes, head) {
+		dup = drm_mode_duplicate(dp->connector.dev, mode);
+		if (!dup)
+			goto err;
+		list_add_tail(&dup->head, &cache->modes);
+	}
+
+	cache->dpcd_hash = dp->sink.dpcd_hash;
+	cache->valid = true;
+	return;
+err:
+	dp_caps_cache_invalidate(dp);
+}
+
+/* Replay the cached mode list, caller holds mode_config.mutex */
+static int dp_caps_cache_add_modes(struct dp_device *dp)
+{
+	struct drm_connector *connector = &dp->connector;
+	struct drm_display_mode *mode, *dup;
+	int num_modes = 0;
+
+	list_for_each_entry (mode, &dp->caps_cache.modes, head) {
+		dup = drm_mode_duplicate(connector->dev, mode);
+		if (!dup)
+			break;
+		drm_mode_probed_add(connector, dup);
+		num_modes++;
+	}
+
+	return num_modes;
+}
+
 static void dp_on_by_hpd_plug(struct dp_device *dp)
 {
 	struct drm_connector *connector = &dp->connector;
 	struct drm_device *dev = connector->dev;
 	struct edid *edid;
-	struct cea_sad *sads;
+	struct cea_sad *sads = NULL;
 	struct drm_display_mode *fs_mode;
+	bool cached = false, cacheable = false;
 	int timeout;
 
-	edid = drm_do_get_edid(connector, dp_get_edid_block, dp);
+	edid = dp_caps_cache_lookup(dp);
+	if (edid) {
+		dp_info(dp, "EDID: sink unchanged, using cached capabilities\n");
+		dp->stats.caps_cache_hits++;
+		cached = true;
+	} else {
+		dp->stats.caps_cache_misses++;
+		edid = drm_do_get_edid(connector, dp_get_edid_block, dp);
+	}
+
 	if (!edid) {
 		dp_err(dp, "EDID: failed to read EDID from sink, using fake EDID\n");
 		dp->stats.edid_read_failures++;
 		edid = kmemdup(dp_fake_edid, EDID_LENGTH, GFP_KERNEL);
-	} else if (!drm_edid_is_valid(edid)) {
+	} else if (!cached && !drm_edid_is_valid(edid)) {
 		dp_err(dp, "EDID: invalid EDID, using fake EDID\n");
 		dp->stats.edid_invalid_failures++;
 		kfree(edid);
 		edid = kmemdup(dp_fake_edid, EDID_LENGTH, GFP_KERNEL);
+	} else {
+		dp_lt_cache_check_edid(dp, edid);
+		cacheable = !cached;
 	}
 
 	if (drm_connector_update_edid_property(connector, edid))
 		dp_err(dp, "EDID: drm_connector_update_edid_property() failed\n");
 
 	dp_parse_edid(dp, edid);
+
+	if (cached) {
+		dp->num_sads = dp->caps_cache.num_sads;
+		dp_sad_to_audio_info(dp, dp->caps_cache.sads);
+	} else {
+		dp->num_sads = drm_edid_to_sad(edid, &sads);
+		dp_sad_to_audio_info(dp, sads);
+	}
+
 	mutex_lock(&dev->mode_config.mutex);
 	dp_clean_drm_modes(dp);
-	dp->num_modes = drm_add_edid_modes(connector, edid);
-	fs_mode = drm_mode_duplicate(connector->dev, failsafe_mode);
-	if (fs_mode) {
-		drm_mode_probed_add(connector, fs_mode);
-		dp->num_modes++;
+	if (cached) {
+		dp->num_modes = dp_caps_cache_add_modes(dp);
+	} else {
+		dp->num_modes = drm_add_edid_modes(connector, edid);
+		fs_mode = drm_mode_duplicate(connector->dev, failsafe_mode);
+		if (fs_mode) {
+			drm_mode_probed_add(connector, fs_mode);
+			dp->num_modes++;
+		}
 	}
+
+	/* modes are copied before a probe can rebuild probed_modes */
+	if (cacheable)
+		dp_caps_cache_store(dp, edid, sads);
+	else if (!cached)
+		dp_caps_cache_invalidate(dp);
 	mutex_unlock(&dev->mode_config.mutex);
 
-	dp->num_sads = drm_edid_to_sad(edid, &sads);
-	dp_sad_to_audio_info(dp, sads);
 	if (dp->num_sads > 0)
 		kfree(sads);
 	kfree(edid);
@@ -1940,6 +2256,7 @@ static void dp_work_hpd(enum hotplug_state state)
 
 	if (state == EXYNOS_HPD_PLUG) {
 		dp_info(dp, "[HPD_PLUG start]\n");
+		dp->hpd_plug_ts = ktime_get();
 
 		if (mutex_trylock(&private->dp_tui_lock) == 0) {
 			/* TUI is active, bail out */
@@ -2023,6 +2340,7 @@ static void dp_work_hpd(enum hotplug_state state)
 HPD_PLUG_FAIL:
 	dp_err(dp, "[HPD_PLUG fail] Check CCIC or USB!!\n");
 	dp_set_hpd_state(dp, EXYNOS_HPD_UNPLUG);
+	dp->hpd_plug_ts = 0;
 	hdcp_dplink_connect_state(DP_DISCONNECT);
 	dp_hw_deinit(&dp->hw_config);
 	dp_disable_dposc(dp);
@@ -3093,6 +3411,22 @@ static ssize_t dpcd_read_failures_show(struct device *dev, struct device_attribu
 }
 static DEVICE_ATTR_RO(dpcd_read_failures);
 
+static ssize_t caps_cache_hits_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct dp_device *dp = dev_get_drvdata(dev);
+
+	return sysfs_emit(buf, "%u\n", dp->stats.caps_cache_hits);
+}
+static DEVICE_ATTR_RO(caps_cache_hits);
+
+static ssize_t caps_cache_misses_show(struct device *dev, struct device_attribute *attr, char *buf)
+{
+	struct dp_device *dp = dev_get_drvdata(dev);
+
+	return sysfs_emit(buf, "%u\n", dp->stats.caps_cache_misses);
+}
+static DEVICE_ATTR_RO(caps_cache_misses);
+
 static ssize_t edid_invalid_failures_show(struct device *dev, struct device_attribute *attr,
 					  char *buf)
 {
@@ -3227,9 +3561,49 @@ static ssize_t fec_dsc_not_supported_show(struct device *dev, struct device_attr
 }
 static DEVICE_ATTR_RO(fec_dsc_not_supported);
 
+/* Link Training Cache Sysfs */
+static ssize_t link_training_cache_hits_show(struct device *dev, struct device_attribute *attr,
+					     char *buf)
+{
+	struct dp_device *dp = dev_get_drvdata(dev);
+
+	return sysfs_emit(buf, "%u\n", dp->stats.link_training_cache_hits);
+}
+static DEVICE_ATTR_RO(link_training_cache_hits);
+
+static ssize_t link_training_cache_misses_show(struct device *dev, struct device_attribute *attr,
+					       char *buf)
+{
+	struct dp_device *dp = dev_get_drvdata(dev);
+
+	return sysfs_emit(buf, "%u\n", dp->stats.link_training_cache_misses);
+}
+static DEVICE_ATTR_RO(link_training_cache_misses);
+
+static ssize_t link_training_cache_fallbacks_show(struct device *dev, struct device_attribute *attr,
+						  char *buf)
+{
+	struct dp_device *dp = dev_get_drvdata(dev);
+
+	return sysfs_emit(buf, "%u\n", dp->stats.link_training_cache_fallbacks);
+}
+static DEVICE_ATTR_RO(link_training_cache_fallbacks);
+
+/* Hotplug Latency Sysfs */
+static ssize_t hotplug_to_first_frame_ms_show(struct device *dev, struct device_attribute *attr,
+					      char *buf)
+{
+	struct dp_device *dp = dev_get_drvdata(dev);
+
+	return sysfs_emit(buf, "%u\n", dp->stats.hotplug_to_first_frame_ms);
+}
+static DEVICE_ATTR_RO(hotplug_to_first_frame_ms);
+
 static struct attribute *dp_stats_attrs[] = { &dev_attr_link_negotiation_failures.attr,
 					      &dev_attr_edid_read_failures.attr,
 					      &dev_attr_dpcd_read_failures.attr,
+					      &dev_attr_caps_cache_hits.attr,
+					      &dev_attr_caps_cache_misses.attr,
 					      &dev_attr_edid_invalid_failures.attr,
 					      &dev_attr_sink_count_invalid_failures.attr,
 					      &dev_attr_link_unstable_failures.attr,
@@ -3246,6 +3620,10 @@ static struct attribute *dp_stats_attrs[] = { &dev_attr_link_negotiation_failure
 					      &dev_attr_max_res_other.attr,
 					      &dev_attr_fec_dsc_supported.attr,
 					      &dev_attr_fec_dsc_not_supported.attr,
+					      &dev_attr_link_training_cache_hits.attr,
+					      &dev_attr_link_training_cache_misses.attr,
+					      &dev_attr_link_training_cache_fallbacks.attr,
+					      &dev_attr_hotplug_to_first_frame_ms.attr,
 					      NULL };
 
 static const struct attribute_group dp_stats_group = {
@@ -3332,6 +3710,8 @@ static int dp_probe(struct platform_device *pdev)
 		goto err;
 	}
 
+	INIT_LIST_HEAD(&dp->caps_cache.modes);
+
 	INIT_WORK(&dp->hpd_plug_work, dp_work_hpd_plug);
 	INIT_WORK(&dp->hpd_unplug_work, dp_work_hpd_unplug);
 	INIT_WORK(&dp->hpd_irq_work, dp_work_hpd_irq);
@@ -3368,6 +3748,8 @@ static int dp_remove(struct platform_device *pdev)
 	mutex_destroy(&dp->training_lock);
 	mutex_destroy(&dp->typec_notification_lock);
 
+	dp_caps_cache_invalidate(dp);
+
 	sysfs_remove_group(&dev->kobj, &dp_group);
 	sysfs_remove_group(&dev->kobj, &dp_stats_group);
 
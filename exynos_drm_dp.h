@@ -92,6 +92,8 @@ struct dp_sink {
 	bool dsc;
 	bool fec;
 	bool ssc;
+	/* hash of DPCD receiver caps and sink/branch identification */
+	u32  dpcd_hash;
 
 	/* From EDID */
 	char sink_name[SINK_NAME_LEN];
@@ -152,6 +154,8 @@ struct dp_stats_counters {
 	u32 link_negotiation_failures;
 	u32 edid_read_failures;
 	u32 dpcd_read_failures;
+	u32 caps_cache_hits;
+	u32 caps_cache_misses;
 	u32 edid_invalid_failures;
 	u32 sink_count_invalid_failures;
 	u32 link_unstable_failures;
@@ -170,6 +174,43 @@ struct dp_stats_counters {
 
 	u32 fec_dsc_supported;
 	u32 fec_dsc_not_supported;
+
+	u32 link_training_cache_hits;
+	u32 link_training_cache_misses;
+	u32 link_training_cache_fallbacks;
+	u32 hotplug_to_first_frame_ms;
+};
+
+#define DP_LT_CACHE_SIZE	4
+
+/* last successful link training result of a sink */
+struct dp_lt_cache_entry {
+	/* hash of DPCD receiver caps and sink/branch identification */
+	u32 dpcd_hash;
+	/* hash of the full EDID, 0 until it has been read from this sink */
+	u32 edid_hash;
+	int link_rate;
+	u8  num_lanes;
+	u8  vol_swing_level[MAX_LANE_CNT];
+	u8  pre_empha_level[MAX_LANE_CNT];
+	unsigned long last_used;
+	bool valid;
+};
+
+struct dp_lt_cache {
+	struct dp_lt_cache_entry entries[DP_LT_CACHE_SIZE];
+	/* entry matching the currently connected sink, NULL if none */
+	struct dp_lt_cache_entry *cur;
+};
+
+/* EDID derived data of the last connected sink */
+struct dp_caps_cache {
+	u32 dpcd_hash;
+	struct edid *edid;
+	struct cea_sad *sads;
+	int num_sads;
+	struct list_head modes;
+	bool valid;
 };
 
 /* DisplayPort Device */
@@ -242,6 +283,15 @@ struct dp_device {
 
 	/* DP stats/error counters */
 	struct dp_stats_counters stats;
+
+	/* Link training results of recently connected sinks */
+	struct dp_lt_cache lt_cache;
+
+	/* EDID, audio SADs and modes of the last connected sink */
+	struct dp_caps_cache caps_cache;
+
+	/* HPD_PLUG start time, cleared once the first frame is sent */
+	ktime_t hpd_plug_ts;
 };
 
 static inline struct dp_device *get_dp_drvdata(void)
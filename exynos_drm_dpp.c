@@ -29,6 +29,7 @@
 #include <linux/dma-buf.h>
 #include <linux/soc/samsung/exynos-smc.h>
 #include <linux/dma-heap.h>
+#include <linux/xxhash.h>
 
 #if IS_ENABLED(CONFIG_ARM_EXYNOS_DEVFREQ)
 #include <soc/google/exynos-devfreq.h>
@@ -45,6 +46,7 @@
 #include <hdr_cal.h>
 #include <regs-dpp.h>
 #include <soc/google/debug-snapshot.h>
+#include <trace/dpu_trace.h>
 
 #include "exynos_drm_decon.h"
 #include "exynos_drm_crtc.h"
@@ -598,8 +600,8 @@ static int dpp_convert_plane_state_to_config(struct dpp_params_info *config,
 	else
 		config->is_scale = false;
 
-	if (state->block) {
-		struct decon_win_rect *block = (struct decon_win_rect *)state->block->data;
+	if (state->blobs->block) {
+		struct decon_win_rect *block = (struct decon_win_rect *)state->blobs->block->data;
 		config->block.x = block->x;
 		config->block.y = block->y;
 		config->block.w = block->w;
@@ -622,6 +624,8 @@ static void __dpp_enable(struct dpp_device *dpp)
 	if (dpp->state == DPP_STATE_ON)
 		return;
 
+	/* dpp_reg_init() turns the gating off */
+	exynos_idle_gate_exit(&dpp->idle_gate);
 	dpp_reg_init(dpp->id, dpp->attr);
 
 	dpp->state = DPP_STATE_ON;
@@ -778,8 +782,11 @@ static void __dpp_disable(struct dpp_device *dpp)
 	disable_irq_nosync(dpp->dma_irq);
 
 	dpp_reg_deinit(dpp->id, false, dpp->attr);
+	if (exynos_idle_gate_enter(&dpp->idle_gate))
+		dpp_reg_set_clock_gating(dpp->id, dpp->attr, true);
 
 	set_protection(dpp, 0);
+	dpp->hw_config_valid = false;
 	dpp->state = DPP_STATE_OFF;
 	dpp->decon_id = -1;
 
@@ -996,6 +1003,38 @@ err:
 	return -ENOTSUPP;
 }
 
+void dpp_hdr_lut_cache_invalidate(struct dpp_device *dpp)
+{
+	memset(dpp->hdr.lut_cache.valid, 0, sizeof(dpp->hdr.lut_cache.valid));
+}
+
+/*
+ * Returns true if @data matches what was last written to the @type block and
+ * the registers can be reused. Otherwise remembers @data as the new contents.
+ */
+static bool exynos_hdr_lut_cached(struct dpp_device *dpp, enum hdr_lut_type type,
+				  const void *data, size_t size, bool force)
+{
+	struct hdr_lut_cache *cache = &dpp->hdr.lut_cache;
+	u64 hash;
+
+	/* disabling only clears the enable bit, the LUT stays intact */
+	if (!data)
+		return false;
+
+	hash = xxh64(data, size, 0);
+	if (!force && cache->valid[type] && cache->hash[type] == hash) {
+		cache->hit_cnt++;
+		return true;
+	}
+
+	cache->hash[type] = hash;
+	cache->valid[type] = true;
+	cache->miss_cnt++;
+
+	return false;
+}
+
 static void
 exynos_eotf_update(struct dpp_device *dpp, struct exynos_drm_plane_state *state)
 {
@@ -1009,7 +1048,11 @@ exynos_eotf_update(struct dpp_device *dpp, struct exynos_drm_plane_state *state)
 		state->hdr_state.eotf_lut = &eotf->force_lut;
 
 	if (dpp->hdr.state.eotf_lut != state->hdr_state.eotf_lut || info->dirty) {
-		hdr_reg_set_eotf_lut(dpp->id, state->hdr_state.eotf_lut);
+		if (exynos_hdr_lut_cached(dpp, HDR_LUT_EOTF, state->hdr_state.eotf_lut,
+					  sizeof(*state->hdr_state.eotf_lut), info->dirty))
+			hdr_reg_enable_lut(dpp->id, HDR_LUT_EOTF);
+		else
+			hdr_reg_set_eotf_lut(dpp->id, state->hdr_state.eotf_lut);
 		dpp->hdr.state.eotf_lut = state->hdr_state.eotf_lut;
 		info->dirty = false;
 	}
@@ -1031,7 +1074,11 @@ exynos_oetf_update(struct dpp_device *dpp, struct exynos_drm_plane_state *state)
 		state->hdr_state.oetf_lut = &oetf->force_lut;
 
 	if (dpp->hdr.state.oetf_lut != state->hdr_state.oetf_lut || info->dirty) {
-		hdr_reg_set_oetf_lut(dpp->id, state->hdr_state.oetf_lut);
+		if (exynos_hdr_lut_cached(dpp, HDR_LUT_OETF, state->hdr_state.oetf_lut,
+					  sizeof(*state->hdr_state.oetf_lut), info->dirty))
+			hdr_reg_enable_lut(dpp->id, HDR_LUT_OETF);
+		else
+			hdr_reg_set_oetf_lut(dpp->id, state->hdr_state.oetf_lut);
 		dpp->hdr.state.oetf_lut = state->hdr_state.oetf_lut;
 		info->dirty = false;
 	}
@@ -1053,7 +1100,11 @@ exynos_gm_update(struct dpp_device *dpp, struct exynos_drm_plane_state *state)
 		state->hdr_state.gm = &gm->force_data;
 
 	if (dpp->hdr.state.gm != state->hdr_state.gm || info->dirty) {
-		hdr_reg_set_gm(dpp->id, state->hdr_state.gm);
+		if (exynos_hdr_lut_cached(dpp, HDR_LUT_GM, state->hdr_state.gm,
+					  sizeof(*state->hdr_state.gm), info->dirty))
+			hdr_reg_enable_lut(dpp->id, HDR_LUT_GM);
+		else
+			hdr_reg_set_gm(dpp->id, state->hdr_state.gm);
 		dpp->hdr.state.gm = state->hdr_state.gm;
 		info->dirty = false;
 	}
@@ -1075,7 +1126,11 @@ exynos_tm_update(struct dpp_device *dpp, struct exynos_drm_plane_state *state)
 		state->hdr_state.tm = &tm->force_data;
 
 	if (dpp->hdr.state.tm != state->hdr_state.tm || info->dirty) {
-		hdr_reg_set_tm(dpp->id, state->hdr_state.tm);
+		if (exynos_hdr_lut_cached(dpp, HDR_LUT_TM, state->hdr_state.tm,
+					  sizeof(*state->hdr_state.tm), info->dirty))
+			hdr_reg_enable_lut(dpp->id, HDR_LUT_TM);
+		else
+			hdr_reg_set_tm(dpp->id, state->hdr_state.tm);
 		dpp->hdr.state.tm = state->hdr_state.tm;
 		info->dirty = false;
 	}
@@ -1100,6 +1155,21 @@ static void dpp_hdr_update(struct dpp_device *dpp,
 	hdr_reg_set_hdr(dpp->id, enable);
 }
 
+/* true if @config differs from what is in the channel only by buffer addresses */
+static bool dpp_config_addr_only(const struct dpp_device *dpp,
+				 const struct dpp_params_info *config)
+{
+	struct dpp_params_info tmp;
+
+	if (!dpp->hw_config_valid || test_bit(DPP_ATTR_RCD, &dpp->attr))
+		return false;
+
+	memcpy(&tmp, config, sizeof(tmp));
+	memcpy(tmp.addr, dpp->hw_config.addr, sizeof(tmp.addr));
+
+	return !memcmp(&tmp, &dpp->hw_config, sizeof(tmp));
+}
+
 static int dpp_update(struct dpp_device *dpp,
 			struct exynos_drm_plane_state *state)
 {
@@ -1109,6 +1179,7 @@ static int dpp_update(struct dpp_device *dpp,
 	const struct drm_display_mode *mode = &crtc_state->adjusted_mode;
 	const struct exynos_drm_crtc_state *exynos_crtc_state =
 					to_exynos_crtc_state(crtc_state);
+	bool protection;
 	int ret = 0;
 
 	dpp_debug(dpp, "+\n");
@@ -1126,9 +1197,24 @@ static int dpp_update(struct dpp_device *dpp,
 	if (test_bit(DPP_ATTR_HDR, &dpp->attr))
 		dpp_hdr_update(dpp, state);
 
+	protection = dpp->protection;
 	set_protection(dpp, plane_state->fb->modifier);
-
-	dpp_reg_configure_params(dpp->id, config, dpp->attr);
+	if (protection != dpp->protection)
+		dpp->hw_config_valid = false;
+
+	if (dpp_config_addr_only(dpp, config)) {
+		DPU_ATRACE_BEGIN("dpp_set_base_addr");
+		dpp_reg_set_base_addr(dpp->id, config, dpp->attr);
+		DPU_ATRACE_END("dpp_set_base_addr");
+		dpp->addr_only_cnt++;
+	} else {
+		DPU_ATRACE_BEGIN("dpp_configure_params");
+		dpp_reg_configure_params(dpp->id, config, dpp->attr);
+		DPU_ATRACE_END("dpp_configure_params");
+		dpp->full_config_cnt++;
+	}
+	memcpy(&dpp->hw_config, config, sizeof(dpp->hw_config));
+	dpp->hw_config_valid = true;
 
 	dpp_debug(dpp, "-\n");
 
@@ -1357,8 +1443,10 @@ static irqreturn_t cgc_irq_handler(int irq, void *priv)
 
 	irqs = cgc_reg_get_irq_and_clear(dma->id);
 
-	if (irqs & IDMA_STATUS_FRAMEDONE_IRQ)
+	if (irqs & IDMA_STATUS_FRAMEDONE_IRQ) {
 		DPU_EVENT_LOG(DPU_EVT_CGC_FRAMEDONE, decon->id, NULL);
+		complete(&dma->done);
+	}
 
 	spin_unlock(&dma->dma_slock);
 	return IRQ_HANDLED;
@@ -1526,6 +1614,7 @@ struct exynos_dma *exynos_cgc_dma_register(struct decon_device *decon)
 	dpp_regs_desc_init(dma->regs, res.start, "cgc-dma", REGS_DMA, dma->id);
 
 	spin_lock_init(&dma->dma_slock);
+	init_completion(&dma->done);
 	dma->dma_irq = of_irq_get_byname(np, "cgc-dma");
 	ret = devm_request_irq(dev, dma->dma_irq, cgc_irq_handler, 0,
 			pdev->name, decon);
@@ -14,13 +14,16 @@
 #ifndef _EXYNOS_DRM_DPP_H_
 #define _EXYNOS_DRM_DPP_H_
 
+#include <linux/completion.h>
 #include <drm/samsung_drm.h>
 #include <drm/drm_fourcc_gs101.h>
 
 #include <dpp_cal.h>
+#include <hdr_cal.h>
 
 #include "exynos_drm_drv.h"
 #include "exynos_drm_dqe.h"
+#include "exynos_drm_hibernation.h"
 
 enum EXYNOS9_DPP_FEATURES {
 	/* Can reads the graphical image */
@@ -71,8 +74,21 @@ struct tm_debug_override {
 #endif
 };
 
+/*
+ * Content hash of the curve last written to each HDR block. The LUT registers
+ * keep their contents while the block is only disabled, so a curve coming back
+ * with the same contents needs just its enable bit set again.
+ */
+struct hdr_lut_cache {
+	u64 hash[HDR_LUT_MAX];
+	bool valid[HDR_LUT_MAX];
+	u32 hit_cnt;
+	u32 miss_cnt;
+};
+
 struct exynos_hdr {
 	struct exynos_hdr_state state;
+	struct hdr_lut_cache lut_cache;
 
 	struct eotf_debug_override eotf;
 	struct oetf_debug_override oetf;
@@ -90,6 +106,7 @@ struct dpp_device {
 	u32 port;
 	unsigned long attr;
 	enum dpp_state state;
+	struct exynos_idle_gate idle_gate;
 
 	int dma_irq;
 	int dpp_irq;
@@ -101,6 +118,15 @@ struct dpp_device {
 
 	struct dpp_regs	regs;
 	struct dpp_params_info win_config;
+	/*
+	 * Parameters last fully programmed into the channel. A later update
+	 * that differs only in buffer addresses rewrites just the base address
+	 * registers. Dropped whenever the channel is disabled.
+	 */
+	struct dpp_params_info hw_config;
+	bool hw_config_valid;
+	u32 addr_only_cnt;
+	u32 full_config_cnt;
 
 	spinlock_t slock;
 	spinlock_t dma_slock;
@@ -147,6 +173,8 @@ struct exynos_dma {
 	void __iomem *regs;
 	int dma_irq;
 	spinlock_t dma_slock;
+	/* signaled from frame done irq of the last started transfer */
+	struct completion done;
 };
 
 #ifdef CONFIG_OF
@@ -163,6 +191,7 @@ void rcd_dump(struct drm_printer *p, struct dpp_device *dpp);
 void dpp_dump_buffer(struct drm_printer *p, struct dpp_device *dpp);
 void cgc_dump(struct drm_printer *p, struct exynos_dma *dma);
 bool dpp_need_enable_hdr(const struct dpp_device *dpp);
+void dpp_hdr_lut_cache_invalidate(struct dpp_device *dpp);
 
 static __always_inline const char *get_comp_src_name(u64 comp_src)
 {
@@ -13,6 +13,8 @@
 
 #include <linux/of_address.h>
 #include <linux/device.h>
+#include <linux/dma-buf.h>
+#include <linux/xxhash.h>
 #include <drm/drm_drv.h>
 #include <drm/drm_modeset_lock.h>
 #include <drm/drm_atomic_helper.h>
@@ -687,7 +689,7 @@ void histogram_flip_done(struct exynos_dqe *dqe, const struct drm_crtc_state *ne
 
 	for (hist_id = 0; hist_id < HISTOGRAM_MAX; hist_id++) {
 		struct histogram_chan_state *hist_chan = &dqe->state.hist_chan[hist_id];
-		struct drm_property_blob *blob = new_exynos_crtc_state->histogram[hist_id];
+		struct drm_property_blob *blob = new_exynos_crtc_state->blobs->histogram[hist_id];
 
 		/*
 		 * For run_state is HSTATE_HIBERNATION and state is HISTOGRAM_OFF, we should keep it
@@ -822,26 +824,153 @@ static void exynos_gamma_matrix_update(struct exynos_dqe *dqe,
 		dqe_reg_print_gamma_matrix(id, &p);
 }
 
+/* what hw does when the linear matrix is bypassed */
+static const struct exynos_matrix linear_matrix_identity = {
+	.coeffs = {
+		0x1fff, 0, 0,
+		0, 0x1fff, 0,
+		0, 0, 0x1fff
+	},
+};
+
+static u16 exynos_matrix_lerp(u16 from, u16 to, int bits, u32 num, u32 den)
+{
+	const s32 a = sign_extend32(from, bits - 1);
+	const s32 b = sign_extend32(to, bits - 1);
+
+	return (a + (s32)div_s64((s64)(b - a) * num, den)) & GENMASK(bits - 1, 0);
+}
+
+static bool exynos_matrix_transition_same_target(const struct matrix_transition *tr,
+						 const struct exynos_matrix *matrix)
+{
+	if (!tr->active)
+		return false;
+
+	if (!matrix)
+		return tr->to_bypass;
+
+	return !tr->to_bypass && !memcmp(&tr->to, matrix, sizeof(*matrix));
+}
+
+static void exynos_matrix_transition_set_cur(struct matrix_transition *tr,
+					     const struct exynos_matrix *matrix)
+{
+	tr->cur = matrix ? *matrix : linear_matrix_identity;
+	tr->cur_valid = true;
+}
+
+static void exynos_matrix_transition_start(struct matrix_transition *tr,
+					   const struct exynos_matrix *target, u32 ms)
+{
+	tr->from = tr->cur;
+	tr->to = target ? *target : linear_matrix_identity;
+	tr->to_bypass = !target;
+	tr->start_ts = ktime_get();
+	tr->elapsed_us = 0;
+	tr->duration_us = ms * USEC_PER_MSEC;
+	tr->paused = false;
+	tr->stats.start_cnt++;
+	WRITE_ONCE(tr->active, true);
+}
+
+static void exynos_matrix_transition_cancel(struct matrix_transition *tr)
+{
+	if (!tr->active)
+		return;
+
+	WRITE_ONCE(tr->active, false);
+	tr->paused = false;
+	tr->stats.cancel_cnt++;
+}
+
+/*
+ * Writes the next interpolated linear matrix of an ongoing transition.
+ * Called with decon slock held once per frame, returns true if hw needs
+ * a DQE shadow update.
+ */
+bool exynos_dqe_matrix_transition_step(struct exynos_dqe *dqe)
+{
+	struct matrix_transition *tr = &dqe->linear_tr;
+	struct decon_device *decon = dqe->decon;
+	u32 elapsed_us;
+	int i;
+
+	if (!tr->active || tr->paused || !dqe->state.enabled)
+		return false;
+
+	elapsed_us = tr->elapsed_us + ktime_us_delta(ktime_get(), tr->start_ts);
+	if (elapsed_us >= tr->duration_us) {
+		tr->cur = tr->to;
+		dqe_reg_set_linear_matrix(decon->id, tr->to_bypass ? NULL : &tr->to);
+		WRITE_ONCE(tr->active, false);
+		tr->stats.done_cnt++;
+	} else {
+		for (i = 0; i < ARRAY_SIZE(tr->cur.coeffs); i++)
+			tr->cur.coeffs[i] = exynos_matrix_lerp(tr->from.coeffs[i],
+					tr->to.coeffs[i], LINEAR_MATRIX_COEFF_BITS,
+					elapsed_us, tr->duration_us);
+		for (i = 0; i < ARRAY_SIZE(tr->cur.offsets); i++)
+			tr->cur.offsets[i] = exynos_matrix_lerp(tr->from.offsets[i],
+					tr->to.offsets[i], LINEAR_MATRIX_OFFSET_BITS,
+					elapsed_us, tr->duration_us);
+		dqe_reg_set_linear_matrix(decon->id, &tr->cur);
+	}
+
+	tr->stats.step_cnt++;
+	DPU_ATRACE_INT_PID("linear_matrix_ramp", tr->active, decon->thread->pid);
+
+	return true;
+}
+
 static void exynos_linear_matrix_update(struct exynos_dqe *dqe,
 					struct exynos_dqe_state *state)
 {
 	struct matrix_debug_override *linear = &dqe->linear;
 	struct exynos_debug_info *info = &linear->info;
+	struct matrix_transition *tr = &dqe->linear_tr;
 	struct decon_device *decon = dqe->decon;
 	struct drm_printer p = drm_info_printer(decon->dev);
 	u32 id = decon->id;
+	unsigned long flags;
 
 	pr_debug("en(%d) dirty(%d)\n", info->force_en, info->dirty);
 
 	if (info->force_en)
 		state->linear_matrix = &linear->force_matrix;
 
+	/*
+	 * Blocking commits get here outside of decon worker, so the transition
+	 * and its register writes are serialized with the ramp step by slock.
+	 */
+	spin_lock_irqsave(&decon->slock, flags);
+
+	/* registers were lost in hibernation, put back the last step and go on */
+	if (tr->paused) {
+		dqe_reg_set_linear_matrix(id, &tr->cur);
+		dqe->state.linear_matrix = tr->to_bypass ? NULL : &tr->to;
+		tr->start_ts = ktime_get();
+		tr->paused = false;
+	}
+
 	if (dqe->state.linear_matrix != state->linear_matrix || info->dirty) {
-		dqe_reg_set_linear_matrix(id, state->linear_matrix);
+		if (state->linear_matrix_ms && tr->cur_valid && !info->force_en &&
+		    !info->dirty) {
+			/* same target with a new pointer keeps the ongoing ramp */
+			if (!exynos_matrix_transition_same_target(tr, state->linear_matrix))
+				exynos_matrix_transition_start(tr, state->linear_matrix,
+							       state->linear_matrix_ms);
+		} else {
+			exynos_matrix_transition_cancel(tr);
+			dqe_reg_set_linear_matrix(id, state->linear_matrix);
+			exynos_matrix_transition_set_cur(tr, state->linear_matrix);
+		}
 		dqe->state.linear_matrix = state->linear_matrix;
 		info->dirty = false;
 	}
 
+	spin_unlock_irqrestore(&decon->slock, flags);
+
 	if (info->verbose)
 		dqe_reg_print_linear_matrix(id, &p);
 }
@@ -1026,24 +1155,297 @@ static void exynos_rcd_update(struct exynos_dqe *dqe, struct exynos_dqe_state *s
 	}
 }
 
+#define CGC_DMA_LUT_SIZE \
+	(sizeof(struct cgc_dma_lut) * DRM_SAMSUNG_CGC_DMA_LUT_ENTRY_CNT)
+
+static struct cgc_cache_slot *cgc_cache_find_buf(struct cgc_cache *cache,
+						 const struct dma_buf *dma_buf)
+{
+	int i;
+
+	for (i = 0; i < CGC_CACHE_SLOT_CNT; i++) {
+		struct cgc_cache_slot *slot = &cache->slots[i];
+
+		if (slot->gem && slot->gem->import_attach &&
+		    slot->gem->import_attach->dmabuf == dma_buf)
+			return slot;
+	}
+
+	return NULL;
+}
+
+static struct cgc_cache_slot *cgc_cache_find_gem(struct cgc_cache *cache,
+						 const struct drm_gem_object *gem)
+{
+	int i;
+
+	for (i = 0; i < CGC_CACHE_SLOT_CNT; i++)
+		if (cache->slots[i].gem == gem)
+			return &cache->slots[i];
+
+	return NULL;
+}
+
+/* least recently used slot which is neither active nor pending */
+static struct cgc_cache_slot *cgc_cache_victim(struct cgc_cache *cache)
+{
+	struct cgc_cache_slot *victim = NULL;
+	int i;
+
+	for (i = 0; i < CGC_CACHE_SLOT_CNT; i++) {
+		struct cgc_cache_slot *slot = &cache->slots[i];
+
+		if (!slot->gem)
+			return slot;
+
+		if (slot->gem == cache->active || slot->gem == cache->pending)
+			continue;
+
+		if (!victim || slot->last_use < victim->last_use)
+			victim = slot;
+	}
+
+	return victim;
+}
+
+/*
+ * Resolve a CGC LUT dma-buf fd to a gem object, reusing an already imported
+ * and mapped buffer with the same dma-buf when possible.
+ * Returned gem holds a reference for the caller.
+ */
+struct drm_gem_object *exynos_dqe_cgc_gem_get(struct exynos_dqe *dqe, int fd)
+{
+	struct cgc_cache *cache = &dqe->cgc_cache;
+	struct cgc_cache_stats *stats = &cache->stats;
+	struct drm_device *drm_dev = dqe->decon->drm_dev;
+	struct drm_gem_object *gem, *put_gem = NULL;
+	struct cgc_cache_slot *slot;
+	struct dma_buf *dma_buf;
+	const void *vaddr;
+	ktime_t start = ktime_get();
+	bool hit = true;
+	u32 delta_us;
+	u64 hash;
+
+	dma_buf = dma_buf_get(fd);
+	if (IS_ERR(dma_buf)) {
+		pr_err("failed to get dma buf\n");
+		return NULL;
+	}
+
+	mutex_lock(&cache->lock);
+
+	slot = cgc_cache_find_buf(cache, dma_buf);
+	if (slot) {
+		/* content may have been rewritten in place */
+		slot->hash = xxh64(slot->vaddr, CGC_DMA_LUT_SIZE, 0);
+		stats->buf_hit_cnt++;
+		goto out;
+	}
+
+	gem = exynos_drm_gem_prime_import(drm_dev, dma_buf);
+	if (IS_ERR_OR_NULL(gem)) {
+		mutex_unlock(&cache->lock);
+		dma_buf_put(dma_buf);
+		return NULL;
+	}
+
+	vaddr = gem->size >= CGC_DMA_LUT_SIZE ?
+		exynos_drm_gem_get_vaddr(to_exynos_gem(gem)) : NULL;
+	if (!vaddr) {
+		/* not cacheable, behave as a plain import */
+		stats->miss_cnt++;
+		mutex_unlock(&cache->lock);
+		dma_buf_put(dma_buf);
+		return gem;
+	}
+
+	/*
+	 * Slots are only shared by the same dma-buf: a buffer of another client
+	 * with equal content can be rewritten or freed behind our back.
+	 */
+	hash = xxh64(vaddr, CGC_DMA_LUT_SIZE, 0);
+	hit = false;
+	stats->miss_cnt++;
+	slot = cgc_cache_victim(cache);
+	if (!slot) {
+		mutex_unlock(&cache->lock);
+		dma_buf_put(dma_buf);
+		return gem;
+	}
+
+	if (slot->gem) {
+		put_gem = slot->gem;
+		stats->evict_cnt++;
+	}
+	/* reference from import is kept by the cache */
+	slot->gem = gem;
+	slot->vaddr = vaddr;
+	slot->hash = hash;
+out:
+	slot->last_use = ++cache->use_seq;
+	cache->pending = slot->gem;
+	gem = slot->gem;
+	drm_gem_object_get(gem);
+
+	delta_us = ktime_us_delta(ktime_get(), start);
+	if (hit) {
+		stats->hit_total_us += delta_us;
+		stats->hit_max_us = max(stats->hit_max_us, delta_us);
+	} else {
+		stats->miss_total_us += delta_us;
+		stats->miss_max_us = max(stats->miss_max_us, delta_us);
+	}
+	mutex_unlock(&cache->lock);
+
+	if (put_gem)
+		drm_gem_object_put(put_gem);
+	dma_buf_put(dma_buf);
+
+	return gem;
+}
+
+void exynos_dqe_cgc_cache_release(struct exynos_dqe *dqe)
+{
+	struct cgc_cache *cache = &dqe->cgc_cache;
+	int i;
+
+	mutex_lock(&cache->lock);
+	cache->active = NULL;
+	cache->pending = NULL;
+	for (i = 0; i < CGC_CACHE_SLOT_CNT; i++) {
+		struct cgc_cache_slot *slot = &cache->slots[i];
+
+		if (slot->gem)
+			drm_gem_object_put(slot->gem);
+		memset(slot, 0, sizeof(*slot));
+	}
+	mutex_unlock(&cache->lock);
+}
+
+static void exynos_cgc_cache_set_active(struct exynos_dqe *dqe, struct drm_gem_object *gem)
+{
+	struct cgc_cache *cache = &dqe->cgc_cache;
+	struct cgc_cache_slot *slot;
+
+	mutex_lock(&cache->lock);
+	slot = gem ? cgc_cache_find_gem(cache, gem) : NULL;
+	cache->active = slot ? gem : NULL;
+	cache->active_hash = slot ? slot->hash : 0;
+	mutex_unlock(&cache->lock);
+}
+
+/* @gem is what hw has loaded, and its content did not change since */
+static bool exynos_cgc_cache_is_loaded(struct exynos_dqe *dqe, struct drm_gem_object *gem)
+{
+	struct cgc_cache *cache = &dqe->cgc_cache;
+	struct cgc_cache_slot *slot;
+	bool loaded = false;
+
+	mutex_lock(&cache->lock);
+	if (gem && cache->active == gem) {
+		slot = cgc_cache_find_gem(cache, gem);
+		loaded = slot && slot->hash == cache->active_hash;
+	}
+	mutex_unlock(&cache->lock);
+
+	return loaded;
+}
+
 #define CGC_DMA_REQ_TIMEOUT_US 300
-static void exynos_set_cgc_dma(struct decon_device *decon, struct exynos_dqe_state *state)
+static void exynos_set_cgc_dma(struct exynos_dqe *dqe, const struct exynos_dqe_state *state)
 {
+	struct decon_device *decon = dqe->decon;
+	struct exynos_dma *dma = decon->cgc_dma;
 	struct exynos_drm_gem *exynos_cgc_gem;
 	u32 id = decon->id;
-	u32 cgc_dma_id = decon->cgc_dma->id;
+	ktime_t start = ktime_get();
 
 	if (!state->cgc_gem) {
 		dqe_reg_set_cgc_en(id, 0);
-		cgc_reg_set_config(cgc_dma_id, 0, 0);
+		cgc_reg_set_config(dma->id, 0, 0);
 	} else {
 		dqe_reg_set_cgc_en(id, 1);
 		exynos_cgc_gem = to_exynos_gem(state->cgc_gem);
-		cgc_reg_set_config(cgc_dma_id, 1, exynos_cgc_gem->dma_addr);
+		cgc_reg_set_config(dma->id, 1, exynos_cgc_gem->dma_addr);
+		reinit_completion(&dma->done);
 		dqe_reg_set_cgc_coef_dma_req(id);
-		cgc_reg_set_cgc_start(cgc_dma_id);
-		dqe_reg_wait_cgc_dma_done(id, CGC_DMA_REQ_TIMEOUT_US);
+		cgc_reg_set_cgc_start(dma->id);
+		/* completion is waited for right before DQE shadow update */
+		dqe->cgc.dma_pending = true;
+	}
+	exynos_cgc_cache_set_active(dqe, state->cgc_gem);
+
+	dqe->cgc.commit_us += ktime_us_delta(ktime_get(), start);
+}
+
+static bool exynos_cgc_dma_needed(struct exynos_dqe *dqe,
+				  const struct exynos_dqe_state *state)
+{
+	if (!dqe->decon->cgc_dma || dqe->cgc.info.force_en)
+		return false;
+
+	if (dqe->state.cgc_gem != state->cgc_gem || dqe->cgc.first_write)
+		return true;
+
+	/* same buffer, reload unless cache knows its content is unchanged */
+	return state->cgc_gem && !exynos_cgc_cache_is_loaded(dqe, state->cgc_gem);
+}
+
+/*
+ * Start loading CGC coefficients at commit begin, so that the DMA runs while
+ * the rest of the commit is programmed. Only done when DQE stays enabled,
+ * otherwise it is left to the update path which (re)initializes DQE first.
+ */
+void exynos_dqe_prepare_cgc(struct exynos_dqe *dqe, const struct exynos_dqe_state *state)
+{
+	struct cgc_debug_override *cgc = &dqe->cgc;
+
+	if (!dqe->initialized || !dqe->state.enabled || dqe->force_disabled ||
+	    !state->enabled || !state->cgc_gem || cgc->dma_pending)
+		return;
+
+	if (!exynos_cgc_dma_needed(dqe, state))
+		return;
+
+	DPU_ATRACE_BEGIN(__func__);
+	exynos_set_cgc_dma(dqe, state);
+	cgc->dma_started = true;
+	cgc->dma_gem = state->cgc_gem;
+	cgc->stats.early_cnt++;
+	DPU_ATRACE_END(__func__);
+}
+
+/* CGC coefficients must be loaded before DQE shadow update latches them */
+void exynos_dqe_wait_cgc(struct exynos_dqe *dqe)
+{
+	struct cgc_debug_override *cgc = &dqe->cgc;
+	struct cgc_dma_stats *stats = &cgc->stats;
+	struct decon_device *decon = dqe->decon;
+	ktime_t start;
+
+	if (cgc->dma_pending) {
+		DPU_ATRACE_BEGIN(__func__);
+		start = ktime_get();
+		if (!wait_for_completion_timeout(&decon->cgc_dma->done,
+				usecs_to_jiffies(CGC_DMA_REQ_TIMEOUT_US)))
+			stats->timeout_cnt++;
+		/* confirm coefficient load on DQE side, normally done by now */
+		dqe_reg_wait_cgc_dma_done(decon->id, CGC_DMA_REQ_TIMEOUT_US);
+		cgc->commit_us += ktime_us_delta(ktime_get(), start);
+		cgc->dma_pending = false;
+		DPU_ATRACE_END(__func__);
 	}
+
+	if (!cgc->commit_us)
+		return;
+
+	stats->cnt++;
+	stats->total_us += cgc->commit_us;
+	if (cgc->commit_us > stats->max_us)
+		stats->max_us = cgc->commit_us;
+	DPU_ATRACE_INT_PID("cgc_commit_us", cgc->commit_us, decon->thread->pid);
+	cgc->commit_us = 0;
 }
 
 static bool exynos_cgc_dma_update(struct exynos_dqe *dqe, struct exynos_dqe_state *state)
@@ -1054,20 +1456,35 @@ static bool exynos_cgc_dma_update(struct exynos_dqe *dqe, struct exynos_dqe_stat
 	struct drm_printer p = drm_info_printer(decon->dev);
 	u32 id = decon->id;
 	bool updated = false;
+	bool started;
 
 	if (!decon->cgc_dma || info->force_en)
 		return false;
 
-	if (dqe->state.cgc_gem != state->cgc_gem) {
-		exynos_set_cgc_dma(decon, state);
-		cgc->first_write = true;
-		updated = true;
-	} else if (cgc->first_write) {
-		exynos_set_cgc_dma(decon, state);
-		cgc->first_write = false;
+	/* DMA may already be running since commit begin */
+	started = cgc->dma_started && cgc->dma_gem == state->cgc_gem;
+	cgc->dma_started = false;
+	cgc->dma_gem = NULL;
+
+	if (started || exynos_cgc_dma_needed(dqe, state)) {
+		if (!started)
+			exynos_set_cgc_dma(dqe, state);
+
+		/* every new LUT is loaded twice, on this and the next update */
+		if (cgc->first_write && dqe->state.cgc_gem == state->cgc_gem)
+			cgc->first_write = false;
+		else
+			cgc->first_write = true;
+
+		dqe->state.cgc_gem = state->cgc_gem;
 		updated = true;
+	} else if (state->cgc_gem) {
+		dqe->cgc_cache.stats.dma_skip_cnt++;
 	}
 
+	if (updated && !started && state->cgc_gem)
+		cgc->stats.late_cnt++;
+
 	if (info->verbose)
 		dqe_reg_print_cgc_lut(id, cgc->verbose_cnt, &p);
 
@@ -1079,11 +1496,16 @@ static void __exynos_dqe_update(struct exynos_dqe *dqe,
 {
 	struct decon_device *decon = dqe->decon;
 	u32 id = decon->id;
+	unsigned long flags;
 	bool cgc_updated;
 
 	pr_debug("enabled(%d) +\n", state->enabled);
 
+	spin_lock_irqsave(&decon->slock, flags);
 	dqe->state.enabled = state->enabled && !dqe->force_disabled;
+	if (!dqe->state.enabled)
+		exynos_matrix_transition_cancel(&dqe->linear_tr);
+	spin_unlock_irqrestore(&decon->slock, flags);
 
 	decon_reg_set_dqe_enable(id, dqe->state.enabled);
 	if (!dqe->state.enabled)
@@ -1131,11 +1553,18 @@ void exynos_dqe_hibernation_enter(struct exynos_dqe *dqe)
 	enum exynos_histogram_id hist_id;
 	struct histogram_chan_state *hist_chan;
 	bool decon_idle;
+	struct matrix_transition *tr = &dqe->linear_tr;
 
 	if (!dqe->state.enabled)
 		return;
 
 	DPU_ATRACE_BEGIN(__func__);
+	if (tr->active && !tr->paused) {
+		tr->elapsed_us += ktime_us_delta(ktime_get(), tr->start_ts);
+		tr->paused = true;
+		tr->stats.pause_cnt++;
+	}
+
 	spin_lock_irqsave(&dqe->state.histogram_slock, flags);
 	decon_idle = decon_reg_is_idle(dqe->decon->id);
 
@@ -1180,11 +1609,21 @@ void exynos_dqe_reset(struct exynos_dqe *dqe)
 	dqe->state.disp_dither_config = NULL;
 	dqe->state.cgc_dither_config = NULL;
 	dqe->cgc.first_write = false;
+	dqe->cgc.dma_started = false;
+	dqe->cgc.dma_gem = NULL;
+	dqe->cgc.dma_pending = false;
+	dqe->cgc.commit_us = 0;
 	dqe->force_atc_config.dirty = true;
 	dqe->state.rcd_enabled = false;
 	dqe->state.cgc_gem = NULL;
 	dqe->lhbm_hist_configured = false;
 
+	/* a transition paused for hibernation is resumed on the next update */
+	if (!dqe->linear_tr.paused) {
+		exynos_matrix_transition_cancel(&dqe->linear_tr);
+		dqe->linear_tr.cur_valid = false;
+	}
+
 	/* reflect histogram state  */
 	spin_lock_irqsave(&dqe->state.histogram_slock, flags);
 	for (i = 0; i < HISTOGRAM_MAX; i++) {
@@ -1560,6 +1999,7 @@ struct exynos_dqe *exynos_dqe_register(struct decon_device *decon)
 	dqe->decon = decon;
 	spin_lock_init(&dqe->state.histogram_slock);
 	INIT_LIST_HEAD(&dqe->state.hist_pending_events_list);
+	mutex_init(&dqe->cgc_cache.lock);
 
 	scnprintf(dqe_name, MAX_DQE_NAME_SIZE, "dqe%u", decon->id);
 	dqe->dqe_class = class_create(THIS_MODULE, dqe_name);
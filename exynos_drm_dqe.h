@@ -13,6 +13,8 @@
 #ifndef __EXYNOS_DRM_DQE_H__
 #define __EXYNOS_DRM_DQE_H__
 
+#include <linux/ktime.h>
+#include <linux/mutex.h>
 #include <drm/samsung_drm.h>
 #include <dqe_cal.h>
 #include <cal_config.h>
@@ -60,6 +62,8 @@ struct exynos_dqe_state {
 	bool enabled;
 	bool rcd_enabled;
 	struct drm_gem_object *cgc_gem;
+	/* ramp linear matrix changes over this many ms instead of applying them at once */
+	u32 linear_matrix_ms;
 
 	/* histogram */
 	spinlock_t histogram_slock;
@@ -109,11 +113,66 @@ struct regamma_debug_override {
 	struct drm_color_lut force_lut[REGAMMA_LUT_SIZE];
 };
 
+/* commit thread time spent on CGC coefficient DMA */
+struct cgc_dma_stats {
+	u32 cnt;
+	u32 early_cnt;
+	u32 late_cnt;
+	u32 timeout_cnt;
+	u32 max_us;
+	u64 total_us;
+};
+
+#define CGC_CACHE_SLOT_CNT	4
+
+struct cgc_cache_slot {
+	struct drm_gem_object *gem;
+	const void *vaddr;
+	u64 hash;
+	u64 last_use;
+};
+
+struct cgc_cache_stats {
+	u32 buf_hit_cnt;
+	u32 miss_cnt;
+	u32 evict_cnt;
+	u32 dma_skip_cnt;
+	u32 hit_max_us;
+	u32 miss_max_us;
+	u64 hit_total_us;
+	u64 miss_total_us;
+};
+
+/*
+ * Recently used CGC LUT buffers, kept imported and mapped. Lookup is by
+ * dma-buf, the content hash only tells whether hw holds the current LUT of a
+ * buffer rewritten in place. Slots holding the LUT currently
+ * loaded in hw (active) and the last one handed out to a state (pending)
+ * are never evicted.
+ */
+struct cgc_cache {
+	struct mutex lock;
+	struct cgc_cache_slot slots[CGC_CACHE_SLOT_CNT];
+	u64 use_seq;
+	struct drm_gem_object *active;
+	u64 active_hash;
+	struct drm_gem_object *pending;
+	struct cgc_cache_stats stats;
+};
+
 struct cgc_debug_override {
 	bool first_write;
 	u32 verbose_cnt;
 	struct exynos_debug_info info;
 	struct cgc_lut force_lut;
+
+	/* DMA started from commit begin, for dma_gem */
+	bool dma_started;
+	struct drm_gem_object *dma_gem;
+	/* DMA started and not yet waited for */
+	bool dma_pending;
+	u32 commit_us;
+	struct cgc_dma_stats stats;
 };
 
 struct matrix_debug_override {
@@ -121,6 +180,33 @@ struct matrix_debug_override {
 	struct exynos_matrix force_matrix;
 };
 
+struct matrix_transition_stats {
+	u32 start_cnt;
+	u32 done_cnt;
+	u32 cancel_cnt;
+	u32 pause_cnt;
+	u32 step_cnt;
+};
+
+/*
+ * Linear matrix interpolated from @from to @to, stepped once per frame.
+ * @cur always holds the values last written to hw. Time spent in
+ * hibernation is not counted, the ramp resumes from @cur on exit.
+ */
+struct matrix_transition {
+	bool active;
+	bool paused;
+	bool cur_valid;
+	bool to_bypass;
+	struct exynos_matrix from;
+	struct exynos_matrix to;
+	struct exynos_matrix cur;
+	ktime_t start_ts;
+	u32 elapsed_us;
+	u32 duration_us;
+	struct matrix_transition_stats stats;
+};
+
 enum dump_type {
 	DUMP_TYPE_CGC_DIHTER	= 0,
 	DUMP_TYPE_DISP_DITHER,
@@ -179,8 +265,10 @@ struct exynos_dqe {
 	struct degamma_debug_override degamma;
 	struct regamma_debug_override regamma;
 	struct cgc_debug_override cgc;
+	struct cgc_cache cgc_cache;
 	struct matrix_debug_override gamma;
 	struct matrix_debug_override linear;
+	struct matrix_transition linear_tr;
 
 	bool verbose_hist;
 
@@ -209,7 +297,12 @@ void histogram_flip_done(struct exynos_dqe *dqe, const struct drm_crtc_state *ne
 void exynos_dqe_update(struct exynos_dqe *dqe, struct exynos_dqe_state *state,
 			u32 width, u32 height);
 void exynos_dqe_reset(struct exynos_dqe *dqe);
+void exynos_dqe_prepare_cgc(struct exynos_dqe *dqe, const struct exynos_dqe_state *state);
+void exynos_dqe_wait_cgc(struct exynos_dqe *dqe);
+struct drm_gem_object *exynos_dqe_cgc_gem_get(struct exynos_dqe *dqe, int fd);
+void exynos_dqe_cgc_cache_release(struct exynos_dqe *dqe);
 void exynos_dqe_hibernation_enter(struct exynos_dqe *dqe);
+bool exynos_dqe_matrix_transition_step(struct exynos_dqe *dqe);
 struct exynos_dqe *exynos_dqe_register(struct decon_device *decon);
 void exynos_dqe_save_lpd_data(struct exynos_dqe *dqe);
 void exynos_dqe_restore_lpd_data(struct exynos_dqe *dqe);
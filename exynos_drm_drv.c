@@ -52,8 +52,6 @@
 #define DRIVER_MAJOR	1
 #define DRIVER_MINOR	0
 
-#define EXYNOS_DRM_WAIT_FENCE_TIMEOUT_MS 250
-
 EXPORT_TRACEPOINT_SYMBOL(tracing_mark_write);
 EXPORT_TRACEPOINT_SYMBOL(dsi_label_scope);
 
@@ -438,22 +436,213 @@ static int exynos_add_relevant_connectors(struct drm_atomic_state *state)
 	return ret;
 }
 
-int exynos_atomic_check(struct drm_device *dev,
-			struct drm_atomic_state *state)
+static bool atomic_check_fast_path = true;
+module_param(atomic_check_fast_path, bool, 0664);
+MODULE_PARM_DESC(atomic_check_fast_path, "Enable/disable the atomic check fast path for buffer-only flips");
+
+static bool atomic_check_verify;
+module_param(atomic_check_verify, bool, 0664);
+MODULE_PARM_DESC(atomic_check_verify, "Run the full atomic check on buffer-only flips and compare with the fast path");
+
+static bool exynos_plane_is_buffer_flip(const struct drm_plane_state *old_state,
+					const struct drm_plane_state *new_state)
 {
-	const struct exynos_drm_private *private = drm_to_exynos_dev(dev);
-	int ret;
+	const struct exynos_drm_plane_state *old_exynos_state = to_exynos_plane_state(old_state);
+	const struct exynos_drm_plane_state *new_exynos_state = to_exynos_plane_state(new_state);
+	const struct drm_framebuffer *old_fb = old_state->fb;
+	const struct drm_framebuffer *new_fb = new_state->fb;
+
+	if (!old_fb || !new_fb || !new_state->crtc || old_state->crtc != new_state->crtc)
+		return false;
+
+	if (old_fb != new_fb &&
+	    (old_fb->format != new_fb->format || old_fb->modifier != new_fb->modifier ||
+	     old_fb->width != new_fb->width || old_fb->height != new_fb->height ||
+	     memcmp(old_fb->pitches, new_fb->pitches, sizeof(old_fb->pitches)) ||
+	     memcmp(old_fb->offsets, new_fb->offsets, sizeof(old_fb->offsets))))
+		return false;
+
+	return old_state->crtc_x == new_state->crtc_x &&
+	       old_state->crtc_y == new_state->crtc_y &&
+	       old_state->crtc_w == new_state->crtc_w &&
+	       old_state->crtc_h == new_state->crtc_h &&
+	       old_state->src_x == new_state->src_x &&
+	       old_state->src_y == new_state->src_y &&
+	       old_state->src_w == new_state->src_w &&
+	       old_state->src_h == new_state->src_h &&
+	       old_state->rotation == new_state->rotation &&
+	       old_state->zpos == new_state->zpos &&
+	       old_state->alpha == new_state->alpha &&
+	       old_state->pixel_blend_mode == new_state->pixel_blend_mode &&
+	       old_state->color_encoding == new_state->color_encoding &&
+	       old_state->color_range == new_state->color_range &&
+	       old_exynos_state->blobs == new_exynos_state->blobs &&
+	       old_exynos_state->standard == new_exynos_state->standard &&
+	       old_exynos_state->transfer == new_exynos_state->transfer &&
+	       old_exynos_state->range == new_exynos_state->range &&
+	       old_exynos_state->colormap == new_exynos_state->colormap &&
+	       old_exynos_state->max_luminance == new_exynos_state->max_luminance &&
+	       old_exynos_state->min_luminance == new_exynos_state->min_luminance;
+}
 
-	if (private->tui_enabled) {
-		pr_info("tui enabled reject commit(%pK)\n", state);
-		return -EPERM;
+static bool exynos_crtc_is_buffer_flip(const struct drm_crtc_state *old_state,
+				       const struct drm_crtc_state *new_state)
+{
+	const struct exynos_drm_crtc_state *old_exynos_state = to_exynos_crtc_state(old_state);
+	const struct exynos_drm_crtc_state *new_exynos_state = to_exynos_crtc_state(new_state);
+	const struct decon_device *decon = crtc_to_decon(new_state->crtc);
+	struct drm_rect full;
+
+	/* hibernation exit and self refresh transitions reprogram the whole pipeline */
+	if (!old_state->active || !new_state->active ||
+	    old_state->self_refresh_active || new_state->self_refresh_active ||
+	    old_exynos_state->hibernation_exit || new_exynos_state->hibernation_exit ||
+	    new_exynos_state->bypass)
+		return false;
+
+	if (drm_atomic_crtc_needs_modeset(new_state) || new_state->color_mgmt_changed ||
+	    old_state->mode_blob != new_state->mode_blob ||
+	    old_state->plane_mask != new_state->plane_mask ||
+	    old_state->connector_mask != new_state->connector_mask ||
+	    old_state->encoder_mask != new_state->encoder_mask)
+		return false;
+
+	if (old_exynos_state->blobs != new_exynos_state->blobs ||
+	    old_exynos_state->partial != new_exynos_state->partial ||
+	    old_exynos_state->color_mode != new_exynos_state->color_mode ||
+	    old_exynos_state->force_bpc != new_exynos_state->force_bpc ||
+	    old_exynos_state->dqe.enabled != new_exynos_state->dqe.enabled)
+		return false;
+
+	/* partial update prepares plane coordinates unless the region is full */
+	if (decon->partial) {
+		exynos_partial_set_full(&new_state->mode, &full);
+		if (!drm_rect_equals(&full, &new_exynos_state->partial_region))
+			return false;
 	}
 
-	exynos_check_updated_planes(dev, state);
+	return true;
+}
 
-	ret = exynos_add_relevant_connectors(state);
-	if (ret)
-		return ret;
+/*
+ * A commit which only replaces framebuffers with ones of the same layout on
+ * planes which keep their geometry, zpos and properties. Window reservation,
+ * zpos normalization, clipping and DPP restriction checks would produce the
+ * same results as for the last commit, which the new states inherited.
+ */
+static bool exynos_atomic_is_buffer_flip(struct drm_atomic_state *state)
+{
+	struct drm_connector *conn;
+	struct drm_connector_state *new_conn_state;
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *old_crtc_state, *new_crtc_state;
+	struct drm_plane *plane;
+	struct drm_plane_state *old_plane_state, *new_plane_state;
+	int i;
+
+	if (state->num_private_objs)
+		return false;
+
+	/* connectors are added when properties changed or panels need a commit */
+	for_each_new_connector_in_state(state, conn, new_conn_state, i)
+		return false;
+
+	for_each_oldnew_crtc_in_state(state, crtc, old_crtc_state, new_crtc_state, i)
+		if (!exynos_crtc_is_buffer_flip(old_crtc_state, new_crtc_state))
+			return false;
+
+	for_each_oldnew_plane_in_state(state, plane, old_plane_state, new_plane_state, i) {
+		if (!exynos_plane_is_buffer_flip(old_plane_state, new_plane_state))
+			return false;
+
+		/* the crtc must be part of the commit so that its checks still run */
+		if (!drm_atomic_get_new_crtc_state(state, new_plane_state->crtc))
+			return false;
+	}
+
+	return true;
+}
+
+static int exynos_atomic_check_fast(struct drm_atomic_state *state)
+{
+	const struct drm_crtc_helper_funcs *funcs;
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *new_crtc_state;
+	int i, ret;
+
+	for_each_new_crtc_in_state(state, crtc, new_crtc_state, i) {
+		to_exynos_crtc_state(new_crtc_state)->needs_reconfigure = false;
+
+		/* crtc checks decide skip update, bpc and duplicate frames per commit */
+		funcs = crtc->helper_private;
+		if (!funcs || !funcs->atomic_check)
+			continue;
+
+		ret = funcs->atomic_check(crtc, state);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
+/* compare the results of the full check with what the fast path inherited */
+static void exynos_atomic_check_verify(struct exynos_drm_private *private,
+				       struct drm_atomic_state *state, int ret)
+{
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *old_crtc_state, *new_crtc_state;
+	struct drm_plane *plane;
+	struct drm_plane_state *old_plane_state, *new_plane_state;
+	bool mismatch = ret != 0;
+	int i;
+
+	for_each_oldnew_crtc_in_state(state, crtc, old_crtc_state, new_crtc_state, i) {
+		const struct exynos_drm_crtc_state *old_exynos_state =
+			to_exynos_crtc_state(old_crtc_state);
+		const struct exynos_drm_crtc_state *new_exynos_state =
+			to_exynos_crtc_state(new_crtc_state);
+
+		mismatch |= old_exynos_state->reserved_win_mask !=
+				new_exynos_state->reserved_win_mask ||
+			    old_exynos_state->visible_win_mask !=
+				new_exynos_state->visible_win_mask ||
+			    old_crtc_state->plane_mask != new_crtc_state->plane_mask ||
+			    new_exynos_state->needs_reconfigure;
+	}
+
+	for_each_oldnew_plane_in_state(state, plane, old_plane_state, new_plane_state, i) {
+		mismatch |= old_plane_state->visible != new_plane_state->visible ||
+			    old_plane_state->normalized_zpos != new_plane_state->normalized_zpos ||
+			    !drm_rect_equals(&old_plane_state->src, &new_plane_state->src) ||
+			    !drm_rect_equals(&old_plane_state->dst, &new_plane_state->dst);
+	}
+
+	if (mismatch) {
+		atomic_inc(&private->check_stats.verify_mismatch);
+		WARN_ONCE(1, "atomic check fast path mismatch (ret=%d)\n", ret);
+	}
+}
+
+static void exynos_atomic_check_account(struct exynos_drm_private *private,
+					bool fast, ktime_t start)
+{
+	struct exynos_atomic_check_path_stats *stats = fast ?
+		&private->check_stats.fast : &private->check_stats.full;
+	const int us = ktime_us_delta(ktime_get(), start);
+	int max_us = atomic_read(&stats->max_us);
+
+	atomic_inc(&stats->cnt);
+	atomic64_add(us, &stats->total_us);
+	while (us > max_us && !atomic_try_cmpxchg(&stats->max_us, &max_us, us))
+		;
+	DPU_ATRACE_INT(fast ? "atomic_check_fast_us" : "atomic_check_us", us);
+}
+
+static int exynos_atomic_check_full(struct drm_device *dev,
+				    struct drm_atomic_state *state)
+{
+	int ret;
 
 	ret = drm_atomic_helper_check_modeset(dev, state);
 	if (ret)
@@ -469,12 +658,44 @@ int exynos_atomic_check(struct drm_device *dev,
 	if (ret)
 		return ret;
 
-	ret = exynos_atomic_check_windows(dev, state);
+	return exynos_atomic_check_windows(dev, state);
+}
+
+int exynos_atomic_check(struct drm_device *dev,
+			struct drm_atomic_state *state)
+{
+	struct exynos_drm_private *private = drm_to_exynos_dev(dev);
+	const ktime_t start = ktime_get();
+	bool fast;
+	int ret;
+
+	if (private->tui_enabled) {
+		pr_info("tui enabled reject commit(%pK)\n", state);
+		return -EPERM;
+	}
+
+	exynos_check_updated_planes(dev, state);
+
+	/* panels may request a commit at any time, so this one always runs */
+	ret = exynos_add_relevant_connectors(state);
+	if (ret)
+		return ret;
+
+	fast = atomic_check_fast_path && exynos_atomic_is_buffer_flip(state);
+	if (fast && !atomic_check_verify) {
+		ret = exynos_atomic_check_fast(state);
+	} else {
+		ret = exynos_atomic_check_full(dev, state);
+		if (fast)
+			exynos_atomic_check_verify(private, state, ret);
+	}
 	if (ret)
 		return ret;
 
 	drm_self_refresh_helper_alter_state(state);
 
+	exynos_atomic_check_account(private, fast && !atomic_check_verify, start);
+
 	return 0;
 }
 
@@ -516,15 +737,134 @@ static void print_drm_plane_state_info(struct drm_printer *p,
 	drm_printf(p, "plane: fb allocated by = %s\n", state->fb->comm);
 }
 
-static int exynos_atomic_helper_wait_for_fences(struct drm_device *dev,
-				      struct drm_atomic_state *state,
-				      bool pre_swap)
+static void exynos_fence_join_signaled(struct exynos_fence_join *join,
+				       struct exynos_fence_join_cb *jcb)
+{
+	if (jcb) {
+		/* written before the count drops, the waiter logs it once it hits zero */
+		WRITE_ONCE(join->last, jcb);
+		WRITE_ONCE(jcb->signaled, true);
+	}
+
+	if (atomic_dec_and_test(&join->pending) || (join->wake_each && jcb))
+		wake_up(&join->wait);
+}
+
+static void exynos_fence_join_cb_func(struct dma_fence *fence, struct dma_fence_cb *cb)
+{
+	struct exynos_fence_join_cb *jcb = container_of(cb, struct exynos_fence_join_cb, cb);
+
+	exynos_fence_join_signaled(jcb->join, jcb);
+}
+
+static void exynos_atomic_fence_timeout(struct drm_device *dev, struct drm_atomic_state *state,
+					struct drm_plane_state *new_plane_state)
+{
+	struct drm_plane *plane = new_plane_state->plane;
+	struct drm_crtc *crtc = new_plane_state->crtc;
+	struct dma_fence *fence = new_plane_state->fence;
+	struct drm_printer p = drm_info_printer(dev->dev);
+
+	pr_err("%s: timeout of waiting for fence, name:%s idx:%d\n",
+		__func__, plane->name ? : "NA", plane->index);
+	if (crtc) {
+		const struct decon_device *decon = crtc_to_decon(crtc);
+		const struct decon_config *cfg = &decon->config;
+		struct exynos_drm_crtc_state *new_exynos_crtc_state;
+		struct drm_crtc_state *new_crtc_state;
+
+		new_crtc_state = drm_atomic_get_new_crtc_state(state, crtc);
+		if (!new_crtc_state ||
+			!new_crtc_state->enable || !new_crtc_state->active)
+			return;
+		new_exynos_crtc_state = to_exynos_crtc_state(new_crtc_state);
+		if (!new_exynos_crtc_state->skip_update &&
+			   cfg->mode.op_mode != DECON_VIDEO_MODE) {
+			new_exynos_crtc_state->skip_update = true;
+			pr_warn("%s: skip frame update at %s\n",
+							__func__, crtc->name);
+		}
+	}
+	print_drm_plane_state_info(&p, new_plane_state);
+
+	spin_lock_irq(fence->lock);
+	drm_printf(&p, "fence: %s-%s %llu-%llu status:%s\n",
+		fence->ops ? fence->ops->get_driver_name(fence) : "none",
+		fence->ops ? fence->ops->get_timeline_name(fence) : "none",
+		fence->context, fence->seqno,
+		dma_fence_get_status_locked(fence) < 0 ? "error" : "active");
+	if (test_bit(DMA_FENCE_FLAG_TIMESTAMP_BIT, &fence->flags)) {
+		struct timespec64 ts64 = ktime_to_timespec64(fence->timestamp);
+		drm_printf(&p, "fence: timestamp:%lld.%09ld\n",
+			(s64)ts64.tv_sec, ts64.tv_nsec);
+	}
+	if (fence->error)
+		drm_printf(&p, "fence: err=%d\n", fence->error);
+	spin_unlock_irq(fence->lock);
+}
+
+static void exynos_fence_join_log(struct drm_atomic_state *state,
+				  const struct exynos_fence_join *join, ktime_t start, int err)
+{
+	struct dpu_log_fence_join log = { 0 };
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *new_crtc_state;
+	int i;
+
+	log.wait_us = ktime_us_delta(ktime_get(), start);
+	log.num_fences = join->num_fences;
+	log.timeout = err == -ETIMEDOUT;
+	if (join->last) {
+		const struct dma_fence *fence = join->last->plane_state->fence;
+
+		log.plane_idx = join->last->plane_state->plane->index;
+		log.context = fence->context;
+		log.seqno = fence->seqno;
+	} else {
+		log.plane_idx = -1;
+	}
+
+	for_each_new_crtc_in_state(state, crtc, new_crtc_state, i) {
+		if (new_crtc_state->plane_mask)
+			DPU_EVENT_LOG(DPU_EVT_FENCE_JOIN, crtc_to_decon(crtc)->id, &log);
+	}
+}
+
+/**
+ * exynos_fence_join_arm - register a callback on every plane fence of the commit
+ * @state: atomic state
+ * @join: join to initialize
+ * @wake_each: wake the waiter on every signaled fence instead of only the last
+ *
+ * Returns the number of fences to wait for, or a negative error code.
+ */
+int exynos_fence_join_arm(struct drm_atomic_state *state, struct exynos_fence_join *join,
+			  bool wake_each)
 {
 	struct drm_plane *plane;
 	struct drm_plane_state *new_plane_state;
-	int i, ret, err = 0;
-	struct drm_printer p = drm_info_printer(dev->dev);
-	long tmo = msecs_to_jiffies(EXYNOS_DRM_WAIT_FENCE_TIMEOUT_MS);
+	struct exynos_fence_join_cb *jcb;
+	int i, n = 0;
+
+	memset(join, 0, sizeof(*join));
+	join->start = ktime_get();
+	join->wake_each = wake_each;
+
+	for_each_new_plane_in_state(state, plane, new_plane_state, i) {
+		if (new_plane_state->fence)
+			n++;
+	}
+
+	if (!n)
+		return 0;
+
+	join->cbs = kcalloc(n, sizeof(*join->cbs), GFP_KERNEL);
+	if (!join->cbs)
+		return -ENOMEM;
+
+	/* hold one reference so that the join can't complete while arming */
+	atomic_set(&join->pending, 1);
+	init_waitqueue_head(&join->wait);
 
 	for_each_new_plane_in_state(state, plane, new_plane_state, i) {
 		struct dma_fence *fence = new_plane_state->fence;
@@ -533,61 +873,143 @@ static int exynos_atomic_helper_wait_for_fences(struct drm_device *dev,
 			continue;
 
 		WARN_ON(!new_plane_state->fb);
-		ret = dma_fence_wait_timeout(fence, pre_swap, tmo);
-		if (ret == 0) {
-			struct drm_crtc *crtc = new_plane_state->crtc;
-
-			pr_err("%s: timeout of waiting for fence, name:%s idx:%d\n",
-				__func__, plane->name ? : "NA", plane->index);
-			if (crtc) {
-				const struct decon_device *decon = crtc_to_decon(crtc);
-				const struct decon_config *cfg = &decon->config;
-				struct exynos_drm_crtc_state *new_exynos_crtc_state;
-				struct drm_crtc_state *new_crtc_state;
-
-				new_crtc_state = drm_atomic_get_new_crtc_state(state, crtc);
-				if (!new_crtc_state ||
-					!new_crtc_state->enable || !new_crtc_state->active)
-					continue;
-				new_exynos_crtc_state = to_exynos_crtc_state(new_crtc_state);
-				if (!new_exynos_crtc_state->skip_update &&
-					   cfg->mode.op_mode != DECON_VIDEO_MODE) {
-					new_exynos_crtc_state->skip_update = true;
-					pr_warn("%s: skip frame update at %s\n",
-									__func__, crtc->name);
-				}
-			}
-			print_drm_plane_state_info(&p, new_plane_state);
-
-			spin_lock_irq(fence->lock);
-			drm_printf(&p, "fence: %s-%s %llu-%llu status:%s\n",
-				fence->ops ? fence->ops->get_driver_name(fence) : "none",
-				fence->ops ? fence->ops->get_timeline_name(fence) : "none",
-				fence->context, fence->seqno,
-				dma_fence_get_status_locked(fence) < 0 ? "error" : "active");
-			if (test_bit(DMA_FENCE_FLAG_TIMESTAMP_BIT, &fence->flags)) {
-				struct timespec64 ts64 = ktime_to_timespec64(fence->timestamp);
-				drm_printf(&p, "fence: timestamp:%lld.%09ld\n",
-					(s64)ts64.tv_sec, ts64.tv_nsec);
-			}
-			if (fence->error)
-				drm_printf(&p, "fence: err=%d\n", fence->error);
-			spin_unlock_irq(fence->lock);
+		jcb = &join->cbs[join->num_fences++];
+		jcb->join = join;
+		jcb->plane_state = new_plane_state;
+
+		atomic_inc(&join->pending);
+		if (dma_fence_add_callback(fence, &jcb->cb, exynos_fence_join_cb_func))
+			exynos_fence_join_signaled(join, jcb);
+	}
+
+	exynos_fence_join_signaled(join, NULL);
 
-			tmo = 0;
+	return join->num_fences;
+}
+
+/**
+ * exynos_fence_join_finish - tear down a join after waiting on it
+ * @dev: DRM device
+ * @state: atomic state
+ * @join: armed join
+ * @ret: result of the wait, negative if it was interrupted
+ *
+ * Unsignaled fences are reported as timed out, then the plane fences are
+ * released. Returns 0 if all fences signaled.
+ */
+int exynos_fence_join_finish(struct drm_device *dev, struct drm_atomic_state *state,
+			     struct exynos_fence_join *join, long ret)
+{
+	struct drm_plane_state *new_plane_state;
+	struct exynos_fence_join_cb *jcb;
+	struct dma_fence *fence;
+	unsigned long flags;
+	int i, err = 0;
+
+	for (i = 0; i < join->num_fences; i++) {
+		jcb = &join->cbs[i];
+		new_plane_state = jcb->plane_state;
+		fence = new_plane_state->fence;
+
+		if (!READ_ONCE(jcb->signaled) &&
+		    dma_fence_remove_callback(fence, &jcb->cb)) {
+			if (ret < 0) {
+				err = ret;
+				continue;
+			}
+			exynos_atomic_fence_timeout(dev, state, new_plane_state);
 			err = -ETIMEDOUT;
-		} else if (ret < 0) {
-			pr_warn("%s: error of waiting for dma fence, ret=%d\n", __func__, ret);
-			print_drm_plane_state_info(&p, new_plane_state);
-			return ret;
+			continue;
 		}
-		dma_fence_put(fence);
+
+		/*
+		 * A signaled callback may still be waking the waiter on the join.
+		 * Callbacks run under the fence lock, so once the lock was taken
+		 * nothing touches the join anymore and it can be torn down.
+		 */
+		spin_lock_irqsave(fence->lock, flags);
+		spin_unlock_irqrestore(fence->lock, flags);
+	}
+
+	if (ret < 0) {
+		pr_warn("%s: error of waiting for dma fence, ret=%ld\n", __func__, ret);
+		kfree(join->cbs);
+		join->cbs = NULL;
+		return ret;
+	}
+
+	exynos_fence_join_log(state, join, join->start, err);
+
+	for (i = 0; i < join->num_fences; i++) {
+		new_plane_state = join->cbs[i].plane_state;
+		dma_fence_put(new_plane_state->fence);
 		new_plane_state->fence = NULL;
 	}
+	kfree(join->cbs);
+	join->cbs = NULL;
 
 	return err;
 }
 
+static int exynos_atomic_helper_wait_for_fences(struct drm_device *dev,
+				      struct drm_atomic_state *state,
+				      bool pre_swap)
+{
+	struct exynos_fence_join join;
+	long tmo = msecs_to_jiffies(EXYNOS_DRM_WAIT_FENCE_TIMEOUT_MS);
+	long ret;
+	int n;
+
+	n = exynos_fence_join_arm(state, &join, false);
+	if (n < 0)
+		return drm_atomic_helper_wait_for_fences(dev, state, pre_swap);
+	if (!n)
+		return 0;
+
+	if (pre_swap)
+		ret = wait_event_interruptible_timeout(join.wait,
+				!atomic_read(&join.pending), tmo);
+	else
+		ret = wait_event_timeout(join.wait, !atomic_read(&join.pending), tmo);
+
+	return exynos_fence_join_finish(dev, state, &join, ret);
+}
+
+/*
+ * Late latch is only used when every crtc of the commit opted in and drives a
+ * command mode panel without a modeset, there the frame trigger is the deadline.
+ */
+static bool exynos_atomic_can_late_latch(struct drm_atomic_state *state)
+{
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *new_crtc_state;
+	int i;
+
+	for_each_new_crtc_in_state(state, crtc, new_crtc_state, i) {
+		const struct decon_device *decon = crtc_to_decon(crtc);
+
+		if (!decon->late_latch.enabled ||
+		    decon->config.mode.op_mode != DECON_COMMAND_MODE ||
+		    !new_crtc_state->active ||
+		    drm_atomic_crtc_needs_modeset(new_crtc_state) ||
+		    to_exynos_crtc_state(new_crtc_state)->wb_type != EXYNOS_WB_NONE)
+			return false;
+	}
+
+	return true;
+}
+
+void exynos_atomic_frame_stamp(struct drm_atomic_state *state,
+			       enum exynos_frame_stage stage, ktime_t ts)
+{
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *new_crtc_state;
+	int i;
+
+	for_each_new_crtc_in_state(state, crtc, new_crtc_state, i)
+		to_exynos_crtc_state(new_crtc_state)->frame_ts[stage] = ts;
+}
+
 static void commit_tail(struct drm_atomic_state *old_state)
 {
 	int i;
@@ -597,7 +1019,10 @@ static void commit_tail(struct drm_atomic_state *old_state)
 	struct drm_crtc_state *old_crtc_state, *new_crtc_state;
 	struct drm_device *dev = old_state->dev;
 	unsigned int hibernation_crtc_mask = 0;
+	struct exynos_fence_join join;
+	bool late_latch = false;
 
+	exynos_atomic_frame_stamp(old_state, EXYNOS_FRAME_TAIL, ktime_get());
 	funcs = dev->mode_config.helper_private;
 
 	for_each_oldnew_crtc_in_state(old_state, crtc, old_crtc_state,
@@ -610,9 +1035,22 @@ static void commit_tail(struct drm_atomic_state *old_state)
 		}
 	}
 
-	DPU_ATRACE_BEGIN("wait_for_fences");
-	exynos_atomic_helper_wait_for_fences(dev, old_state, false);
-	DPU_ATRACE_END("wait_for_fences");
+	if (exynos_atomic_can_late_latch(old_state) &&
+	    exynos_fence_join_arm(old_state, &join, true) > 0) {
+		/* fences are waited on while programming planes in commit tail */
+		for_each_new_crtc_in_state(old_state, crtc, new_crtc_state, i) {
+			to_exynos_crtc_state(new_crtc_state)->fence_join = &join;
+			crtc_to_decon(crtc)->late_latch.commit_cnt++;
+		}
+		late_latch = true;
+	}
+
+	if (!late_latch) {
+		DPU_ATRACE_BEGIN("wait_for_fences");
+		exynos_atomic_helper_wait_for_fences(dev, old_state, false);
+		DPU_ATRACE_END("wait_for_fences");
+		exynos_atomic_frame_stamp(old_state, EXYNOS_FRAME_FENCE, ktime_get());
+	}
 
 	drm_atomic_helper_wait_for_dependencies(old_state);
 
@@ -621,6 +1059,17 @@ static void commit_tail(struct drm_atomic_state *old_state)
 	else
 		drm_atomic_helper_commit_tail(old_state);
 
+	if (late_latch) {
+		/*
+		 * The join lives on this stack: unpublish it and, if no plane
+		 * commit consumed it, tear it down before it goes out of scope.
+		 */
+		for_each_new_crtc_in_state(old_state, crtc, new_crtc_state, i)
+			to_exynos_crtc_state(new_crtc_state)->fence_join = NULL;
+		if (join.cbs)
+			exynos_fence_join_finish(dev, old_state, &join, 0);
+	}
+
 	for_each_new_crtc_in_state(old_state, crtc, new_crtc_state, i) {
 		decon = crtc_to_decon(crtc);
 		if (hibernation_crtc_mask & drm_crtc_mask(crtc))
@@ -690,6 +1139,8 @@ int exynos_atomic_commit(struct drm_device *dev, struct drm_atomic_state *state,
 	bool stall = !nonblock;
 
 	DPU_ATRACE_BEGIN("exynos_atomic_commit");
+	atomic_inc(&drm_to_exynos_dev(dev)->commit_cnt);
+	exynos_atomic_frame_stamp(state, EXYNOS_FRAME_COMMIT, ktime_get());
 
 	/*
 	 * if self refresh was activated on last commit or coming out of self refresh/hibernation,
@@ -771,6 +1222,43 @@ static ssize_t tui_status_show(struct device *dev,
 }
 static DEVICE_ATTR_RO(tui_status);
 
+static ssize_t state_alloc_stats_show(struct device *dev,
+				      struct device_attribute *attr, char *buf)
+{
+	struct drm_device *drm_dev = dev_get_drvdata(dev);
+	const struct exynos_drm_private *private = drm_to_exynos_dev(drm_dev);
+	const u32 commits = atomic_read(&private->commit_cnt);
+	const u32 allocs = atomic_read(&private->state_alloc_cnt);
+	const u32 refs = atomic_read(&private->state_ref_cnt);
+	const u32 allocs_x100 = commits ? div_u64((u64)allocs * 100, commits) : 0;
+	const u32 refs_x100 = commits ? div_u64((u64)refs * 100, commits) : 0;
+
+	return scnprintf(buf, PAGE_SIZE,
+			 "commits: %u\nallocs: %u (%u.%02u per commit)\nrefs: %u (%u.%02u per commit)\n",
+			 commits, allocs, allocs_x100 / 100, allocs_x100 % 100,
+			 refs, refs_x100 / 100, refs_x100 % 100);
+}
+static DEVICE_ATTR_RO(state_alloc_stats);
+
+static ssize_t atomic_check_stats_show(struct device *dev,
+				       struct device_attribute *attr, char *buf)
+{
+	struct drm_device *drm_dev = dev_get_drvdata(dev);
+	const struct exynos_drm_private *private = drm_to_exynos_dev(drm_dev);
+	const struct exynos_atomic_check_stats *stats = &private->check_stats;
+	const u32 fast_cnt = atomic_read(&stats->fast.cnt);
+	const u32 full_cnt = atomic_read(&stats->full.cnt);
+	const u32 fast_avg = fast_cnt ? div_u64(atomic64_read(&stats->fast.total_us), fast_cnt) : 0;
+	const u32 full_avg = full_cnt ? div_u64(atomic64_read(&stats->full.total_us), full_cnt) : 0;
+
+	return scnprintf(buf, PAGE_SIZE,
+			 "fast: %u (avg %uus max %uus)\nfull: %u (avg %uus max %uus)\nverify_mismatch: %u\n",
+			 fast_cnt, fast_avg, atomic_read(&stats->fast.max_us),
+			 full_cnt, full_avg, atomic_read(&stats->full.max_us),
+			 atomic_read(&stats->verify_mismatch));
+}
+static DEVICE_ATTR_RO(atomic_check_stats);
+
 int exynos_atomic_enter_tui(void)
 {
 	int i, ret = 0;
@@ -991,6 +1479,7 @@ static int exynos_drm_open(struct drm_device *dev, struct drm_file *file)
 
 static void exynos_drm_postclose(struct drm_device *dev, struct drm_file *file)
 {
+	exynos_drm_wb_stream_release(dev, file);
 	kfree(file->driver_priv);
 	file->driver_priv = NULL;
 }
@@ -1003,6 +1492,9 @@ static const struct drm_ioctl_desc exynos_ioctls[] = {
 	DRM_IOCTL_DEF_DRV(EXYNOS_HISTOGRAM_CHANNEL_CANCEL, histogram_channel_cancel_ioctl, 0),
 	DRM_IOCTL_DEF_DRV(EXYNOS_CONTEXT_HISTOGRAM_EVENT_REQUEST, histogram_event_request_ioctl, 0),
 	DRM_IOCTL_DEF_DRV(EXYNOS_CONTEXT_HISTOGRAM_EVENT_CANCEL, histogram_event_cancel_ioctl, 0),
+	DRM_IOCTL_DEF_DRV(EXYNOS_WB_STREAM_START, wb_stream_start_ioctl, DRM_MASTER),
+	DRM_IOCTL_DEF_DRV(EXYNOS_WB_STREAM_STOP, wb_stream_stop_ioctl, DRM_MASTER),
+	DRM_IOCTL_DEF_DRV(EXYNOS_WB_STREAM_QUEUE, wb_stream_queue_ioctl, DRM_MASTER),
 };
 
 static const struct file_operations exynos_drm_driver_fops = {
@@ -1216,6 +1708,8 @@ static int exynos_drm_bind(struct device *dev)
 
 	/* create sysfs node for TUI status */
 	device_create_file(dev, &dev_attr_tui_status);
+	device_create_file(dev, &dev_attr_state_alloc_stats);
+	device_create_file(dev, &dev_attr_atomic_check_stats);
 
 	return 0;
 
@@ -1236,6 +1730,8 @@ static void exynos_drm_unbind(struct device *dev)
 
 	/* destroy sysfs node for TUI status */
 	device_remove_file(dev, &dev_attr_tui_status);
+	device_remove_file(dev, &dev_attr_state_alloc_stats);
+	device_remove_file(dev, &dev_attr_atomic_check_stats);
 
 	drm_dev_unregister(drm);
 
@@ -1374,10 +1870,18 @@ static int exynos_drm_init(void)
 {
 	int ret;
 
-	ret = exynos_drm_register_devices();
+	ret = exynos_drm_crtc_init_caches();
 	if (ret)
 		return ret;
 
+	ret = exynos_drm_plane_init_caches();
+	if (ret)
+		goto err_destroy_crtc_caches;
+
+	ret = exynos_drm_register_devices();
+	if (ret)
+		goto err_destroy_plane_caches;
+
 	ret = exynos_drm_register_drivers();
 	if (ret)
 		goto err_unregister_pdevs;
@@ -1386,6 +1890,10 @@ static int exynos_drm_init(void)
 
 err_unregister_pdevs:
 	exynos_drm_unregister_devices();
+err_destroy_plane_caches:
+	exynos_drm_plane_destroy_caches();
+err_destroy_crtc_caches:
+	exynos_drm_crtc_destroy_caches();
 
 	return ret;
 }
@@ -1394,6 +1902,8 @@ static void exynos_drm_exit(void)
 {
 	exynos_drm_unregister_drivers();
 	exynos_drm_unregister_devices();
+	exynos_drm_plane_destroy_caches();
+	exynos_drm_crtc_destroy_caches();
 }
 
 module_init(exynos_drm_init);
@@ -23,6 +23,7 @@
 #include <drm/drm_property.h>
 #include <drm/drm_file.h>
 #include <drm/samsung_drm.h>
+#include <linux/kref.h>
 #include <linux/kthread.h>
 #include <linux/module.h>
 
@@ -39,6 +40,7 @@
 #define DEFAULT_WIN	0
 
 #define LINEAR_MATRIX_OVERRIDE_SCALE_FACTOR  0x1fff
+#define LINEAR_MATRIX_TRANSITION_MAX_MS	10000
 
 
 #define to_exynos_crtc(x)	container_of(x, struct exynos_drm_crtc, base)
@@ -83,6 +85,18 @@ enum exynos_drm_writeback_type {
 	EXYNOS_WB_SWB,
 };
 
+/* stages of a frame from atomic commit to the end of the panel transfer */
+enum exynos_frame_stage {
+	EXYNOS_FRAME_COMMIT,	/* atomic commit entry */
+	EXYNOS_FRAME_TAIL,	/* commit tail start */
+	EXYNOS_FRAME_FENCE,	/* all plane fences signaled */
+	EXYNOS_FRAME_EPT,	/* earliest process time reached */
+	EXYNOS_FRAME_TRIGGER,	/* shadow update requested and decon started */
+	EXYNOS_FRAME_START,	/* frame start, shadow registers latched */
+	EXYNOS_FRAME_DONE,	/* frame done, output transfer finished */
+	EXYNOS_FRAME_STAGE_CNT,
+};
+
 struct exynos_drm_rect {
 	unsigned int x, y;
 	unsigned int w, h;
@@ -120,6 +134,19 @@ struct exynos_hdr_state {
  * specific overlay info.
  */
 
+/*
+ * Property blobs of a plane state. Duplicated plane states share them through
+ * a single reference and copy them on the first write.
+ */
+struct exynos_plane_blobs {
+	struct kref ref;
+	struct drm_property_blob *eotf_lut;
+	struct drm_property_blob *oetf_lut;
+	struct drm_property_blob *gm;
+	struct drm_property_blob *tm;
+	struct drm_property_blob *block;
+};
+
 struct exynos_drm_plane_state {
 	struct drm_plane_state base;
 	struct drm_framebuffer *old_fb;
@@ -131,11 +158,7 @@ struct exynos_drm_plane_state {
 	uint32_t range;
 	uint32_t colormap;
 	struct exynos_hdr_state hdr_state;
-	struct drm_property_blob *eotf_lut;
-	struct drm_property_blob *oetf_lut;
-	struct drm_property_blob *gm;
-	struct drm_property_blob *tm;
-	struct drm_property_blob *block;
+	struct exynos_plane_blobs *blobs;
 };
 
 static inline struct exynos_drm_plane_state *
@@ -247,13 +270,13 @@ struct exynos_drm_crtc_ops {
 			const struct drm_crtc_state *new_crtc_state);
 };
 
-struct exynos_drm_crtc_state {
-	struct drm_crtc_state base;
-	uint32_t color_mode;
-	uint32_t in_bpc;
-	uint32_t force_bpc; /* crtc(DECON) bpc mode */
-	uint64_t expected_present_time;
-	struct exynos_dqe_state dqe;
+/*
+ * DQE property blobs and the CGC LUT buffer of a crtc state. Duplicated crtc
+ * states share them through a single reference and copy them on the first
+ * write.
+ */
+struct exynos_crtc_blobs {
+	struct kref ref;
 	struct drm_property_blob *cgc_lut;
 	struct drm_property_blob *disp_dither;
 	struct drm_property_blob *cgc_dither;
@@ -267,6 +290,16 @@ struct exynos_drm_crtc_state {
 	struct drm_property_blob *histogram[HISTOGRAM_MAX];
 
 	struct drm_gem_object *cgc_gem;
+};
+
+struct exynos_drm_crtc_state {
+	struct drm_crtc_state base;
+	uint32_t color_mode;
+	uint32_t in_bpc;
+	uint32_t force_bpc; /* crtc(DECON) bpc mode */
+	uint64_t expected_present_time;
+	struct exynos_dqe_state dqe;
+	struct exynos_crtc_blobs *blobs;
 	enum exynos_drm_writeback_type wb_type;
 	u8 seamless_mode_changed : 1;
 	/**
@@ -294,12 +327,48 @@ struct exynos_drm_crtc_state {
 	 */
 	u8 hibernation_exit : 1;
 
+	/**
+	 * @dup_frame: set along with @skip_update when the frame was detected as
+	 *	       a duplicate of the previous (CRC verified) frame
+	 */
+	u8 dup_frame : 1;
+
+	/**
+	 * @frame_seq: content sequence number, kept from the previous state if
+	 *             nothing affecting the frame content changed
+	 */
+	u64 frame_seq;
+
+	/**
+	 * @fence_join: plane fences still pending when the commit is late-latched,
+	 *		DPP windows are programmed as each of them signals
+	 */
+	struct exynos_fence_join *fence_join;
+
+	/**
+	 * @frame_ts: timestamps of the stages this frame went through on the
+	 *	      commit side, indexed by enum exynos_frame_stage
+	 */
+	ktime_t frame_ts[EXYNOS_FRAME_STAGE_CNT];
+
 	unsigned int reserved_win_mask;
 	unsigned int visible_win_mask;
 	struct drm_rect partial_region;
 	struct drm_property_blob *partial;
 	bool needs_reconfigure;
 
+	/**
+	 * @partial_expanded: times the partial update check grew @partial_region
+	 *		      to include an unsupported plane
+	 */
+	u8 partial_expanded;
+
+	/**
+	 * @partial_fallback: enum exynos_partial_fallback reason of the plane
+	 *		      that forced a full update in the partial update check
+	 */
+	s8 partial_fallback;
+
 	struct exynos_matrix linear_matrix_cache;
 
 	struct kthread_work commit_work;
@@ -335,6 +404,7 @@ struct exynos_drm_crtc {
 		struct drm_property *max_disp_freq;
 		struct drm_property *linear_matrix;
 		struct drm_property *linear_matrix_override;
+		struct drm_property *linear_matrix_transition_ms;
 		struct drm_property *gamma_matrix;
 		struct drm_property *dqe_enabled;
 		struct drm_property *partial;
@@ -385,6 +455,23 @@ to_exynos_priv_state(const struct drm_private_state *state)
 	return container_of(state, struct exynos_drm_priv_state, base);
 }
 
+/* atomic check count and latencies of one path */
+struct exynos_atomic_check_path_stats {
+	atomic_t cnt;
+	atomic_t max_us;
+	atomic64_t total_us;
+};
+
+/*
+ * atomic check counters and latencies for fast path (buffer-only) and full
+ * checks, atomic as checks of different crtcs may run concurrently
+ */
+struct exynos_atomic_check_stats {
+	struct exynos_atomic_check_path_stats fast;
+	struct exynos_atomic_check_path_stats full;
+	atomic_t verify_mismatch;
+};
+
 /*
  * Exynos drm private structure.
  *
@@ -413,6 +500,13 @@ struct exynos_drm_private {
 
 	struct exynos_drm_connector_properties connector_props;
 	struct drm_private_obj	obj;
+
+	/* atomic commits and crtc/plane state allocations and references */
+	atomic_t		commit_cnt;
+	atomic_t		state_alloc_cnt;
+	atomic_t		state_ref_cnt;
+
+	struct exynos_atomic_check_stats check_stats;
 };
 
 #define drm_to_exynos_dev(dev) container_of(dev, struct exynos_drm_private, drm)
@@ -435,6 +529,40 @@ static inline int exynos_dpi_bind(struct drm_device *dev,
 }
 #endif
 
+#define EXYNOS_DRM_WAIT_FENCE_TIMEOUT_MS 250
+
+struct exynos_fence_join;
+
+struct exynos_fence_join_cb {
+	struct dma_fence_cb cb;
+	struct exynos_fence_join *join;
+	struct drm_plane_state *plane_state;
+	bool signaled;
+	/* set once the plane was programmed in late-latch mode */
+	bool latched;
+};
+
+/*
+ * Waits for all plane fences of a commit at once. The waitqueue is woken on
+ * every fence signal, @pending drops to zero when the last one signaled.
+ */
+struct exynos_fence_join {
+	struct exynos_fence_join_cb *cbs;
+	int num_fences;
+	atomic_t pending;
+	wait_queue_head_t wait;
+	ktime_t start;
+	bool wake_each;
+	/* the fence which signaled last, i.e. the critical path of the commit */
+	struct exynos_fence_join_cb *last;
+};
+
+int exynos_fence_join_arm(struct drm_atomic_state *state, struct exynos_fence_join *join,
+			  bool wake_each);
+int exynos_fence_join_finish(struct drm_device *dev, struct drm_atomic_state *state,
+			     struct exynos_fence_join *join, long ret);
+void exynos_atomic_frame_stamp(struct drm_atomic_state *state,
+			       enum exynos_frame_stage stage, ktime_t ts);
 int exynos_atomic_commit(struct drm_device *dev, struct drm_atomic_state *state,
 			 bool nonblock);
 int exynos_atomic_check(struct drm_device *dev, struct drm_atomic_state *state);
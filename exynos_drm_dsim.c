@@ -20,6 +20,7 @@
 #include <drm/drm_panel.h>
 #include <drm/drm_atomic.h>
 #include <drm/drm_atomic_helper.h>
+#include <drm/drm_bridge.h>
 #include <drm/drm_modes.h>
 #include <drm/drm_vblank.h>
 
@@ -615,6 +616,59 @@ static void dsim_encoder_disable(struct drm_encoder *encoder, struct drm_atomic_
 	DPU_ATRACE_END(__func__);
 }
 
+/*
+ * Restart DSI link and panel while DECON keeps its configuration. Panel is put
+ * into blanked mode so that it stays powered, and only gets reset and sent its
+ * init cmd set again. Caller must hold connection_mutex, and have connector and
+ * encoder bridge states of current configuration in @state.
+ */
+int dsim_reset_link(struct dsim_device *dsim, struct drm_atomic_state *state)
+{
+	struct drm_encoder *encoder = &dsim->encoder;
+	struct drm_bridge *bridge = drm_bridge_chain_get_first_bridge(encoder);
+	struct dsim_connector_funcs *funcs;
+	struct drm_connector *connector;
+	enum dsim_state dsim_state;
+
+	connector = drm_atomic_get_old_connector_for_encoder(state, encoder);
+	if (!bridge || !connector || !connector->state)
+		return -EOPNOTSUPP;
+
+	funcs = get_connector_funcs(connector->state);
+	if (!funcs || !funcs->set_blanked_mode)
+		return -EOPNOTSUPP;
+
+	mutex_lock(&dsim->state_lock);
+	dsim_state = dsim->state;
+	mutex_unlock(&dsim->state_lock);
+	if (dsim_state != DSIM_STATE_HSCLKEN) {
+		dsim_warn(dsim, "unable to reset link in state %d\n", dsim_state);
+		return -EBUSY;
+	}
+
+	DPU_ATRACE_BEGIN(__func__);
+	dsim_info(dsim, "resetting link\n");
+
+	funcs->set_blanked_mode(connector->state, true);
+	drm_atomic_bridge_chain_disable(bridge, state);
+	drm_atomic_bridge_chain_post_disable(bridge, state);
+
+	_dsim_disable(dsim);
+	_dsim_enable(dsim);
+
+	drm_atomic_bridge_chain_pre_enable(bridge, state);
+	drm_atomic_bridge_chain_enable(bridge, state);
+	funcs->set_blanked_mode(connector->state, false);
+
+	mutex_lock(&dsim->state_lock);
+	dsim_state = dsim->state;
+	mutex_unlock(&dsim->state_lock);
+
+	DPU_ATRACE_END(__func__);
+
+	return dsim_state == DSIM_STATE_HSCLKEN ? 0 : -EIO;
+}
+
 static struct dsim_pll_param *
 dsim_get_clock_mode(const struct dsim_device *dsim,
 		    const struct drm_display_mode *mode)
@@ -1318,6 +1372,14 @@ static void set_state_recovering_exynos(struct drm_connector_state *conn_state)
 	exynos_conn_state->is_recovering = true;
 }
 
+static void set_blanked_mode_exynos(struct drm_connector_state *conn_state, bool blanked)
+{
+	struct exynos_drm_connector_state *exynos_conn_state;
+
+	exynos_conn_state = to_exynos_connector_state(conn_state);
+	exynos_conn_state->blanked_mode = blanked;
+}
+
 /*
  * Check whether mode change can happean seamlessly from dsim perspective.
  * Seamless mode switch from dsim perspective can only happen if there's no
@@ -1391,6 +1453,7 @@ static struct dsim_connector_funcs exynos_dsim_connector_funcs = {
 	.atomic_check = &dsim_atomic_check_exynos,
 	.atomic_mode_set = &dsim_atomic_mode_set_exynos,
 	.set_state_recovering = &set_state_recovering_exynos,
+	.set_blanked_mode = &set_blanked_mode_exynos,
 	.update_config_for_mode = &update_config_for_mode_exynos,
 	.update_hs_clk = &update_hs_clk_exynos,
 };
@@ -1482,6 +1545,14 @@ static void set_state_recovering_gs(struct drm_connector_state *conn_state)
 	gs_conn_state->is_recovering = true;
 }
 
+static void set_blanked_mode_gs(struct drm_connector_state *conn_state, bool blanked)
+{
+	struct gs_drm_connector_state *gs_conn_state;
+
+	gs_conn_state = to_gs_connector_state(conn_state);
+	gs_conn_state->blanked_mode = blanked;
+}
+
 static void update_hs_clk_gs(struct dsim_device *dsim, struct drm_connector_state *conn_state)
 {
 	struct gs_drm_connector_state *gs_conn_state = to_gs_connector_state(conn_state);
@@ -1497,6 +1568,7 @@ static struct dsim_connector_funcs gs_dsim_connector_funcs = {
 	.atomic_check = &dsim_atomic_check_gs,
 	.atomic_mode_set = &dsim_atomic_mode_set_gs,
 	.set_state_recovering = &set_state_recovering_gs,
+	.set_blanked_mode = &set_blanked_mode_gs,
 	.update_config_for_mode = &update_config_for_mode_gs,
 	.update_hs_clk = &update_hs_clk_gs,
 };
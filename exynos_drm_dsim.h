@@ -146,6 +146,7 @@ extern struct dsim_device *dsim_drvdata[MAX_DSI_CNT];
  * @atomic_check: Checking validity of mode change
  * @atomic_mode_set: Sets mode
  * @set_state_recovering: Sets connector state to reflect recovery
+ * @set_blanked_mode: Sets or clears forced blanked mode in connector state
  * @update_config_for_mode: Updates dsim_reg to match mode
  * @update_hs_clk: Updates HS clock for panel usage
  */
@@ -155,6 +156,7 @@ struct dsim_connector_funcs {
 	void (*atomic_mode_set)(struct dsim_device *dsim, struct drm_crtc_state *crtc_state,
 				struct drm_connector_state *conn_state);
 	void (*set_state_recovering)(struct drm_connector_state *conn_state);
+	void (*set_blanked_mode)(struct drm_connector_state *conn_state, bool blanked);
 	void (*update_config_for_mode)(struct dsim_reg_config *config,
 				       const struct drm_display_mode *mode,
 				       const struct drm_connector_state *conn_state);
@@ -206,6 +208,7 @@ dsim_get_decon(const struct dsim_device *dsim)
 }
 
 void dsim_dump(struct dsim_device *dsim, struct drm_printer *p);
+int dsim_reset_link(struct dsim_device *dsim, struct drm_atomic_state *state);
 
 inline void dsim_trace_msleep(u32 delay_ms);
 
@@ -46,9 +46,26 @@
 
 extern const struct dpp_restriction dpp_drv_data;
 
+/*
+ * the buffer content was updated in place, a duplicate frame can no longer be
+ * trusted to reproduce what the panel shows until verified by CRC again
+ */
+static int exynos_drm_fb_dirty(struct drm_framebuffer *fb, struct drm_file *file_priv,
+			       unsigned int flags, unsigned int color,
+			       struct drm_clip_rect *clips, unsigned int num_clips)
+{
+	struct drm_crtc *crtc;
+
+	drm_for_each_crtc(crtc, fb->dev)
+		WRITE_ONCE(crtc_to_decon(crtc)->dup.verified_seq, 0);
+
+	return 0;
+}
+
 static const struct drm_framebuffer_funcs exynos_drm_fb_funcs = {
 	.destroy	= drm_gem_fb_destroy,
 	.create_handle	= drm_gem_fb_create_handle,
+	.dirty		= exynos_drm_fb_dirty,
 };
 
 static struct drm_framebuffer *
@@ -781,6 +798,138 @@ static void exynos_drm_atomic_helper_commit_modeset_disables(struct drm_device *
 	exynos_crtc_set_mode(dev, old_state);
 }
 
+static void exynos_atomic_commit_plane(struct drm_atomic_state *old_state,
+				       struct drm_plane *plane)
+{
+	const struct drm_plane_helper_funcs *funcs = plane->helper_private;
+	struct drm_plane_state *old_plane_state =
+		drm_atomic_get_old_plane_state(old_state, plane);
+	struct drm_plane_state *new_plane_state =
+		drm_atomic_get_new_plane_state(old_state, plane);
+	const struct drm_plane_state *plane_state;
+	bool disabling;
+
+	if (!funcs)
+		return;
+
+	/* same as drm_atomic_helper_commit_planes() with DRM_PLANE_COMMIT_ACTIVE_ONLY */
+	disabling = drm_atomic_plane_disabling(old_plane_state, new_plane_state);
+	plane_state = disabling ? old_plane_state : new_plane_state;
+	if (!plane_state->crtc || !plane_state->crtc->state->active)
+		return;
+
+	if (disabling && funcs->atomic_disable) {
+		funcs->atomic_disable(plane, old_state);
+	} else {
+		funcs->atomic_update(plane, old_state);
+		if (!disabling && funcs->atomic_enable &&
+		    drm_atomic_plane_enabling(old_plane_state, new_plane_state))
+			funcs->atomic_enable(plane, old_state);
+	}
+}
+
+static bool exynos_fence_join_has_ready(const struct exynos_fence_join *join)
+{
+	int i;
+
+	for (i = 0; i < join->num_fences; i++) {
+		if (READ_ONCE(join->cbs[i].signaled) && !join->cbs[i].latched)
+			return true;
+	}
+
+	return !atomic_read(&join->pending);
+}
+
+/*
+ * Late-latch version of drm_atomic_helper_commit_planes(): DPP windows are
+ * programmed as soon as their own fence signals, in signal order, while
+ * shadow updates are masked since atomic_begin. Only atomic_flush, which
+ * triggers the frame, waits until all fences of the commit signaled.
+ */
+static void exynos_atomic_commit_planes_late_latch(struct drm_device *dev,
+						   struct drm_atomic_state *old_state,
+						   struct exynos_fence_join *join)
+{
+	const struct drm_crtc_helper_funcs *crtc_funcs;
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *old_crtc_state, *new_crtc_state;
+	struct drm_plane *plane;
+	struct drm_plane_state *new_plane_state;
+	struct exynos_fence_join_cb *jcb;
+	long tmo = msecs_to_jiffies(EXYNOS_DRM_WAIT_FENCE_TIMEOUT_MS);
+	int i, latched = 0;
+
+	for_each_new_crtc_in_state(old_state, crtc, new_crtc_state, i) {
+		crtc_funcs = crtc->helper_private;
+		if (crtc_funcs && crtc_funcs->atomic_begin && new_crtc_state->active)
+			crtc_funcs->atomic_begin(crtc, old_state);
+	}
+
+	/* planes without a pending fence can be programmed right away */
+	for_each_new_plane_in_state(old_state, plane, new_plane_state, i) {
+		if (!new_plane_state->fence)
+			exynos_atomic_commit_plane(old_state, plane);
+	}
+
+	while (tmo > 0) {
+		for (i = 0; i < join->num_fences; i++) {
+			jcb = &join->cbs[i];
+			if (jcb->latched || !READ_ONCE(jcb->signaled))
+				continue;
+
+			DPU_ATRACE_BEGIN("late_latch_plane");
+			exynos_atomic_commit_plane(old_state, jcb->plane_state->plane);
+			DPU_ATRACE_END("late_latch_plane");
+			jcb->latched = true;
+			latched++;
+		}
+
+		if (latched == join->num_fences)
+			break;
+
+		DPU_ATRACE_BEGIN("wait_for_fences");
+		tmo = wait_event_timeout(join->wait, exynos_fence_join_has_ready(join), tmo);
+		DPU_ATRACE_END("wait_for_fences");
+	}
+
+	/* on timeout the remaining planes are programmed anyway, as in the regular path */
+	for (i = 0; i < join->num_fences; i++) {
+		jcb = &join->cbs[i];
+		if (!jcb->latched)
+			exynos_atomic_commit_plane(old_state, jcb->plane_state->plane);
+	}
+
+	exynos_atomic_frame_stamp(old_state, EXYNOS_FRAME_FENCE, ktime_get());
+	exynos_fence_join_finish(dev, old_state, join, 0);
+
+	for_each_oldnew_crtc_in_state(old_state, crtc, old_crtc_state, new_crtc_state, i) {
+		to_exynos_crtc_state(new_crtc_state)->fence_join = NULL;
+
+		crtc_funcs = crtc->helper_private;
+		if (crtc_funcs && crtc_funcs->atomic_flush && new_crtc_state->active)
+			crtc_funcs->atomic_flush(crtc, old_state);
+	}
+}
+
+static void exynos_atomic_commit_planes(struct drm_device *dev,
+					struct drm_atomic_state *old_state)
+{
+	struct drm_crtc *crtc;
+	struct drm_crtc_state *new_crtc_state;
+	int i;
+
+	for_each_new_crtc_in_state(old_state, crtc, new_crtc_state, i) {
+		struct exynos_fence_join *join = to_exynos_crtc_state(new_crtc_state)->fence_join;
+
+		if (join) {
+			exynos_atomic_commit_planes_late_latch(dev, old_state, join);
+			return;
+		}
+	}
+
+	drm_atomic_helper_commit_planes(dev, old_state, DRM_PLANE_COMMIT_ACTIVE_ONLY);
+}
+
 static void exynos_atomic_commit_tail(struct drm_atomic_state *old_state)
 {
 	int i;
@@ -855,8 +1004,7 @@ static void exynos_atomic_commit_tail(struct drm_atomic_state *old_state)
 	DPU_ATRACE_END("connector_pre_commit");
 
 	DPU_ATRACE_BEGIN("commit_planes");
-	drm_atomic_helper_commit_planes(dev, old_state,
-					DRM_PLANE_COMMIT_ACTIVE_ONLY);
+	exynos_atomic_commit_planes(dev, old_state);
 	DPU_ATRACE_END("commit_planes");
 
 	/*
@@ -20,6 +20,7 @@
 #include <linux/sched.h>
 #include <linux/err.h>
 #include <linux/atomic.h>
+#include <linux/moduleparam.h>
 
 #include <trace/dpu_trace.h>
 
@@ -32,6 +33,43 @@
 #define HIBERNATION_ENTRY_MIN_TIME_MS		50
 #define CAMERA_OPERATION_MASK	0xF
 
+static bool block_gating;
+module_param(block_gating, bool, 0664);
+MODULE_PARM_DESC(block_gating, "Enable/disable clock gating of idle DPP channels, DSC and writeback");
+
+bool exynos_idle_gate_enter(struct exynos_idle_gate *gate)
+{
+	if (!block_gating || gate->gated)
+		return false;
+
+	gate->gated = true;
+	gate->gate_cnt++;
+	gate->gate_ts = ktime_get();
+
+	return true;
+}
+
+bool exynos_idle_gate_exit(struct exynos_idle_gate *gate)
+{
+	if (!gate->gated)
+		return false;
+
+	gate->gated = false;
+	gate->residency_us += ktime_us_delta(ktime_get(), gate->gate_ts);
+
+	return true;
+}
+
+u64 exynos_idle_gate_residency_us(const struct exynos_idle_gate *gate)
+{
+	u64 residency_us = gate->residency_us;
+
+	if (gate->gated)
+		residency_us += ktime_us_delta(ktime_get(), gate->gate_ts);
+
+	return residency_us;
+}
+
 static bool is_camera_operating(struct exynos_hibernation *hiber)
 {
 	/* No need to check camera operation status. It depends on SoC */
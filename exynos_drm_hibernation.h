@@ -20,6 +20,7 @@
 #include <linux/sched.h>
 #include <linux/kthread.h>
 #include <linux/io.h>
+#include <linux/ktime.h>
 
 struct decon_device;
 struct dsim_device;
@@ -76,6 +77,40 @@ void hibernation_unblock_enter(struct exynos_hibernation *hiber);
  */
 bool exynos_hibernation_async_exit(struct exynos_hibernation *hiber);
 
+/**
+ * struct exynos_idle_gate - clock gating of a single block (DPP channel, DSC,
+ *	writeback) while it is idle and the decon itself stays on
+ * @gated: gating is currently requested for the block
+ * @gate_cnt: number of times the block was gated
+ * @gate_ts: time of the last gating entry
+ * @residency_us: accumulated time spent gated, not counting the current period
+ */
+struct exynos_idle_gate {
+	bool gated;
+	u32 gate_cnt;
+	ktime_t gate_ts;
+	u64 residency_us;
+};
+
+/**
+ * exynos_idle_gate_enter - account for gating entry of an idle block
+ * @gate: idle gate of the block
+ *
+ * Return: %true if the caller should gate the block, %false if it is already
+ *	gated or block gating is disabled
+ */
+bool exynos_idle_gate_enter(struct exynos_idle_gate *gate);
+
+/**
+ * exynos_idle_gate_exit - account for gating exit of a block about to be used
+ * @gate: idle gate of the block
+ *
+ * Return: %true if the block was gated and the caller should ungate it
+ */
+bool exynos_idle_gate_exit(struct exynos_idle_gate *gate);
+
+u64 exynos_idle_gate_residency_us(const struct exynos_idle_gate *gate);
+
 struct exynos_hibernation *
 exynos_hibernation_register(struct decon_device *decon);
 void exynos_hibernation_destroy(struct exynos_hibernation *hiber);
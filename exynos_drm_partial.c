@@ -15,6 +15,7 @@
 #include <video/mipi_display.h>
 #include <drm/drm_fourcc.h>
 #include <drm/drm_fourcc_gs101.h>
+#include <drm/drm_print.h>
 #include "exynos_drm_decon.h"
 #include "exynos_drm_format.h"
 #include "exynos_drm_dsim.h"
@@ -124,22 +125,41 @@ exynos_plane_state_scaling(const struct drm_plane_state *state)
 		(state->src_h >> 16 != state->crtc_h);
 }
 
+static bool exynos_partial_contains(const struct drm_rect *partial_r,
+		const struct drm_rect *r)
+{
+	return (r->x1 >= partial_r->x1) && (r->x2 <= partial_r->x2) &&
+		(r->y1 >= partial_r->y1) && (r->y2 <= partial_r->y2);
+}
+
 static bool is_partial_supported(const struct drm_plane_state *state,
 		const struct drm_rect *crtc_r, const struct drm_rect *partial_r,
-		const struct dpp_restriction *res)
+		const struct dpp_restriction *res,
+		enum exynos_partial_fallback *reason)
 {
+	const struct drm_rect dst = drm_plane_state_dest(state);
 	const struct dpu_fmt *fmt_info;
 	unsigned int adj_src_x = 0, adj_src_y = 0;
 	u32 format;
 	int sz_align = 1;
 
+	/*
+	 * If the whole plane is inside the update region, its coordinates are
+	 * only translated and no source clipping is needed. Any plane that is
+	 * valid for full update is then valid for partial update as well.
+	 */
+	if (exynos_partial_contains(partial_r, &dst))
+		return true;
+
 	if (exynos_plane_state_rotation(state)) {
 		pr_debug("rotation is detected. partial->full\n");
+		*reason = PARTIAL_FALLBACK_ROTATION;
 		goto not_supported;
 	}
 
 	if (exynos_plane_state_scaling(state)) {
 		pr_debug("scaling is detected. partial->full\n");
+		*reason = PARTIAL_FALLBACK_SCALING;
 		goto not_supported;
 	}
 
@@ -161,6 +181,7 @@ static bool is_partial_supported(const struct drm_plane_state *state,
 				!IS_ALIGNED(adj_src_y, sz_align)) {
 			pr_debug("align limitation. src_x/y[%d/%d] align[%d]\n",
 					adj_src_x, adj_src_y, sz_align);
+			*reason = PARTIAL_FALLBACK_YUV_ALIGN;
 			goto not_supported;
 		}
 	}
@@ -169,6 +190,7 @@ static bool is_partial_supported(const struct drm_plane_state *state,
 			(drm_rect_height(crtc_r) < res->src_f_h.min * sz_align)) {
 		pr_debug("min size limitation. width[%d] height[%d]\n",
 				drm_rect_width(crtc_r), drm_rect_height(crtc_r));
+		*reason = PARTIAL_FALLBACK_MIN_SIZE;
 		goto not_supported;
 	}
 
@@ -179,6 +201,35 @@ not_supported:
 	return false;
 }
 
+/*
+ * Grow the update region so that @dst is fully included, in which case the
+ * plane doesn't need to be clipped anymore.
+ */
+static bool exynos_partial_include_plane(struct exynos_partial *partial,
+		const struct drm_display_mode *mode, const struct drm_rect *dst,
+		struct drm_rect *partial_r)
+{
+	if ((dst->x1 < 0) || (dst->y1 < 0) ||
+			(dst->x2 > mode->hdisplay) || (dst->y2 > mode->vdisplay))
+		return false;
+
+	if ((dst->x1 < partial_r->x1) || (dst->x2 > partial_r->x2))
+		return false;
+
+	partial_r->y1 = min_t(int, partial_r->y1,
+			rounddown(dst->y1, partial->min_h));
+	partial_r->y2 = max_t(int, partial_r->y2,
+			roundup(dst->y2, partial->min_h));
+
+	return true;
+}
+
+/*
+ * the region only grows and every adjustment fully includes one more plane,
+ * so this bounds the number of passes
+ */
+#define PARTIAL_MAX_ADJUST_CNT	(MAX_PLANE + 1)
+
 #define to_dpp_device(x)	container_of(x, struct dpp_device, plane)
 static bool exynos_partial_check(struct exynos_partial *partial,
 			struct exynos_drm_crtc_state *exynos_crtc_state)
@@ -186,30 +237,59 @@ static bool exynos_partial_check(struct exynos_partial *partial,
 	struct drm_crtc_state *crtc_state = &exynos_crtc_state->base;
 	struct drm_plane *plane;
 	const struct drm_plane_state *plane_state;
-	const struct drm_rect *partial_r = &exynos_crtc_state->partial_region;
-	struct drm_rect r;
+	struct drm_rect *partial_r = &exynos_crtc_state->partial_region;
+	struct drm_rect r, dst;
 	const struct dpp_device *dpp;
 	const struct dpp_restriction *res;
+	enum exynos_partial_fallback reason;
+	bool adjusted;
+	int i;
 
-	drm_for_each_plane_mask(plane, crtc_state->state->dev, crtc_state->plane_mask) {
-		plane_state = drm_atomic_get_plane_state(crtc_state->state, plane);
-		if (IS_ERR(plane_state))
+	for (i = 0; i < PARTIAL_MAX_ADJUST_CNT; ++i) {
+		adjusted = false;
+
+		drm_for_each_plane_mask(plane, crtc_state->state->dev,
+				crtc_state->plane_mask) {
+			plane_state = drm_atomic_get_plane_state(crtc_state->state,
+					plane);
+			if (IS_ERR(plane_state)) {
+				exynos_crtc_state->partial_fallback =
+					PARTIAL_FALLBACK_PLANE_STATE;
+				return false;
+			}
+
+			dst = drm_plane_state_dest(plane_state);
+			r = dst;
+
+			if (!drm_rect_intersect(&r, partial_r))
+				continue;
+
+			dpp = to_dpp_device(to_exynos_plane(plane));
+			res = &dpp->restriction;
+			pr_debug("checking plane%d ...\n", drm_plane_index(plane));
+
+			if (is_partial_supported(plane_state, &r, partial_r, res,
+						&reason))
+				continue;
+
+			if (exynos_partial_include_plane(partial,
+						&crtc_state->mode, &dst,
+						partial_r)) {
+				pr_region("expanded update region", partial_r);
+				exynos_crtc_state->partial_expanded++;
+				adjusted = true;
+				break;
+			}
+
+			exynos_crtc_state->partial_fallback = reason;
 			return false;
+		}
 
-		r = drm_plane_state_dest(plane_state);
-
-		if (!drm_rect_intersect(&r, partial_r))
-			continue;
-
-		dpp = to_dpp_device(to_exynos_plane(plane));
-		res = &dpp->restriction;
-		pr_debug("checking plane%d ...\n", drm_plane_index(plane));
-
-		if (!is_partial_supported(plane_state, &r, partial_r, res))
-			return false;
+		if (!adjusted)
+			return true;
 	}
 
-	return true;
+	return false;
 }
 
 static int exynos_partial_send_command(struct exynos_partial *partial,
@@ -388,6 +468,16 @@ void exynos_partial_prepare(struct exynos_partial *partial,
 	int ret = -ENOENT;
 	bool region_changed = false;
 
+	if (new_exynos_crtc_state->partial) {
+		req_region = new_exynos_crtc_state->partial->data;
+		req.x1 = req_region->x1;
+		req.y1 = req_region->y1;
+		req.x2 = req_region->x2;
+		req.y2 = req_region->y2;
+	} else {
+		exynos_partial_set_full(&crtc_state->mode, &req);
+	}
+
 	pr_debug("plane mask[0x%x]\n", crtc_state->plane_mask);
 
 	new_exynos_crtc_state->needs_reconfigure = false;
@@ -401,17 +491,10 @@ void exynos_partial_prepare(struct exynos_partial *partial,
 		return;
 
 	if (old_exynos_crtc_state->partial != new_exynos_crtc_state->partial) {
-		if (new_exynos_crtc_state->partial) {
-			req_region = new_exynos_crtc_state->partial->data;
-			req.x1 = req_region->x1;
-			req.y1 = req_region->y1;
-			req.x2 = req_region->x2;
-			req.y2 = req_region->y2;
-
-			/* find adjusted update region on LCD */
+		/* find adjusted update region on LCD */
+		if (new_exynos_crtc_state->partial)
 			ret = partial->funcs->adjust_partial_region(partial,
 					&crtc_state->mode, &req, partial_r);
-		}
 
 		if (ret)
 			exynos_partial_set_full(&crtc_state->mode, partial_r);
@@ -432,11 +515,17 @@ void exynos_partial_prepare(struct exynos_partial *partial,
 		crtc_state->color_mgmt_changed = true;
 	}
 
-	/* check DPP hw limit if violated, update region is changed to full */
+	/*
+	 * check DPP hw limit, update region may be expanded around unsupported
+	 * planes. If it can't be resolved, it is changed to full.
+	 */
 	if (!partial->funcs->check(partial, new_exynos_crtc_state))
 		exynos_partial_set_full(&crtc_state->mode,
 				&new_exynos_crtc_state->partial_region);
 
+	if (!drm_rect_equals(partial_r, old_partial_r))
+		crtc_state->color_mgmt_changed = true;
+
 	pr_region("final update region", partial_r);
 
 	/*
@@ -509,3 +598,37 @@ void exynos_partial_restore(struct exynos_partial *partial)
 	DPU_EVENT_LOG(DPU_EVT_PARTIAL_RESTORE, decon->id, old_partial_region);
 	pr_region("restored partial region", old_partial_region);
 }
+
+/*
+ * Called on commit only, the adjustments found by TEST_ONLY checks would
+ * otherwise be counted as well.
+ */
+void exynos_partial_count_stats(struct exynos_partial *partial,
+			const struct exynos_drm_crtc_state *exynos_crtc_state)
+{
+	partial->stats.expanded += exynos_crtc_state->partial_expanded;
+
+	if (exynos_crtc_state->partial_fallback != PARTIAL_FALLBACK_NONE)
+		partial->stats.fallback[exynos_crtc_state->partial_fallback]++;
+}
+
+static const char * const partial_fallback_names[PARTIAL_FALLBACK_MAX] = {
+	[PARTIAL_FALLBACK_ROTATION]	= "rotation",
+	[PARTIAL_FALLBACK_SCALING]	= "scaling",
+	[PARTIAL_FALLBACK_YUV_ALIGN]	= "yuv_align",
+	[PARTIAL_FALLBACK_MIN_SIZE]	= "min_size",
+	[PARTIAL_FALLBACK_PLANE_STATE]	= "plane_state",
+};
+
+void exynos_partial_print_stats(const struct exynos_partial *partial,
+				struct drm_printer *p)
+{
+	int i;
+
+	drm_printf(p, "min rect: %ux%u\n", partial->min_w, partial->min_h);
+	drm_printf(p, "expanded: %u\n", partial->stats.expanded);
+
+	for (i = 0; i < PARTIAL_FALLBACK_MAX; ++i)
+		drm_printf(p, "fallback_%s: %u\n", partial_fallback_names[i],
+				partial->stats.fallback[i]);
+}
@@ -16,8 +16,27 @@
 #include <drm/drm_rect.h>
 
 struct decon_device;
+struct drm_printer;
 struct exynos_partial;
 
+/* reasons for a plane to force the partial update region back to full */
+enum exynos_partial_fallback {
+	PARTIAL_FALLBACK_NONE = -1,
+	PARTIAL_FALLBACK_ROTATION = 0,
+	PARTIAL_FALLBACK_SCALING,
+	PARTIAL_FALLBACK_YUV_ALIGN,
+	PARTIAL_FALLBACK_MIN_SIZE,
+	PARTIAL_FALLBACK_PLANE_STATE,
+	PARTIAL_FALLBACK_MAX,
+};
+
+struct exynos_partial_stats {
+	/* count of full updates caused by each unsupported plane reason */
+	u32 fallback[PARTIAL_FALLBACK_MAX];
+	/* count of regions expanded to fully include an unsupported plane */
+	u32 expanded;
+};
+
 struct exynos_partial_funcs {
 	int (*init)(struct exynos_partial *partial,
 			const struct exynos_display_partial *partial_mode,
@@ -38,6 +57,7 @@ struct exynos_partial {
 	u32 min_h;
 	struct decon_device *decon;
 	const struct exynos_partial_funcs *funcs;
+	struct exynos_partial_stats stats;
 };
 
 void exynos_partial_set_full(const struct drm_display_mode *mode,
@@ -55,5 +75,9 @@ void exynos_partial_update(struct exynos_partial *partial,
 			const struct drm_rect *old_partial_region,
 			struct drm_rect *new_partial_region);
 void exynos_partial_restore(struct exynos_partial *partial);
+void exynos_partial_count_stats(struct exynos_partial *partial,
+			const struct exynos_drm_crtc_state *exynos_crtc_state);
+void exynos_partial_print_stats(const struct exynos_partial *partial,
+			struct drm_printer *p);
 
 #endif /* __EXYNOS_DRM_PARTIAL_H__ */
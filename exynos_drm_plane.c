@@ -23,30 +23,82 @@
 #include "exynos_drm_plane.h"
 #include "exynos_drm_decon.h"
 
+static struct kmem_cache *exynos_plane_state_cache;
+static struct kmem_cache *exynos_plane_blobs_cache;
+
+static struct exynos_plane_blobs *exynos_plane_blobs_alloc(struct drm_device *dev)
+{
+	struct exynos_plane_blobs *blobs;
+
+	blobs = kmem_cache_zalloc(exynos_plane_blobs_cache, GFP_KERNEL);
+	if (!blobs)
+		return NULL;
+
+	kref_init(&blobs->ref);
+	atomic_inc(&drm_to_exynos_dev(dev)->state_alloc_cnt);
+
+	return blobs;
+}
+
+static void exynos_plane_blobs_release(struct kref *ref)
+{
+	struct exynos_plane_blobs *blobs = container_of(ref, struct exynos_plane_blobs, ref);
+
+	drm_property_blob_put(blobs->eotf_lut);
+	drm_property_blob_put(blobs->oetf_lut);
+	drm_property_blob_put(blobs->gm);
+	drm_property_blob_put(blobs->tm);
+	drm_property_blob_put(blobs->block);
+	kmem_cache_free(exynos_plane_blobs_cache, blobs);
+}
+
+/* returns blobs of the state which can be modified, copying them if they are shared */
+static struct exynos_plane_blobs *
+exynos_plane_blobs_get_writable(struct drm_plane_state *state)
+{
+	struct exynos_drm_plane_state *exynos_state = to_exynos_plane_state(state);
+	struct exynos_plane_blobs *old = exynos_state->blobs;
+	struct exynos_plane_blobs *blobs;
+
+	if (kref_read(&old->ref) == 1)
+		return old;
+
+	blobs = exynos_plane_blobs_alloc(state->plane->dev);
+	if (!blobs)
+		return NULL;
+
+	blobs->eotf_lut = drm_property_blob_get(old->eotf_lut);
+	blobs->oetf_lut = drm_property_blob_get(old->oetf_lut);
+	blobs->gm = drm_property_blob_get(old->gm);
+	blobs->tm = drm_property_blob_get(old->tm);
+	blobs->block = drm_property_blob_get(old->block);
+
+	kref_put(&old->ref, exynos_plane_blobs_release);
+	exynos_state->blobs = blobs;
+
+	return blobs;
+}
+
 static struct drm_plane_state *
 exynos_drm_plane_duplicate_state(struct drm_plane *plane)
 {
+	struct exynos_drm_private *private = drm_to_exynos_dev(plane->dev);
 	struct drm_plane_state *old_state = plane->state;
 	struct exynos_drm_plane_state *old_exynos_state, *new_exynos_state;
 	struct exynos_drm_plane_state *copy;
 
 	old_exynos_state = to_exynos_plane_state(old_state);
-	copy = kzalloc(sizeof(*old_exynos_state), GFP_KERNEL);
+	copy = kmem_cache_alloc(exynos_plane_state_cache, GFP_KERNEL);
 	if (!copy)
 		return NULL;
 
 	memcpy(copy, old_exynos_state, sizeof(*old_exynos_state));
 
-	if (copy->eotf_lut)
-		drm_property_blob_get(copy->eotf_lut);
-	if (copy->oetf_lut)
-		drm_property_blob_get(copy->oetf_lut);
-	if (copy->gm)
-		drm_property_blob_get(copy->gm);
-	if (copy->tm)
-		drm_property_blob_get(copy->tm);
-	if (copy->block)
-		drm_property_blob_get(copy->block);
+	/* property blobs are shared until modified */
+	kref_get(&copy->blobs->ref);
+
+	atomic_inc(&private->state_alloc_cnt);
+	atomic_inc(&private->state_ref_cnt);
 
 	__drm_atomic_helper_plane_duplicate_state(plane, &copy->base);
 
@@ -72,13 +124,10 @@ static void exynos_drm_plane_destroy_state(struct drm_plane *plane,
 		old_exynos_state->old_fb = NULL;
 	}
 
-	drm_property_blob_put(old_exynos_state->eotf_lut);
-	drm_property_blob_put(old_exynos_state->oetf_lut);
-	drm_property_blob_put(old_exynos_state->gm);
-	drm_property_blob_put(old_exynos_state->tm);
-	drm_property_blob_put(old_exynos_state->block);
+	if (old_exynos_state->blobs)
+		kref_put(&old_exynos_state->blobs->ref, exynos_plane_blobs_release);
 	__drm_atomic_helper_plane_destroy_state(old_state);
-	kfree(old_exynos_state);
+	kmem_cache_free(exynos_plane_state_cache, old_exynos_state);
 }
 
 static void exynos_drm_plane_reset(struct drm_plane *plane)
@@ -91,15 +140,42 @@ static void exynos_drm_plane_reset(struct drm_plane *plane)
 		plane->state = NULL;
 	}
 
-	exynos_state = kzalloc(sizeof(*exynos_state), GFP_KERNEL);
-	if (exynos_state) {
-		plane->state = &exynos_state->base;
-		plane->state->plane = plane;
-		plane->state->zpos = exynos_plane->index;
-		plane->state->normalized_zpos = exynos_plane->index;
-		plane->state->alpha = DRM_BLEND_ALPHA_OPAQUE;
-		plane->state->pixel_blend_mode = DRM_MODE_BLEND_PREMULTI;
+	exynos_state = kmem_cache_zalloc(exynos_plane_state_cache, GFP_KERNEL);
+	if (!exynos_state)
+		return;
+
+	exynos_state->blobs = exynos_plane_blobs_alloc(plane->dev);
+	if (!exynos_state->blobs) {
+		kmem_cache_free(exynos_plane_state_cache, exynos_state);
+		return;
 	}
+
+	plane->state = &exynos_state->base;
+	plane->state->plane = plane;
+	plane->state->zpos = exynos_plane->index;
+	plane->state->normalized_zpos = exynos_plane->index;
+	plane->state->alpha = DRM_BLEND_ALPHA_OPAQUE;
+	plane->state->pixel_blend_mode = DRM_MODE_BLEND_PREMULTI;
+}
+
+int exynos_drm_plane_init_caches(void)
+{
+	exynos_plane_state_cache = KMEM_CACHE(exynos_drm_plane_state, 0);
+	exynos_plane_blobs_cache = KMEM_CACHE(exynos_plane_blobs, 0);
+	if (!exynos_plane_state_cache || !exynos_plane_blobs_cache) {
+		exynos_drm_plane_destroy_caches();
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+void exynos_drm_plane_destroy_caches(void)
+{
+	kmem_cache_destroy(exynos_plane_blobs_cache);
+	kmem_cache_destroy(exynos_plane_state_cache);
+	exynos_plane_blobs_cache = NULL;
+	exynos_plane_state_cache = NULL;
 }
 
 static int
@@ -127,6 +203,25 @@ exynos_drm_replace_property_blob_from_id(struct drm_device *dev,
 	return 0;
 }
 
+/* replace one of the plane blobs, which are copied first if still shared */
+static int exynos_plane_replace_blob(struct drm_plane_state *state, size_t offset,
+				     uint64_t blob_id, ssize_t expected_size)
+{
+	struct exynos_plane_blobs *blobs = to_exynos_plane_state(state)->blobs;
+	struct drm_property_blob **blob = (void *)blobs + offset;
+
+	/* setting the current blob again must not unshare them */
+	if ((*blob ? (*blob)->base.id : 0) == blob_id)
+		return 0;
+
+	blobs = exynos_plane_blobs_get_writable(state);
+	if (!blobs)
+		return -ENOMEM;
+
+	return exynos_drm_replace_property_blob_from_id(state->plane->dev,
+			(void *)blobs + offset, blob_id, expected_size);
+}
+
 static int exynos_drm_plane_set_property(struct drm_plane *plane,
 				   struct drm_plane_state *state,
 				   struct drm_property *property,
@@ -151,41 +246,41 @@ static int exynos_drm_plane_set_property(struct drm_plane *plane,
 		exynos_state->colormap = val;
 	} else if (property == exynos_plane->props.eotf_lut) {
 #if defined(CONFIG_SOC_ZUMA)
-		ret = exynos_drm_replace_property_blob_from_id(
-				state->plane->dev, &exynos_state->eotf_lut,
+		ret = exynos_plane_replace_blob(state,
+				offsetof(struct exynos_plane_blobs, eotf_lut),
 				val, sizeof(struct hdr_eotf_lut_v2p2));
 #else
-		ret = exynos_drm_replace_property_blob_from_id(
-				state->plane->dev, &exynos_state->eotf_lut,
+		ret = exynos_plane_replace_blob(state,
+				offsetof(struct exynos_plane_blobs, eotf_lut),
 				val, sizeof(struct hdr_eotf_lut));
 #endif
 	} else if (property == exynos_plane->props.oetf_lut) {
 #if defined(CONFIG_SOC_ZUMA)
-		ret = exynos_drm_replace_property_blob_from_id(
-				state->plane->dev, &exynos_state->oetf_lut,
+		ret = exynos_plane_replace_blob(state,
+				offsetof(struct exynos_plane_blobs, oetf_lut),
 				val, sizeof(struct hdr_oetf_lut_v2p2));
 #else
-		ret = exynos_drm_replace_property_blob_from_id(
-				state->plane->dev, &exynos_state->oetf_lut,
+		ret = exynos_plane_replace_blob(state,
+				offsetof(struct exynos_plane_blobs, oetf_lut),
 				val, sizeof(struct hdr_oetf_lut));
 #endif
 	} else if (property == exynos_plane->props.gm) {
-		ret = exynos_drm_replace_property_blob_from_id(
-				state->plane->dev, &exynos_state->gm,
+		ret = exynos_plane_replace_blob(state,
+				offsetof(struct exynos_plane_blobs, gm),
 				val, sizeof(struct hdr_gm_data));
 	} else if (property == exynos_plane->props.tm) {
 #if defined(CONFIG_SOC_ZUMA)
-		ret = exynos_drm_replace_property_blob_from_id(
-				state->plane->dev, &exynos_state->tm,
+		ret = exynos_plane_replace_blob(state,
+				offsetof(struct exynos_plane_blobs, tm),
 				val, sizeof(struct hdr_tm_data_v2p2));
 #else
-		ret = exynos_drm_replace_property_blob_from_id(
-				state->plane->dev, &exynos_state->tm,
+		ret = exynos_plane_replace_blob(state,
+				offsetof(struct exynos_plane_blobs, tm),
 				val, sizeof(struct hdr_tm_data));
 #endif
 	} else if (property == exynos_plane->props.block) {
-		ret = exynos_drm_replace_property_blob_from_id(
-				state->plane->dev, &exynos_state->block,
+		ret = exynos_plane_replace_blob(state,
+				offsetof(struct exynos_plane_blobs, block),
 				val, sizeof(struct decon_win_rect));
 	} else {
 		return -EINVAL;
@@ -218,17 +313,17 @@ static int exynos_drm_plane_get_property(struct drm_plane *plane,
 	else if (property == exynos_plane->props.colormap)
 		*val = exynos_state->colormap;
 	else if (property == exynos_plane->props.eotf_lut)
-		*val = (exynos_state->eotf_lut) ?
-			exynos_state->eotf_lut->base.id : 0;
+		*val = (exynos_state->blobs->eotf_lut) ?
+			exynos_state->blobs->eotf_lut->base.id : 0;
 	else if (property == exynos_plane->props.oetf_lut)
-		*val = (exynos_state->oetf_lut) ?
-			exynos_state->oetf_lut->base.id : 0;
+		*val = (exynos_state->blobs->oetf_lut) ?
+			exynos_state->blobs->oetf_lut->base.id : 0;
 	else if (property == exynos_plane->props.gm)
-		*val = (exynos_state->gm) ? exynos_state->gm->base.id : 0;
+		*val = (exynos_state->blobs->gm) ? exynos_state->blobs->gm->base.id : 0;
 	else if (property == exynos_plane->props.tm)
-		*val = (exynos_state->tm) ? exynos_state->tm->base.id : 0;
+		*val = (exynos_state->blobs->tm) ? exynos_state->blobs->tm->base.id : 0;
 	else if (property == exynos_plane->props.block)
-		*val = (exynos_state->block) ? exynos_state->block->base.id : 0;
+		*val = (exynos_state->blobs->block) ? exynos_state->blobs->block->base.id : 0;
 	else
 		return -EINVAL;
 
@@ -328,29 +423,29 @@ exynos_plane_update_hdr_params(struct exynos_drm_plane_state *exynos_state)
 	struct hdr_gm_data *gm;
 	struct hdr_tm_data_v2p2 *tm;
 
-	if (exynos_state->eotf_lut) {
-		eotf_lut = (struct hdr_eotf_lut_v2p2 *)exynos_state->eotf_lut->data;
+	if (exynos_state->blobs->eotf_lut) {
+		eotf_lut = (struct hdr_eotf_lut_v2p2 *)exynos_state->blobs->eotf_lut->data;
 		hdr_state->eotf_lut = eotf_lut;
 	} else {
 		hdr_state->eotf_lut = NULL;
 	}
 
-	if (exynos_state->oetf_lut) {
-		oetf_lut = (struct hdr_oetf_lut_v2p2 *)exynos_state->oetf_lut->data;
+	if (exynos_state->blobs->oetf_lut) {
+		oetf_lut = (struct hdr_oetf_lut_v2p2 *)exynos_state->blobs->oetf_lut->data;
 		hdr_state->oetf_lut = oetf_lut;
 	} else {
 		hdr_state->oetf_lut = NULL;
 	}
 
-	if (exynos_state->gm) {
-		gm = (struct hdr_gm_data *)exynos_state->gm->data;
+	if (exynos_state->blobs->gm) {
+		gm = (struct hdr_gm_data *)exynos_state->blobs->gm->data;
 		hdr_state->gm = gm;
 	} else {
 		hdr_state->gm = NULL;
 	}
 
-	if (exynos_state->tm) {
-		tm = (struct hdr_tm_data_v2p2 *)exynos_state->tm->data;
+	if (exynos_state->blobs->tm) {
+		tm = (struct hdr_tm_data_v2p2 *)exynos_state->blobs->tm->data;
 		hdr_state->tm = tm;
 	} else {
 		hdr_state->tm = NULL;
@@ -366,29 +461,29 @@ exynos_plane_update_hdr_params(struct exynos_drm_plane_state *exynos_state)
 	struct hdr_gm_data *gm;
 	struct hdr_tm_data *tm;
 
-	if (exynos_state->eotf_lut) {
-		eotf_lut = (struct hdr_eotf_lut *)exynos_state->eotf_lut->data;
+	if (exynos_state->blobs->eotf_lut) {
+		eotf_lut = (struct hdr_eotf_lut *)exynos_state->blobs->eotf_lut->data;
 		hdr_state->eotf_lut = eotf_lut;
 	} else {
 		hdr_state->eotf_lut = NULL;
 	}
 
-	if (exynos_state->oetf_lut) {
-		oetf_lut = (struct hdr_oetf_lut *)exynos_state->oetf_lut->data;
+	if (exynos_state->blobs->oetf_lut) {
+		oetf_lut = (struct hdr_oetf_lut *)exynos_state->blobs->oetf_lut->data;
 		hdr_state->oetf_lut = oetf_lut;
 	} else {
 		hdr_state->oetf_lut = NULL;
 	}
 
-	if (exynos_state->gm) {
-		gm = (struct hdr_gm_data *)exynos_state->gm->data;
+	if (exynos_state->blobs->gm) {
+		gm = (struct hdr_gm_data *)exynos_state->blobs->gm->data;
 		hdr_state->gm = gm;
 	} else {
 		hdr_state->gm = NULL;
 	}
 
-	if (exynos_state->tm) {
-		tm = (struct hdr_tm_data *)exynos_state->tm->data;
+	if (exynos_state->blobs->tm) {
+		tm = (struct hdr_tm_data *)exynos_state->blobs->tm->data;
 		hdr_state->tm = tm;
 	} else {
 		hdr_state->tm = NULL;
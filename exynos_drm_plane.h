@@ -59,5 +59,7 @@ int exynos_plane_init(struct drm_device *dev,
 		      struct exynos_drm_plane *exynos_plane, unsigned int index,
 		      const struct exynos_drm_plane_config *config);
 int exynos_drm_debugfs_plane_add(struct exynos_drm_plane *exynos_plane);
+int exynos_drm_plane_init_caches(void);
+void exynos_drm_plane_destroy_caches(void);
 
 #endif /* __EXYNOS_DRM_PLANE_H__ */
@@ -19,6 +19,9 @@
 #include <linux/device.h>
 #include <linux/kthread.h>
 #include <linux/export.h>
+#include <linux/ktime.h>
+#include <linux/moduleparam.h>
+#include <drm/drm_atomic.h>
 #include <drm/drm_drv.h>
 #include <drm/drm_device.h>
 #include <drm/drm_modeset_lock.h>
@@ -26,26 +29,195 @@
 #include "exynos_drm_decon.h"
 #include "exynos_drm_recovery.h"
 
+static bool link_recovery = true;
+module_param(link_recovery, bool, 0600);
+MODULE_PARM_DESC(link_recovery, "try DSIM/panel only reset before full display recovery");
+
+#define RECOVERY_COMMIT_TIMEOUT_MS	100
+
+static const char * const recovery_tier_names[EXYNOS_RECOVERY_TIER_CNT] = {
+	[EXYNOS_RECOVERY_TIER_LINK] = "link",
+	[EXYNOS_RECOVERY_TIER_FULL] = "full",
+};
+
+const char *exynos_recovery_tier_name(enum exynos_recovery_tier tier)
+{
+	return tier < EXYNOS_RECOVERY_TIER_CNT ? recovery_tier_names[tier] : "unknown";
+}
+EXPORT_SYMBOL_GPL(exynos_recovery_tier_name);
+
+static void exynos_recovery_account(struct exynos_recovery *recovery,
+				    enum exynos_recovery_tier tier, ktime_t start,
+				    int ret)
+{
+	struct exynos_recovery_tier_stats *stats = &recovery->stats[tier];
+	const u32 delta_us = ktime_us_delta(ktime_get(), start);
+
+	stats->attempts++;
+	if (!ret)
+		stats->successes++;
+	stats->total_us += delta_us;
+	if (delta_us > stats->max_us)
+		stats->max_us = delta_us;
+
+	pr_info("%s recovery %s(%d) in %uus\n", recovery_tier_names[tier],
+		ret ? "failed" : "done", ret, delta_us);
+}
+
+/* wait until the last commit on crtc is out on the link before touching it */
+static int exynos_recovery_wait_for_commit(struct drm_crtc *crtc)
+{
+	struct drm_crtc_commit *commit;
+	long ret;
+
+	spin_lock(&crtc->commit_lock);
+	commit = list_first_entry_or_null(&crtc->commit_list,
+					  struct drm_crtc_commit, commit_entry);
+	if (commit)
+		drm_crtc_commit_get(commit);
+	spin_unlock(&crtc->commit_lock);
+
+	if (!commit)
+		return 0;
+
+	ret = wait_for_completion_timeout(&commit->flip_done,
+					  msecs_to_jiffies(RECOVERY_COMMIT_TIMEOUT_MS));
+	drm_crtc_commit_put(commit);
+
+	return ret ? 0 : -ETIMEDOUT;
+}
+
+static struct dsim_device *
+exynos_recovery_get_dsim(const struct drm_crtc_state *crtc_state)
+{
+	struct drm_encoder *encoder;
+
+	drm_for_each_encoder_mask(encoder, crtc_state->crtc->dev,
+				  crtc_state->encoder_mask) {
+		if (encoder->encoder_type == DRM_MODE_ENCODER_DSI)
+			return encoder_to_dsim(encoder);
+	}
+
+	return NULL;
+}
+
+/*
+ * Link tier: DECON and DPP keep their configuration, only DSIM is restarted
+ * and panel is reset and reinitialized. Only command mode is supported, where
+ * DECON does not send anything to DSIM until it gets triggered.
+ *
+ * Return: -EOPNOTSUPP if link tier does not apply to current configuration.
+ */
+static int exynos_recovery_reset_link(struct decon_device *decon,
+				      struct drm_modeset_acquire_ctx *ctx)
+{
+	struct drm_crtc *crtc = &decon->crtc->base;
+	struct drm_atomic_state *state;
+	struct drm_crtc_state *crtc_state;
+	struct dsim_device *dsim;
+	int ret;
+
+	if (decon->config.mode.op_mode != DECON_COMMAND_MODE ||
+	    !(decon->config.out_type & DECON_OUT_DSI))
+		return -EOPNOTSUPP;
+
+	state = drm_atomic_state_alloc(crtc->dev);
+	if (!state)
+		return -ENOMEM;
+	state->acquire_ctx = ctx;
+retry:
+	/* state is never committed, it only holds locks and current states */
+	crtc_state = drm_atomic_get_crtc_state(state, crtc);
+	if (IS_ERR(crtc_state)) {
+		ret = PTR_ERR(crtc_state);
+		goto out;
+	}
+
+	if (!crtc_state->active || crtc_state->self_refresh_active) {
+		ret = -EOPNOTSUPP;
+		goto out;
+	}
+
+	dsim = exynos_recovery_get_dsim(crtc_state);
+	if (!dsim) {
+		ret = -EOPNOTSUPP;
+		goto out;
+	}
+
+	ret = drm_atomic_add_affected_connectors(state, crtc);
+	if (ret)
+		goto out;
+
+	ret = drm_atomic_add_encoder_bridges(state, &dsim->encoder);
+	if (ret)
+		goto out;
+
+	ret = exynos_recovery_wait_for_commit(crtc);
+	if (ret)
+		goto out;
+
+	hibernation_block_exit(decon->hibernation);
+	ret = dsim_reset_link(dsim, state);
+	/* panel is blank until it gets a frame, which also confirms the link */
+	if (!ret)
+		ret = decon_send_recovery_frame(decon);
+	hibernation_unblock_enter(decon->hibernation);
+out:
+	if (ret == -EDEADLK) {
+		drm_atomic_state_clear(state);
+		ret = drm_modeset_backoff(ctx);
+		if (!ret)
+			goto retry;
+	}
+	drm_atomic_state_put(state);
+
+	return ret;
+}
+
+static int exynos_recovery_full(struct drm_crtc *crtc,
+				struct drm_modeset_acquire_ctx *ctx)
+{
+	struct drm_atomic_state *rcv_state;
+	int ret;
+
+	rcv_state = exynos_crtc_suspend(crtc, ctx);
+	if (IS_ERR_OR_NULL(rcv_state))
+		return -EINVAL;
+
+	ret = exynos_crtc_resume(rcv_state, ctx);
+	drm_atomic_state_put(rcv_state);
+
+	return ret;
+}
+
 static void exynos_recovery_handler(struct work_struct *work)
 {
 	struct exynos_recovery *recovery = container_of(work,
 					struct exynos_recovery, work);
 	struct decon_device *decon = container_of(recovery, struct decon_device,
 					recovery);
-	struct drm_atomic_state *rcv_state;
 	struct drm_modeset_acquire_ctx ctx;
 	struct drm_crtc *crtc = &decon->crtc->base;
-	int ret;
+	ktime_t start;
+	int ret = -EOPNOTSUPP;
 
 	pr_info("starting recovery...\n");
 
 	drm_modeset_acquire_init(&ctx, 0);
-	rcv_state = exynos_crtc_suspend(crtc, &ctx);
-	if (!IS_ERR_OR_NULL(rcv_state)) {
-		ret = exynos_crtc_resume(rcv_state, &ctx);
-		drm_atomic_state_put(rcv_state);
-	} else {
-		ret = -EINVAL;
+
+	if (link_recovery) {
+		start = ktime_get();
+		ret = exynos_recovery_reset_link(decon, &ctx);
+		if (ret != -EOPNOTSUPP)
+			exynos_recovery_account(recovery, EXYNOS_RECOVERY_TIER_LINK,
+						start, ret);
+	}
+
+	if (ret) {
+		start = ktime_get();
+		ret = exynos_recovery_full(crtc, &ctx);
+		exynos_recovery_account(recovery, EXYNOS_RECOVERY_TIER_FULL, start,
+					ret);
 	}
 
 	if (!ret) {
@@ -66,6 +238,7 @@ void exynos_recovery_register(struct decon_device *decon)
 	INIT_WORK(&recovery->work, exynos_recovery_handler);
 	recovery->count = 0;
 	atomic_set(&recovery->recovering, 0);
+	memset(recovery->stats, 0, sizeof(recovery->stats));
 
 	pr_info("ESD recovery is supported\n");
 }
@@ -15,15 +15,38 @@
 #ifndef __EXYNOS_DRM_RECOVERY__
 #define __EXYNOS_DRM_RECOVERY__
 
+#include <linux/atomic.h>
 #include <linux/kthread.h>
 
 struct decon_device;
+
+/*
+ * Recovery is tried in tiers of increasing cost. Link tier resets DSIM and
+ * panel only, keeping DECON/DPP configuration, and is confirmed by sending a
+ * frame of the current configuration. Full tier suspends and resumes the
+ * whole crtc, it is used when link tier does not apply or that frame fails.
+ */
+enum exynos_recovery_tier {
+	EXYNOS_RECOVERY_TIER_LINK,
+	EXYNOS_RECOVERY_TIER_FULL,
+	EXYNOS_RECOVERY_TIER_CNT,
+};
+
+struct exynos_recovery_tier_stats {
+	u32 attempts;
+	u32 successes;
+	u32 max_us;
+	u64 total_us;
+};
+
 struct exynos_recovery {
 	struct work_struct work;
 	int count;
 	atomic_t recovering;
+	struct exynos_recovery_tier_stats stats[EXYNOS_RECOVERY_TIER_CNT];
 };
 
 void exynos_recovery_register(struct decon_device *decon);
+const char *exynos_recovery_tier_name(enum exynos_recovery_tier tier);
 
 #endif /* __EXYNOS_DRM_RECOVERY__ */
@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: GPL-2.0-only
+ *
+ * linux/drivers/gpu/drm/samsung/exynos_drm_trace.h
+ *
+ * Copyright (c) 2023 Samsung Electronics Co., Ltd.
+ *		http://www.samsung.com
+ *
+ * Header file for Exynos DRM tracepoints.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation.
+ */
+
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM exynos_drm
+
+#if !defined(_EXYNOS_DRM_TRACE_H_) || defined(TRACE_HEADER_MULTI_READ)
+#define _EXYNOS_DRM_TRACE_H_
+
+#include <linux/ktime.h>
+#include <linux/tracepoint.h>
+
+#include "exynos_drm_drv.h"
+
+/* one event per completed frame, stage latencies relative to the previous stage */
+TRACE_EVENT(exynos_frame_timeline,
+	TP_PROTO(u32 decon_id, u64 seq, const ktime_t *ts),
+	TP_ARGS(decon_id, seq, ts),
+	TP_STRUCT__entry(
+		__field(u32, decon_id)
+		__field(u64, seq)
+		__field(s64, commit_ns)
+		__array(u32, stage_us, EXYNOS_FRAME_STAGE_CNT)
+	),
+	TP_fast_assign(
+		int i;
+
+		__entry->decon_id = decon_id;
+		__entry->seq = seq;
+		__entry->commit_ns = ktime_to_ns(ts[EXYNOS_FRAME_COMMIT]);
+		__entry->stage_us[0] = ktime_us_delta(ts[EXYNOS_FRAME_DONE],
+						      ts[EXYNOS_FRAME_COMMIT]);
+		for (i = 1; i < EXYNOS_FRAME_STAGE_CNT; i++)
+			__entry->stage_us[i] = ktime_us_delta(ts[i], ts[i - 1]);
+	),
+	TP_printk("decon%u seq=%llu commit=%lld total=%uus tail=%u fence=%u ept=%u trigger=%u start=%u done=%u",
+		  __entry->decon_id, __entry->seq, __entry->commit_ns,
+		  __entry->stage_us[0],
+		  __entry->stage_us[EXYNOS_FRAME_TAIL],
+		  __entry->stage_us[EXYNOS_FRAME_FENCE],
+		  __entry->stage_us[EXYNOS_FRAME_EPT],
+		  __entry->stage_us[EXYNOS_FRAME_TRIGGER],
+		  __entry->stage_us[EXYNOS_FRAME_START],
+		  __entry->stage_us[EXYNOS_FRAME_DONE])
+);
+
+#endif /* _EXYNOS_DRM_TRACE_H_ */
+
+#undef TRACE_INCLUDE_PATH
+#define TRACE_INCLUDE_PATH .
+#undef TRACE_INCLUDE_FILE
+#define TRACE_INCLUDE_FILE exynos_drm_trace
+
+#include <trace/define_trace.h>
@@ -20,6 +20,9 @@
 #include <linux/dma-buf.h>
 #include <linux/of_address.h>
 #include <linux/of_irq.h>
+#include <linux/debugfs.h>
+#include <linux/seq_file.h>
+#include <linux/bitops.h>
 
 #include <drm/exynos_drm.h>
 #include <drm/drm_atomic.h>
@@ -27,11 +30,15 @@
 #include <drm/drm_crtc_helper.h>
 #include <drm/drm_connector.h>
 #include <drm/drm_edid.h>
+#include <drm/drm_file.h>
+#include <drm/drm_framebuffer.h>
 #include <drm/drm_fourcc.h>
 #include <drm/drm_fourcc_gs101.h>
 #include <drm/drm_modeset_helper_vtables.h>
 #include <drm/drm_probe_helper.h>
 
+#include <trace/dpu_trace.h>
+
 #include <regs-dpp.h>
 
 #include "exynos_drm_crtc.h"
@@ -106,10 +113,10 @@ static int writeback_get_modes(struct drm_connector *connector)
 	return num_modes;
 }
 
-static void wb_convert_connector_state_to_config(struct dpp_params_info *config,
+static void wb_convert_fb_to_config(struct dpp_params_info *config,
+				const struct drm_framebuffer *fb,
 				const struct exynos_drm_writeback_state *state)
 {
-	struct drm_framebuffer *fb = state->base.writeback_job->fb;
 	const struct drm_crtc_state *crtc_state = state->base.crtc->state;
 	unsigned long long comp_blk_size;
 
@@ -195,25 +202,83 @@ static void wb_convert_connector_state_to_config(struct dpp_params_info *config,
 	pr_debug("%s -\n", __func__);
 }
 
+static void wb_convert_connector_state_to_config(struct dpp_params_info *config,
+				const struct exynos_drm_writeback_state *state)
+{
+	wb_convert_fb_to_config(config, state->base.writeback_job->fb, state);
+}
+
+static bool wb_is_supported_format(const struct drm_framebuffer *fb)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(writeback_formats); i++)
+		if (fb->format->format == writeback_formats[i])
+			return true;
+
+	return false;
+}
+
+static bool wb_stream_fb_fits(const struct drm_framebuffer *fb,
+			      const struct drm_display_mode *mode)
+{
+	return fb->width >= mode->hdisplay && fb->height >= mode->vdisplay;
+}
+
+/*
+ * Stream buffers are written by ODMA with the crtc's active size and a line
+ * stride derived from the fb width, so only linear fbs which are at least as
+ * large as the mode and whose pitch matches that stride are accepted.
+ */
+static int wb_stream_check_fb(const struct drm_framebuffer *fb,
+			      const struct drm_display_mode *mode)
+{
+	int i;
+
+	if (!wb_is_supported_format(fb)) {
+		pr_err("unsupported writeback format(%#x)\n", fb->format->format);
+		return -EINVAL;
+	}
+
+	if (fb->modifier != DRM_FORMAT_MOD_LINEAR) {
+		pr_err("unsupported writeback stream modifier(%#llx)\n", fb->modifier);
+		return -EINVAL;
+	}
+
+	if (!wb_stream_fb_fits(fb, mode)) {
+		pr_err("writeback fb(%ux%u) is smaller than mode(%ux%u)\n", fb->width,
+		       fb->height, mode->hdisplay, mode->vdisplay);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < fb->format->num_planes; i++) {
+		if (fb->pitches[i] != drm_format_info_min_pitch(fb->format, i, fb->width)) {
+			pr_err("writeback fb plane%d pitch(%u) is not supported\n", i,
+			       fb->pitches[i]);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
 static int writeback_atomic_check(struct drm_encoder *encoder,
 				struct drm_crtc_state *crtc_state,
 				struct drm_connector_state *conn_state)
 {
-	const struct drm_framebuffer *fb;
-	int i;
+	const struct writeback_device *wb = enc_to_wb_dev(encoder);
 
 	conn_state->self_refresh_aware = true;
 
 	if (!wb_check_job(conn_state))
 		return 0;
 
-	fb = conn_state->writeback_job->fb;
-
-	for (i = 0; i < ARRAY_SIZE(writeback_formats); i++)
-		if (fb->format->format == writeback_formats[i])
-			break;
+	if (writeback_stream_is_active(wb)) {
+		pr_debug("writeback(dpp%d) job rejected while streaming\n", wb->id);
+		return -EBUSY;
+	}
 
-	if (i == ARRAY_SIZE(writeback_formats))
+	if (!wb_is_supported_format(conn_state->writeback_job->fb))
 		return -EINVAL;
 
 	return 0;
@@ -243,6 +308,443 @@ static void writeback_atomic_commit(struct drm_connector *connector,
 	pr_debug("%s -\n", __func__);
 }
 
+bool writeback_stream_is_active(const struct writeback_device *wb)
+{
+	return READ_ONCE(wb->stream.num_bufs) != 0;
+}
+
+/* returns a buffer which was handed to ODMA but never completed to the pool */
+static void writeback_stream_abort_locked(struct writeback_device *wb)
+{
+	struct writeback_stream *stream = &wb->stream;
+
+	if (stream->active < 0)
+		return;
+
+	set_bit(stream->active, &stream->free_mask);
+	stream->active = -1;
+	stream->stats.dropped++;
+	stream->pending_drops++;
+	wake_up_all(&stream->wait);
+}
+
+/*
+ * Stops ODMA writing into the in-flight stream buffer by resetting it, then
+ * brings it back up for the following writeback jobs. Called with odma_slock
+ * held when the frame done irq didn't come in time.
+ */
+static int writeback_stream_stop_odma_locked(struct writeback_device *wb)
+{
+	int ret;
+
+	if (wb->stream.active < 0)
+		return 0;
+
+	/* ODMA isn't running anymore once writeback was disabled */
+	if (wb->state != WB_STATE_ON) {
+		writeback_stream_abort_locked(wb);
+		return 0;
+	}
+
+	ret = dpp_reg_deinit(wb->id, true, wb->attr);
+	if (ret)
+		return ret;
+
+	dpp_reg_init(wb->id, wb->attr);
+	writeback_stream_abort_locked(wb);
+
+	return 0;
+}
+
+/*
+ * writeback_stream_queue_frame - program the next free stream buffer
+ *
+ * Called from decon atomic flush while concurrent writeback is requested for
+ * the frame. Returns true if ODMA is expected to write this frame.
+ */
+bool writeback_stream_queue_frame(struct writeback_device *wb)
+{
+	struct writeback_stream *stream = &wb->stream;
+	const struct drm_connector_state *conn_state = wb->writeback.base.state;
+	struct dpp_params_info *config = &wb->win_config;
+	unsigned long flags;
+	bool job_pending;
+	int idx;
+
+	spin_lock_irqsave(&wb->writeback.job_lock, flags);
+	job_pending = !list_empty(&wb->writeback.job_queue);
+	spin_unlock_irqrestore(&wb->writeback.job_lock, flags);
+
+	/* a regular writeback job is already programmed for this frame */
+	if (job_pending)
+		return true;
+
+	spin_lock_irqsave(&wb->odma_slock, flags);
+	if (!stream->num_bufs || wb->state != WB_STATE_ON ||
+	    !conn_state || !conn_state->crtc) {
+		spin_unlock_irqrestore(&wb->odma_slock, flags);
+		return false;
+	}
+
+	if (stream->decimation > 1 && (stream->frame_cnt++ % stream->decimation)) {
+		stream->stats.decimated++;
+		spin_unlock_irqrestore(&wb->odma_slock, flags);
+		return false;
+	}
+
+	idx = find_first_bit(&stream->free_mask, stream->num_bufs);
+	/* the mode may have grown past the buffers since the stream started */
+	if (stream->active >= 0 || idx >= stream->num_bufs ||
+	    !wb_stream_fb_fits(stream->fbs[idx], &conn_state->crtc->state->mode)) {
+		stream->stats.dropped++;
+		stream->pending_drops++;
+		spin_unlock_irqrestore(&wb->odma_slock, flags);
+		DPU_ATRACE_INT("wb_stream_drop", stream->stats.dropped);
+		return false;
+	}
+
+	clear_bit(idx, &stream->free_mask);
+	stream->active = idx;
+
+	wb_convert_fb_to_config(config, stream->fbs[idx], to_exynos_wb_state(conn_state));
+	dpp_reg_configure_params(wb->id, config, wb->attr);
+	spin_unlock_irqrestore(&wb->odma_slock, flags);
+
+	DPU_EVENT_LOG(DPU_EVT_WB_ATOMIC_COMMIT, wb->decon_id, wb);
+	pr_debug("writeback(dpp%d) stream buf%d queued\n", wb->id, idx);
+
+	return true;
+}
+
+/* called with odma_slock held from ODMA framedone irq */
+static void writeback_stream_complete_locked(struct writeback_device *wb)
+{
+	struct writeback_stream *stream = &wb->stream;
+	struct exynos_drm_pending_wb_stream_event *e;
+	const int idx = stream->active;
+
+	e = stream->events[idx];
+	stream->events[idx] = NULL;
+	stream->active = -1;
+
+	e->event.timestamp_ns = ktime_get_ns();
+	e->event.index = idx;
+	e->event.sequence = stream->sequence++;
+	e->event.dropped = stream->pending_drops;
+	stream->pending_drops = 0;
+	stream->stats.captured++;
+
+	drm_send_event(wb->writeback.base.dev, &e->base);
+	wake_up_all(&stream->wait);
+}
+
+static struct exynos_drm_pending_wb_stream_event *
+writeback_stream_create_event(struct drm_device *dev, struct drm_file *file, u32 connector_id)
+{
+	struct exynos_drm_pending_wb_stream_event *e;
+	int ret;
+
+	e = kzalloc(sizeof(*e), GFP_KERNEL);
+	if (!e)
+		return ERR_PTR(-ENOMEM);
+
+	e->event.base.type = EXYNOS_DRM_WB_STREAM_EVENT;
+	e->event.base.length = sizeof(e->event);
+	e->event.connector_id = connector_id;
+
+	ret = drm_event_reserve_init(dev, file, &e->base, &e->event.base);
+	if (ret) {
+		pr_err("drm_event_reserve_init failed, ret(%d)\n", ret);
+		kfree(e);
+		return ERR_PTR(ret);
+	}
+
+	return e;
+}
+
+static struct writeback_device *
+writeback_stream_lookup(struct drm_device *dev, struct drm_file *file, u32 connector_id)
+{
+	struct drm_connector *connector;
+	struct writeback_device *wb = NULL;
+
+	connector = drm_connector_lookup(dev, file, connector_id);
+	if (!connector) {
+		pr_err("failed to find connector(%u)\n", connector_id);
+		return NULL;
+	}
+
+	if (connector->connector_type == DRM_MODE_CONNECTOR_WRITEBACK)
+		wb = conn_to_wb_dev(connector);
+	else
+		pr_err("connector(%u) is not writeback\n", connector_id);
+
+	drm_connector_put(connector);
+
+	return wb;
+}
+
+/* stops the stream, only allowed for the file which started it */
+static int writeback_stream_teardown(struct writeback_device *wb, const struct drm_file *file)
+{
+	struct writeback_stream *stream = &wb->stream;
+	struct drm_device *dev = wb->writeback.base.dev;
+	struct drm_framebuffer *fbs[EXYNOS_WB_STREAM_MAX_BUFS] = { NULL };
+	struct exynos_drm_pending_wb_stream_event *events[EXYNOS_WB_STREAM_MAX_BUFS] = { NULL };
+	unsigned long flags;
+	u32 num_bufs;
+	int i, active, ret = 0;
+
+	/* no new frame can be queued once num_bufs is cleared */
+	spin_lock_irqsave(&wb->odma_slock, flags);
+	if (stream->file != file) {
+		spin_unlock_irqrestore(&wb->odma_slock, flags);
+		return -EPERM;
+	}
+	num_bufs = stream->num_bufs;
+	stream->num_bufs = 0;
+	spin_unlock_irqrestore(&wb->odma_slock, flags);
+
+	/* already being stopped by someone else */
+	if (!num_bufs)
+		return 0;
+
+	/* ODMA may still be writing into the in-flight buffer */
+	if (!wait_event_timeout(stream->wait, READ_ONCE(stream->active) < 0,
+				msecs_to_jiffies(100))) {
+		pr_err("writeback(dpp%d) stream stop timeout\n", wb->id);
+		ret = -ETIMEDOUT;
+	}
+
+	spin_lock_irqsave(&wb->odma_slock, flags);
+	active = stream->active;
+	if (ret && !writeback_stream_stop_odma_locked(wb))
+		active = -1;
+	for (i = 0; i < num_bufs; i++) {
+		fbs[i] = stream->fbs[i];
+		events[i] = stream->events[i];
+		stream->fbs[i] = NULL;
+		stream->events[i] = NULL;
+	}
+	stream->free_mask = 0;
+	stream->active = -1;
+	stream->file = NULL;
+	spin_unlock_irqrestore(&wb->odma_slock, flags);
+
+	/* ODMA couldn't be stopped, never free the memory it may write into */
+	if (active >= 0) {
+		pr_err("writeback(dpp%d) failed to stop ODMA, buf%d is kept\n", wb->id, active);
+		fbs[active] = NULL;
+	}
+
+	for (i = 0; i < num_bufs; i++) {
+		if (events[i])
+			drm_event_cancel_free(dev, &events[i]->base);
+		if (fbs[i])
+			drm_framebuffer_put(fbs[i]);
+	}
+
+	pr_info("writeback(dpp%d) stream stopped: captured(%u) dropped(%u) decimated(%u)\n",
+		wb->id, stream->stats.captured, stream->stats.dropped, stream->stats.decimated);
+
+	return ret;
+}
+
+int wb_stream_start_ioctl(struct drm_device *dev, void *data, struct drm_file *file)
+{
+	struct exynos_drm_wb_stream_start *req = data;
+	struct writeback_device *wb;
+	struct writeback_stream *stream;
+	struct drm_framebuffer *fbs[EXYNOS_WB_STREAM_MAX_BUFS] = { NULL };
+	struct exynos_drm_pending_wb_stream_event *events[EXYNOS_WB_STREAM_MAX_BUFS] = { NULL };
+	struct drm_modeset_acquire_ctx ctx;
+	const struct drm_crtc *crtc;
+	unsigned long flags;
+	int i, ret = 0;
+
+	if (!req->num_bufs || req->num_bufs > EXYNOS_WB_STREAM_MAX_BUFS) {
+		pr_err("invalid writeback stream buffer count(%u)\n", req->num_bufs);
+		return -EINVAL;
+	}
+
+	wb = writeback_stream_lookup(dev, file, req->connector_id);
+	if (!wb)
+		return -ENOENT;
+	stream = &wb->stream;
+
+	for (i = 0; i < req->num_bufs; i++) {
+		fbs[i] = drm_framebuffer_lookup(dev, file, req->fb_ids[i]);
+		if (!fbs[i]) {
+			pr_err("failed to find fb(%u)\n", req->fb_ids[i]);
+			ret = -ENOENT;
+			goto err;
+		}
+
+		events[i] = writeback_stream_create_event(dev, file, req->connector_id);
+		if (IS_ERR(events[i])) {
+			ret = PTR_ERR(events[i]);
+			events[i] = NULL;
+			goto err;
+		}
+	}
+
+	/* hold the mode steady until the stream is published */
+	DRM_MODESET_LOCK_ALL_BEGIN(dev, ctx, 0, ret);
+
+	crtc = wb->writeback.base.state->crtc;
+	if (!crtc || !crtc->state->active) {
+		pr_err("writeback(dpp%d) is not attached to an active crtc\n", wb->id);
+		ret = -EINVAL;
+		goto unlock;
+	}
+
+	for (i = 0; i < req->num_bufs; i++) {
+		ret = wb_stream_check_fb(fbs[i], &crtc->state->mode);
+		if (ret)
+			goto unlock;
+	}
+
+	spin_lock_irqsave(&wb->odma_slock, flags);
+	if (stream->file) {
+		spin_unlock_irqrestore(&wb->odma_slock, flags);
+		pr_warn("writeback(dpp%d) stream already started\n", wb->id);
+		ret = -EBUSY;
+		goto unlock;
+	}
+
+	for (i = 0; i < req->num_bufs; i++) {
+		stream->fbs[i] = fbs[i];
+		stream->events[i] = events[i];
+	}
+	stream->file = file;
+	stream->decimation = req->decimation;
+	stream->frame_cnt = 0;
+	stream->sequence = 0;
+	stream->pending_drops = 0;
+	stream->active = -1;
+	stream->free_mask = GENMASK(req->num_bufs - 1, 0);
+	memset(&stream->stats, 0, sizeof(stream->stats));
+	/* publish last, writeback_stream_is_active() is checked without lock */
+	WRITE_ONCE(stream->num_bufs, req->num_bufs);
+	spin_unlock_irqrestore(&wb->odma_slock, flags);
+
+unlock:
+	DRM_MODESET_LOCK_ALL_END(dev, ctx, ret);
+	if (ret)
+		goto err;
+
+	pr_info("writeback(dpp%d) stream started: bufs(%u) decimation(%u)\n",
+		wb->id, req->num_bufs, req->decimation);
+
+	return 0;
+
+err:
+	for (i = 0; i < req->num_bufs; i++) {
+		if (events[i])
+			drm_event_cancel_free(dev, &events[i]->base);
+		if (fbs[i])
+			drm_framebuffer_put(fbs[i]);
+	}
+
+	return ret;
+}
+
+int wb_stream_stop_ioctl(struct drm_device *dev, void *data, struct drm_file *file)
+{
+	struct exynos_drm_wb_stream_stop *req = data;
+	struct writeback_device *wb;
+
+	wb = writeback_stream_lookup(dev, file, req->connector_id);
+	if (!wb)
+		return -ENOENT;
+
+	return writeback_stream_teardown(wb, file);
+}
+
+int wb_stream_queue_ioctl(struct drm_device *dev, void *data, struct drm_file *file)
+{
+	struct exynos_drm_wb_stream_buf *req = data;
+	struct writeback_device *wb;
+	struct writeback_stream *stream;
+	struct exynos_drm_pending_wb_stream_event *e;
+	unsigned long flags;
+	int ret = 0;
+
+	wb = writeback_stream_lookup(dev, file, req->connector_id);
+	if (!wb)
+		return -ENOENT;
+	stream = &wb->stream;
+
+	e = writeback_stream_create_event(dev, file, req->connector_id);
+	if (IS_ERR(e))
+		return PTR_ERR(e);
+
+	spin_lock_irqsave(&wb->odma_slock, flags);
+	if (stream->file != file) {
+		ret = -EPERM;
+	} else if (req->index >= stream->num_bufs) {
+		ret = -EINVAL;
+	} else if (stream->events[req->index]) {
+		/* buffer is still owned by the driver */
+		ret = -EBUSY;
+	} else {
+		stream->events[req->index] = e;
+		set_bit(req->index, &stream->free_mask);
+		stream->stats.requeued++;
+	}
+	spin_unlock_irqrestore(&wb->odma_slock, flags);
+
+	if (ret)
+		drm_event_cancel_free(dev, &e->base);
+
+	return ret;
+}
+
+void exynos_drm_wb_stream_release(struct drm_device *dev, struct drm_file *file)
+{
+	struct drm_connector *connector;
+	struct drm_connector_list_iter conn_iter;
+	struct writeback_device *wb;
+
+	drm_connector_list_iter_begin(dev, &conn_iter);
+	drm_for_each_connector_iter(connector, &conn_iter) {
+		if (connector->connector_type != DRM_MODE_CONNECTOR_WRITEBACK)
+			continue;
+
+		wb = conn_to_wb_dev(connector);
+		if (READ_ONCE(wb->stream.file) == file)
+			writeback_stream_teardown(wb, file);
+	}
+	drm_connector_list_iter_end(&conn_iter);
+}
+
+static int wb_stream_stats_show(struct seq_file *s, void *unused)
+{
+	struct writeback_device *wb = s->private;
+	const struct writeback_stream *stream = &wb->stream;
+
+	seq_printf(s, "active: %s\n", writeback_stream_is_active(wb) ? "yes" : "no");
+	seq_printf(s, "bufs: %u free_mask: 0x%lx decimation: %u\n", stream->num_bufs,
+		   stream->free_mask, stream->decimation);
+	seq_printf(s, "captured: %u\n", stream->stats.captured);
+	seq_printf(s, "dropped: %u\n", stream->stats.dropped);
+	seq_printf(s, "decimated: %u\n", stream->stats.decimated);
+	seq_printf(s, "requeued: %u\n", stream->stats.requeued);
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(wb_stream_stats);
+
+static int exynos_drm_writeback_late_register(struct drm_connector *connector)
+{
+	struct writeback_device *wb = conn_to_wb_dev(connector);
+
+	debugfs_create_file("stream_stats", 0444, connector->debugfs_entry, wb,
+			    &wb_stream_stats_fops);
+
+	return 0;
+}
+
 static const struct drm_connector_helper_funcs wb_connector_helper_funcs = {
 	.get_modes = writeback_get_modes,
 	.atomic_commit = writeback_atomic_commit,
@@ -363,10 +865,13 @@ static const struct drm_connector_funcs wb_connector_funcs = {
 	.atomic_destroy_state = exynos_drm_writeback_destroy_state,
 	.atomic_set_property = exynos_drm_writeback_set_property,
 	.atomic_get_property = exynos_drm_writeback_get_property,
+	.late_register = exynos_drm_writeback_late_register,
 };
 
 static void _writeback_enable(struct writeback_device *wb)
 {
+	/* dpp_reg_init() turns the gating off */
+	exynos_idle_gate_exit(&wb->idle_gate);
 	dpp_reg_init(wb->id, wb->attr);
 	enable_irq(wb->odma_irq);
 }
@@ -411,11 +916,14 @@ static void _writeback_disable(struct writeback_device *wb)
 {
 	disable_irq(wb->odma_irq);
 	dpp_reg_deinit(wb->id, false, wb->attr);
+	if (exynos_idle_gate_enter(&wb->idle_gate))
+		dpp_reg_set_clock_gating(wb->id, wb->attr, true);
 }
 
 static void writeback_disable(struct drm_encoder *encoder)
 {
 	struct writeback_device *wb = enc_to_wb_dev(encoder);
+	unsigned long flags;
 
 	pr_debug("%s +\n", __func__);
 
@@ -426,7 +934,10 @@ static void writeback_disable(struct drm_encoder *encoder)
 	}
 
 	_writeback_disable(wb);
+	spin_lock_irqsave(&wb->odma_slock, flags);
+	writeback_stream_abort_locked(wb);
 	wb->state = WB_STATE_OFF;
+	spin_unlock_irqrestore(&wb->odma_slock, flags);
 	DPU_EVENT_LOG(DPU_EVT_WB_DISABLE, wb->decon_id, wb);
 
 	wb->decon_id = -1;
@@ -436,11 +947,16 @@ static void writeback_disable(struct drm_encoder *encoder)
 
 void writeback_enter_hibernation(struct writeback_device *wb)
 {
+	unsigned long flags;
+
 	if (wb->state != WB_STATE_ON)
 		return;
 
 	_writeback_disable(wb);
+	spin_lock_irqsave(&wb->odma_slock, flags);
+	writeback_stream_abort_locked(wb);
 	wb->state = WB_STATE_HIBERNATION;
+	spin_unlock_irqrestore(&wb->odma_slock, flags);
 	DPU_EVENT_LOG(DPU_EVT_WB_ENTER_HIBERNATION, wb->decon_id, wb);
 }
 
@@ -663,7 +1179,12 @@ static irqreturn_t odma_irq_handler(int irq, void *priv)
 		else
 			pr_warn("wb(%d) instant off irq occurs\n", wb->id);
 
-		drm_writeback_signal_completion(&wb->writeback, 0);
+		if (wb->stream.active < 0)
+			drm_writeback_signal_completion(&wb->writeback, 0);
+		else if (irqs & ODMA_STATUS_FRAMEDONE_IRQ)
+			writeback_stream_complete_locked(wb);
+		else
+			writeback_stream_abort_locked(wb);
 		DPU_EVENT_LOG(DPU_EVT_WB_FRAMEDONE, wb->decon_id, wb);
 	}
 
@@ -750,6 +1271,8 @@ static int writeback_probe(struct platform_device *pdev)
 	writeback->output_type = EXYNOS_DISPLAY_TYPE_VIDI;
 
 	spin_lock_init(&writeback->odma_slock);
+	init_waitqueue_head(&writeback->stream.wait);
+	writeback->stream.active = -1;
 
 	writeback->state = WB_STATE_OFF;
 
@@ -14,7 +14,9 @@
 #ifndef _EXYNOS_DRM_WRTIEBACK_H_
 #define _EXYNOS_DRM_WRTIEBACK_H_
 
+#include <drm/drm_file.h>
 #include <drm/drm_writeback.h>
+#include <drm/samsung_drm.h>
 
 #include <decon_cal.h>
 #include <dpp_cal.h>
@@ -31,12 +33,48 @@ enum writeback_state {
 	WB_STATE_HIBERNATION,
 };
 
+struct exynos_drm_pending_wb_stream_event {
+	struct drm_pending_event base;
+	struct exynos_drm_wb_stream_event event;
+};
+
+struct writeback_stream_stats {
+	u32 captured;
+	u32 dropped;
+	u32 decimated;
+	u32 requeued;
+};
+
+/*
+ * Writeback streaming mode: a pool of preregistered buffers is cycled by the
+ * ODMA on every committed frame without a per-frame writeback job. A buffer
+ * is either owned by the driver (bit set in @free_mask, with a reserved
+ * completion event) or by user space after its event has been sent.
+ * Protected by odma_slock.
+ */
+struct writeback_stream {
+	struct drm_file *file;
+	struct drm_framebuffer *fbs[EXYNOS_WB_STREAM_MAX_BUFS];
+	struct exynos_drm_pending_wb_stream_event *events[EXYNOS_WB_STREAM_MAX_BUFS];
+	u32 num_bufs;
+	u32 decimation;
+	u32 frame_cnt;
+	u32 sequence;
+	u32 pending_drops;
+	unsigned long free_mask;
+	/* index of the buffer being written by ODMA, -1 if none */
+	int active;
+	wait_queue_head_t wait;
+	struct writeback_stream_stats stats;
+};
+
 struct writeback_device {
 	struct device *dev;
 	u32 id;
 	u32 port;
 	enum writeback_state state;
 	unsigned long attr;
+	struct exynos_idle_gate idle_gate;
 	int odma_irq;
 	const uint32_t *pixel_formats;
 	unsigned int num_pixel_formats;
@@ -48,6 +86,7 @@ struct writeback_device {
 	struct dpp_params_info win_config;
 	struct dpp_restriction restriction;
 	struct drm_writeback_connector writeback;
+	struct writeback_stream stream;
 
 	enum exynos_drm_output_type output_type;
 
@@ -100,4 +139,11 @@ void wb_dump(struct drm_printer *p, struct writeback_device *wb);
 
 void writeback_exit_hibernation(struct writeback_device *wb);
 void writeback_enter_hibernation(struct writeback_device *wb);
+
+bool writeback_stream_is_active(const struct writeback_device *wb);
+bool writeback_stream_queue_frame(struct writeback_device *wb);
+void exynos_drm_wb_stream_release(struct drm_device *dev, struct drm_file *file);
+int wb_stream_start_ioctl(struct drm_device *dev, void *data, struct drm_file *file);
+int wb_stream_stop_ioctl(struct drm_device *dev, void *data, struct drm_file *file);
+int wb_stream_queue_ioctl(struct drm_device *dev, void *data, struct drm_file *file);
 #endif
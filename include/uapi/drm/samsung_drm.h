@@ -385,6 +385,7 @@ struct histogram_channel_config {
 #define EXYNOS_DRM_HISTOGRAM_EVENT		0x80000000
 #define EXYNOS_DRM_HISTOGRAM_CHANNEL_EVENT	0x80000001
 #define EXYNOS_DRM_CONTEXT_HISTOGRAM_EVENT	0x80000002
+#define EXYNOS_DRM_WB_STREAM_EVENT		0x80000003
 
 /**
  * struct exynos_drm_histogram_event - histogram event to wait for user-space
@@ -441,6 +442,31 @@ struct exynos_drm_context_histogram_event {
 	__u32 user_handle;
 };
 
+/**
+ * struct exynos_drm_wb_stream_event - writeback stream buffer completion event
+ *
+ * @base: event header which informs user space event type and length.
+ * @timestamp_ns: CLOCK_MONOTONIC time at which ODMA finished the frame
+ * @connector_id: writeback connector id of the stream
+ * @index: index of the completed buffer in the registered pool
+ * @sequence: sequence number of the captured frame, starting from 0
+ * @dropped: number of frames dropped since the previous event because no
+ *           buffer was available
+ *
+ * User space waits for POLLIN event using like poll() or select(). If event
+ * type is EXYNOS_DRM_WB_STREAM_EVENT, the buffer at @index holds the captured
+ * frame and is owned by user space until it is handed back to the driver
+ * through DRM_IOCTL_EXYNOS_WB_STREAM_QUEUE.
+ */
+struct exynos_drm_wb_stream_event {
+	struct drm_event base;
+	__u64 timestamp_ns;
+	__u32 connector_id;
+	__u32 index;
+	__u32 sequence;
+	__u32 dropped;
+};
+
 #define EXYNOS_HISTOGRAM_REQUEST		0x0
 #define EXYNOS_HISTOGRAM_CANCEL			0x1
 #define EXYNOS_HISTOGRAM_CHANNEL_REQUEST	0x20
@@ -448,6 +474,11 @@ struct exynos_drm_context_histogram_event {
 #define EXYNOS_HISTOGRAM_CHANNEL_DATA_REQUEST	0x30 /* histogram data is returned via ioctl */
 #define EXYNOS_CONTEXT_HISTOGRAM_EVENT_REQUEST	0x40
 #define EXYNOS_CONTEXT_HISTOGRAM_EVENT_CANCEL	0x41
+#define EXYNOS_WB_STREAM_START			0x50
+#define EXYNOS_WB_STREAM_STOP			0x51
+#define EXYNOS_WB_STREAM_QUEUE			0x52
+
+#define EXYNOS_WB_STREAM_MAX_BUFS		8
 
 /**
  * struct exynos_drm_histogram_channel_request - histogram channel query control structure
@@ -500,6 +531,59 @@ struct exynos_drm_context_histogram_arg {
 	__u32 flags;
 };
 
+/**
+ * struct exynos_drm_wb_stream_start - writeback stream setup
+ *
+ * @connector_id: writeback connector id, must be attached to an active crtc
+ * @num_bufs: number of valid entries in @fb_ids
+ * @fb_ids: framebuffers cycled by the ODMA, all owned by the driver at start
+ * @decimation: capture one out of every @decimation frames, 0 is same as 1
+ *
+ * User space sends an IOCTL
+ *   EXYNOS_WB_STREAM_START
+ * with struct exynos_drm_wb_stream_start data type. While the stream is
+ * running, every committed frame of the crtc is written into the next free
+ * buffer without a writeback job, and completion is reported through
+ * EXYNOS_DRM_WB_STREAM_EVENT. The buffers must be linear, use a supported
+ * format, be at least as large as the active mode of the crtc and have the
+ * minimum pitch for their width. Only the DRM master can start a stream.
+ */
+struct exynos_drm_wb_stream_start {
+	__u32 connector_id;
+	__u32 num_bufs;
+	__u32 fb_ids[EXYNOS_WB_STREAM_MAX_BUFS];
+	__u32 decimation;
+};
+
+/**
+ * struct exynos_drm_wb_stream_stop - writeback stream teardown
+ *
+ * @connector_id: writeback connector id of the stream
+ *
+ * User space sends an IOCTL
+ *   EXYNOS_WB_STREAM_STOP
+ * with struct exynos_drm_wb_stream_stop data type. Only the file which
+ * started the stream can stop it.
+ */
+struct exynos_drm_wb_stream_stop {
+	__u32 connector_id;
+};
+
+/**
+ * struct exynos_drm_wb_stream_buf - hand a consumed buffer back to the stream
+ *
+ * @connector_id: writeback connector id of the stream
+ * @index: index of the buffer reported by EXYNOS_DRM_WB_STREAM_EVENT
+ *
+ * User space sends an IOCTL
+ *   EXYNOS_WB_STREAM_QUEUE
+ * with struct exynos_drm_wb_stream_buf data type.
+ */
+struct exynos_drm_wb_stream_buf {
+	__u32 connector_id;
+	__u32 index;
+};
+
 #define DRM_IOCTL_EXYNOS_HISTOGRAM_REQUEST \
 	DRM_IOW(DRM_COMMAND_BASE + EXYNOS_HISTOGRAM_REQUEST, __u32)
 #define DRM_IOCTL_EXYNOS_HISTOGRAM_CANCEL \
@@ -519,6 +603,15 @@ struct exynos_drm_context_histogram_arg {
 #define DRM_IOCTL_EXYNOS_CONTEXT_HISTOGRAM_EVENT_CANCEL  \
 	DRM_IOW(DRM_COMMAND_BASE + EXYNOS_CONTEXT_HISTOGRAM_EVENT_CANCEL, \
 		struct exynos_drm_context_histogram_arg)
+#define DRM_IOCTL_EXYNOS_WB_STREAM_START \
+	DRM_IOW(DRM_COMMAND_BASE + EXYNOS_WB_STREAM_START, \
+		struct exynos_drm_wb_stream_start)
+#define DRM_IOCTL_EXYNOS_WB_STREAM_STOP \
+	DRM_IOW(DRM_COMMAND_BASE + EXYNOS_WB_STREAM_STOP, \
+		struct exynos_drm_wb_stream_stop)
+#define DRM_IOCTL_EXYNOS_WB_STREAM_QUEUE \
+	DRM_IOW(DRM_COMMAND_BASE + EXYNOS_WB_STREAM_QUEUE, \
+		struct exynos_drm_wb_stream_buf)
 
 #if defined(__cplusplus)
 }